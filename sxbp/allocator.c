@@ -0,0 +1,161 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ *
+ * Copyright (C) 2016, 2017, Joshua Saxby joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+// only include these extra dependencies if thread support was enabled
+#ifdef LIBSXBP_THREAD_SUPPORT
+#include <stdbool.h>
+
+#include <pthread.h>
+#endif
+
+#include "saxbospiral.h"
+#include "allocator.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// disable GCC warning about the unused context parameters of the defaults
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+// private functions, the default allocator which uses the standard library
+static void* default_allocate(size_t size, void* context) {
+    return malloc(size);
+}
+
+static void* default_reallocate(void* pointer, size_t size, void* context) {
+    return realloc(pointer, size);
+}
+
+static void default_deallocate(void* pointer, void* context) {
+    free(pointer);
+}
+// re-enable all warnings
+#pragma GCC diagnostic pop
+
+// private variable, the allocator set for all threads
+static sxbp_allocator_t global_allocator = {
+    default_allocate, default_reallocate, default_deallocate, NULL,
+};
+
+/*
+ * each thread only gets an allocator of its own if thread support is enabled,
+ * otherwise there's just the one, which is used by all threads
+ */
+#ifdef LIBSXBP_THREAD_SUPPORT
+// private variables, the key of the allocator set for each thread
+static pthread_key_t thread_allocator_key;
+static pthread_once_t thread_allocator_once = PTHREAD_ONCE_INIT;
+static bool thread_allocator_key_made = false;
+
+// private function, makes the key of the allocator set for each thread
+static void make_thread_allocator_key(void) {
+    thread_allocator_key_made = (
+        pthread_key_create(&thread_allocator_key, NULL) == 0
+    );
+}
+#else
+// private variable, the allocator set in place of the global one, if any
+static const sxbp_allocator_t* thread_allocator = NULL;
+#endif
+
+const sxbp_allocator_t* sxbp_get_thread_allocator(void) {
+    #ifdef LIBSXBP_THREAD_SUPPORT
+    pthread_once(&thread_allocator_once, make_thread_allocator_key);
+    if(thread_allocator_key_made) {
+        return pthread_getspecific(thread_allocator_key);
+    }
+    return NULL;
+    #else
+    return thread_allocator;
+    #endif
+}
+
+// private function, returns the allocator in use on the calling thread
+static const sxbp_allocator_t* get_allocator(void) {
+    const sxbp_allocator_t* allocator = sxbp_get_thread_allocator();
+    return (allocator != NULL) ? allocator : &global_allocator;
+}
+
+void sxbp_set_allocator(const sxbp_allocator_t* allocator) {
+    if(allocator == NULL) {
+        global_allocator = (sxbp_allocator_t){
+            default_allocate, default_reallocate, default_deallocate, NULL,
+        };
+    } else {
+        // preconditional assertions
+        assert(allocator->allocate != NULL);
+        assert(allocator->reallocate != NULL);
+        global_allocator = *allocator;
+    }
+}
+
+const sxbp_allocator_t* sxbp_set_thread_allocator(
+    const sxbp_allocator_t* allocator
+) {
+    // preconditional assertions
+    assert((allocator == NULL) || (allocator->allocate != NULL));
+    assert((allocator == NULL) || (allocator->reallocate != NULL));
+    const sxbp_allocator_t* previous = sxbp_get_thread_allocator();
+    #ifdef LIBSXBP_THREAD_SUPPORT
+    if(thread_allocator_key_made) {
+        pthread_setspecific(thread_allocator_key, (const void*)allocator);
+    }
+    #else
+    thread_allocator = allocator;
+    #endif
+    return previous;
+}
+
+void* sxbp_malloc(size_t size) {
+    const sxbp_allocator_t* allocator = get_allocator();
+    return allocator->allocate(size, allocator->context);
+}
+
+void* sxbp_calloc(size_t count, size_t size) {
+    const sxbp_allocator_t* allocator = get_allocator();
+    // the standard library can often give back memory that's already zeroed
+    if(allocator->allocate == default_allocate) {
+        return calloc(count, size);
+    }
+    if((size != 0) && (count > SIZE_MAX / size)) {
+        return NULL;
+    }
+    void* pointer = allocator->allocate(count * size, allocator->context);
+    if(pointer != NULL) {
+        memset(pointer, 0, count * size);
+    }
+    return pointer;
+}
+
+void* sxbp_realloc(void* pointer, size_t size) {
+    const sxbp_allocator_t* allocator = get_allocator();
+    if(pointer == NULL) {
+        return allocator->allocate(size, allocator->context);
+    }
+    return allocator->reallocate(pointer, size, allocator->context);
+}
+
+void sxbp_free(void* pointer) {
+    const sxbp_allocator_t* allocator = get_allocator();
+    if((pointer != NULL) && (allocator->deallocate != NULL)) {
+        allocator->deallocate(pointer, allocator->context);
+    }
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
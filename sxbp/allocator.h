@@ -0,0 +1,164 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ */
+
+/**
+ * @file
+ *
+ * @brief This compilation unit provides a way of choosing how the library
+ * allocates memory, so that custom allocators (such as arenas or pools) can be
+ * used instead of the standard library's.
+ *
+ * @details All of the memory the library allocates, whether for its own use or
+ * to hand back to the caller (such as the lines of a spiral or the bytes of a
+ * buffer), goes through the allocator in use at the time. Memory which has
+ * been handed back to the caller should be freed with sxbp_free() (or by the
+ * allocator that allocated it). With the default allocator this is the same as
+ * calling free().
+ *
+ * @author Joshua Saxby <joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ * @date 2016, 2017
+ *
+ * @copyright Copyright (C) Joshua Saxby 2016, 2017
+ *
+ * @copyright
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef SAXBOPHONE_SAXBOSPIRAL_ALLOCATOR_H
+#define SAXBOPHONE_SAXBOSPIRAL_ALLOCATOR_H
+
+#include <stddef.h>
+
+#include "saxbospiral.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief A set of functions for allocating memory, used instead of malloc(),
+ * realloc() and free().
+ * @details Each function is passed the allocator's context, which can point to
+ * whatever state the allocator needs (such as the arena to allocate from).
+ */
+typedef struct sxbp_allocator_t {
+    /**
+     * @brief Allocates size bytes of memory, as malloc() does.
+     * @details Should return NULL if the memory can't be allocated.
+     */
+    void*(* allocate)(size_t size, void* context);
+    /**
+     * @brief Resizes a block of memory to size bytes, as realloc() does.
+     * @details Should return NULL and leave the block alone if it can't be
+     * resized. The block is never NULL, the library calls allocate instead.
+     */
+    void*(* reallocate)(void* pointer, size_t size, void* context);
+    /**
+     * @brief Frees a block of memory, as free() does.
+     * @details The block is never NULL. This may be left as NULL for allocators
+     * which free all of their memory in one go (such as arenas), in which case
+     * freeing individual blocks does nothing.
+     */
+    void(* deallocate)(void* pointer, void* context);
+    /** @brief Passed to every call of the functions above */
+    void* context;
+} sxbp_allocator_t;
+
+/**
+ * @brief Sets the allocator used by the library on all threads.
+ * @details This is used on any thread which hasn't had an allocator of its own
+ * set with sxbp_set_thread_allocator(). It should be set before the library is
+ * used, and not changed while other threads may be using the library. If the
+ * library is used on several threads at once, including by the functions which
+ * spread their work across threads, the allocator must be safe to call from
+ * all of them at once.
+ *
+ * @param allocator The allocator to use, which is copied. NULL means go back to
+ * using the standard library's malloc(), realloc() and free().
+ *
+ * @note Asserts:
+ * - That allocator->allocate and allocator->reallocate are not NULL, if
+ * allocator is not NULL
+ */
+void sxbp_set_allocator(const sxbp_allocator_t* allocator);
+
+/**
+ * @brief Sets the allocator used by the library on the calling thread only.
+ * @details This overrides the allocator set with sxbp_set_allocator() for
+ * everything done on this thread, which makes it possible to give each job of
+ * a batch an allocator of its own (such as an arena that is thrown away once
+ * the job is done). The functions which spread their work across threads use
+ * the calling thread's allocator on all of the threads they start.
+ *
+ * If thread support is not enabled (see SXBP_THREAD_SUPPORT), this applies to
+ * all threads.
+ *
+ * @param allocator The allocator to use, which must stay valid until it is
+ * replaced. NULL means go back to the allocator set with sxbp_set_allocator().
+ * @return The allocator that was set for the calling thread before, or NULL if
+ * there wasn't one, so that it can be put back afterwards.
+ *
+ * @note Asserts:
+ * - That allocator->allocate and allocator->reallocate are not NULL, if
+ * allocator is not NULL
+ */
+const sxbp_allocator_t* sxbp_set_thread_allocator(
+    const sxbp_allocator_t* allocator
+);
+
+/**
+ * @brief Gets the allocator set for the calling thread only.
+ *
+ * @return The allocator set with sxbp_set_thread_allocator() for the calling
+ * thread, or NULL if there isn't one.
+ */
+const sxbp_allocator_t* sxbp_get_thread_allocator(void);
+
+/**
+ * @brief Allocates memory with the allocator in use on the calling thread.
+ *
+ * @param size The number of bytes to allocate.
+ * @return The allocated memory, or NULL if it couldn't be allocated.
+ */
+void* sxbp_malloc(size_t size);
+
+/**
+ * @brief Allocates memory for an array with the allocator in use on the calling
+ * thread, with every byte set to 0.
+ *
+ * @param count The number of items in the array.
+ * @param size The size of each item of the array in bytes.
+ * @return The allocated memory, or NULL if it couldn't be allocated (including
+ * if the size of the array is too large to represent).
+ */
+void* sxbp_calloc(size_t count, size_t size);
+
+/**
+ * @brief Resizes memory with the allocator in use on the calling thread.
+ *
+ * @param pointer The memory to resize, which may be NULL to allocate new
+ * memory.
+ * @param size The number of bytes to resize it to.
+ * @return The resized memory, or NULL if it couldn't be resized (in which case
+ * the memory is left as it was).
+ */
+void* sxbp_realloc(void* pointer, size_t size);
+
+/**
+ * @brief Frees memory with the allocator in use on the calling thread.
+ *
+ * @param pointer The memory to free, which may be NULL, in which case nothing
+ * is done.
+ */
+void sxbp_free(void* pointer);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+// end of header file
+#endif
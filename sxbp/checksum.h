@@ -0,0 +1,73 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ */
+
+/**
+ * @file
+ *
+ * @brief This compilation unit provides checksum functions used to detect
+ * corruption of serialised data.
+ *
+ * @author Joshua Saxby <joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ * @date 2016, 2017
+ *
+ * @copyright Copyright (C) Joshua Saxby 2016, 2017
+ *
+ * @copyright
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef SAXBOPHONE_SAXBOSPIRAL_CHECKSUM_H
+#define SAXBOPHONE_SAXBOSPIRAL_CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "saxbospiral.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Calculates or updates a CRC-32 checksum of a sequence of bytes.
+ * @details This is the same CRC-32 as used by zlib, PNG and many other formats
+ * (polynomial 0xedb88320, reflected). The checksum of data which is split into
+ * several pieces can be calculated by passing the result of each call in as
+ * the crc argument of the next one.
+ *
+ * @param crc The checksum of all preceding data, or 0 if there isn't any.
+ * @param data The bytes to calculate the checksum of.
+ * @param size The number of bytes pointed to by data.
+ * @return The updated checksum.
+ *
+ * @note Asserts:
+ * - That data is not NULL if size is not 0
+ */
+uint32_t sxbp_crc32(uint32_t crc, const uint8_t* data, size_t size);
+
+/**
+ * @brief Calculates or updates an Adler-32 checksum of a sequence of bytes.
+ * @details This is the checksum used at the end of zlib streams. As with
+ * sxbp_crc32(), data split into several pieces can be checksummed by passing
+ * the result of each call in as the adler argument of the next one.
+ *
+ * @param adler The checksum of all preceding data, or 1 if there isn't any.
+ * @param data The bytes to calculate the checksum of.
+ * @param size The number of bytes pointed to by data.
+ * @return The updated checksum.
+ *
+ * @note Asserts:
+ * - That data is not NULL if size is not 0
+ */
+uint32_t sxbp_adler32(uint32_t adler, const uint8_t* data, size_t size);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+// end of header file
+#endif
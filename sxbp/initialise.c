@@ -9,17 +9,129 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "saxbospiral.h"
+#include "allocator.h"
 #include "initialise.h"
+#include "parallel.h"
 
 
 #ifdef __cplusplus
 extern "C"{
 #endif
 
+/*
+ * private lookup table giving the directions of the 8 lines made from each
+ * byte, when the line before them is UP. These are packed into the 2-bit lanes
+ * of a 16-bit word, first line in the highest lane. Starting from any other
+ * direction just turns each of them by the same amount, and the direction of
+ * the last line (the lowest lane) is the one the next byte starts from.
+ */
+static const uint16_t BYTE_DIRECTIONS[256] = {
+    0x6c6c, 0x6c6e, 0x6c66, 0x6c64, 0x6c46, 0x6c44, 0x6c4c, 0x6c4e,
+    0x6cc6, 0x6cc4, 0x6ccc, 0x6cce, 0x6cec, 0x6cee, 0x6ce6, 0x6ce4,
+    0x6ec6, 0x6ec4, 0x6ecc, 0x6ece, 0x6eec, 0x6eee, 0x6ee6, 0x6ee4,
+    0x6e6c, 0x6e6e, 0x6e66, 0x6e64, 0x6e46, 0x6e44, 0x6e4c, 0x6e4e,
+    0x66c6, 0x66c4, 0x66cc, 0x66ce, 0x66ec, 0x66ee, 0x66e6, 0x66e4,
+    0x666c, 0x666e, 0x6666, 0x6664, 0x6646, 0x6644, 0x664c, 0x664e,
+    0x646c, 0x646e, 0x6466, 0x6464, 0x6446, 0x6444, 0x644c, 0x644e,
+    0x64c6, 0x64c4, 0x64cc, 0x64ce, 0x64ec, 0x64ee, 0x64e6, 0x64e4,
+    0x46c6, 0x46c4, 0x46cc, 0x46ce, 0x46ec, 0x46ee, 0x46e6, 0x46e4,
+    0x466c, 0x466e, 0x4666, 0x4664, 0x4646, 0x4644, 0x464c, 0x464e,
+    0x446c, 0x446e, 0x4466, 0x4464, 0x4446, 0x4444, 0x444c, 0x444e,
+    0x44c6, 0x44c4, 0x44cc, 0x44ce, 0x44ec, 0x44ee, 0x44e6, 0x44e4,
+    0x4c6c, 0x4c6e, 0x4c66, 0x4c64, 0x4c46, 0x4c44, 0x4c4c, 0x4c4e,
+    0x4cc6, 0x4cc4, 0x4ccc, 0x4cce, 0x4cec, 0x4cee, 0x4ce6, 0x4ce4,
+    0x4ec6, 0x4ec4, 0x4ecc, 0x4ece, 0x4eec, 0x4eee, 0x4ee6, 0x4ee4,
+    0x4e6c, 0x4e6e, 0x4e66, 0x4e64, 0x4e46, 0x4e44, 0x4e4c, 0x4e4e,
+    0xc6c6, 0xc6c4, 0xc6cc, 0xc6ce, 0xc6ec, 0xc6ee, 0xc6e6, 0xc6e4,
+    0xc66c, 0xc66e, 0xc666, 0xc664, 0xc646, 0xc644, 0xc64c, 0xc64e,
+    0xc46c, 0xc46e, 0xc466, 0xc464, 0xc446, 0xc444, 0xc44c, 0xc44e,
+    0xc4c6, 0xc4c4, 0xc4cc, 0xc4ce, 0xc4ec, 0xc4ee, 0xc4e6, 0xc4e4,
+    0xcc6c, 0xcc6e, 0xcc66, 0xcc64, 0xcc46, 0xcc44, 0xcc4c, 0xcc4e,
+    0xccc6, 0xccc4, 0xcccc, 0xccce, 0xccec, 0xccee, 0xcce6, 0xcce4,
+    0xcec6, 0xcec4, 0xcecc, 0xcece, 0xceec, 0xceee, 0xcee6, 0xcee4,
+    0xce6c, 0xce6e, 0xce66, 0xce64, 0xce46, 0xce44, 0xce4c, 0xce4e,
+    0xec6c, 0xec6e, 0xec66, 0xec64, 0xec46, 0xec44, 0xec4c, 0xec4e,
+    0xecc6, 0xecc4, 0xeccc, 0xecce, 0xecec, 0xecee, 0xece6, 0xece4,
+    0xeec6, 0xeec4, 0xeecc, 0xeece, 0xeeec, 0xeeee, 0xeee6, 0xeee4,
+    0xee6c, 0xee6e, 0xee66, 0xee64, 0xee46, 0xee44, 0xee4c, 0xee4e,
+    0xe6c6, 0xe6c4, 0xe6cc, 0xe6ce, 0xe6ec, 0xe6ee, 0xe6e6, 0xe6e4,
+    0xe66c, 0xe66e, 0xe666, 0xe664, 0xe646, 0xe644, 0xe64c, 0xe64e,
+    0xe46c, 0xe46e, 0xe466, 0xe464, 0xe446, 0xe444, 0xe44c, 0xe44e,
+    0xe4c6, 0xe4c4, 0xe4cc, 0xe4ce, 0xe4ec, 0xe4ee, 0xe4e6, 0xe4e4,
+};
+
+/*
+ * the smallest number of bytes worth giving a thread of its own when building
+ * a spiral's lines in parallel
+ */
+#define MIN_INIT_CHUNK_SIZE (1024U * 1024U)
+
+/*
+ * the number of bytes read from a stream at a time when building a spiral from
+ * it, which is also how many bytes' worth of lines are first allocated when
+ * the length of the stream isn't known
+ */
+#define INIT_STREAM_BUFFER_SIZE 4096
+
+/*
+ * private lookup table which gathers the high bits of each of the four 2-bit
+ * lanes of a byte into a nibble (with the highest lane in the highest bit)
+ */
+static const uint8_t HIGH_LANE_BITS[256] = {
+    0x0, 0x0, 0x1, 0x1, 0x0, 0x0, 0x1, 0x1, 0x2, 0x2, 0x3, 0x3, 0x2, 0x2, 0x3, 0x3,
+    0x0, 0x0, 0x1, 0x1, 0x0, 0x0, 0x1, 0x1, 0x2, 0x2, 0x3, 0x3, 0x2, 0x2, 0x3, 0x3,
+    0x4, 0x4, 0x5, 0x5, 0x4, 0x4, 0x5, 0x5, 0x6, 0x6, 0x7, 0x7, 0x6, 0x6, 0x7, 0x7,
+    0x4, 0x4, 0x5, 0x5, 0x4, 0x4, 0x5, 0x5, 0x6, 0x6, 0x7, 0x7, 0x6, 0x6, 0x7, 0x7,
+    0x0, 0x0, 0x1, 0x1, 0x0, 0x0, 0x1, 0x1, 0x2, 0x2, 0x3, 0x3, 0x2, 0x2, 0x3, 0x3,
+    0x0, 0x0, 0x1, 0x1, 0x0, 0x0, 0x1, 0x1, 0x2, 0x2, 0x3, 0x3, 0x2, 0x2, 0x3, 0x3,
+    0x4, 0x4, 0x5, 0x5, 0x4, 0x4, 0x5, 0x5, 0x6, 0x6, 0x7, 0x7, 0x6, 0x6, 0x7, 0x7,
+    0x4, 0x4, 0x5, 0x5, 0x4, 0x4, 0x5, 0x5, 0x6, 0x6, 0x7, 0x7, 0x6, 0x6, 0x7, 0x7,
+    0x8, 0x8, 0x9, 0x9, 0x8, 0x8, 0x9, 0x9, 0xa, 0xa, 0xb, 0xb, 0xa, 0xa, 0xb, 0xb,
+    0x8, 0x8, 0x9, 0x9, 0x8, 0x8, 0x9, 0x9, 0xa, 0xa, 0xb, 0xb, 0xa, 0xa, 0xb, 0xb,
+    0xc, 0xc, 0xd, 0xd, 0xc, 0xc, 0xd, 0xd, 0xe, 0xe, 0xf, 0xf, 0xe, 0xe, 0xf, 0xf,
+    0xc, 0xc, 0xd, 0xd, 0xc, 0xc, 0xd, 0xd, 0xe, 0xe, 0xf, 0xf, 0xe, 0xe, 0xf, 0xf,
+    0x8, 0x8, 0x9, 0x9, 0x8, 0x8, 0x9, 0x9, 0xa, 0xa, 0xb, 0xb, 0xa, 0xa, 0xb, 0xb,
+    0x8, 0x8, 0x9, 0x9, 0x8, 0x8, 0x9, 0x9, 0xa, 0xa, 0xb, 0xb, 0xa, 0xa, 0xb, 0xb,
+    0xc, 0xc, 0xd, 0xd, 0xc, 0xc, 0xd, 0xd, 0xe, 0xe, 0xf, 0xf, 0xe, 0xe, 0xf, 0xf,
+    0xc, 0xc, 0xd, 0xd, 0xc, 0xc, 0xd, 0xd, 0xe, 0xe, 0xf, 0xf, 0xe, 0xe, 0xf, 0xf,
+};
+
+/*
+ * private function, given 8 directions packed into 2-bit lanes of a 16-bit
+ * word (first direction in the highest lane) and the direction before the first
+ * of them, returns the byte that they were built from. If any of them are not
+ * a quarter-turn from the direction before them, then valid is set to false.
+ *
+ * This works on all 8 lanes at once by subtracting each lane from the one above
+ * it modulo 4 without carries between lanes, so that each lane holds the turn
+ * made: 1 for clockwise (bit 0) or 3 for anti-clockwise (bit 1). The bits are
+ * then the high bits of each lane, and the low bits must all be set.
+ */
+static uint8_t decode_directions(
+    uint32_t directions, sxbp_direction_t previous, bool* valid
+) {
+    // the direction before each lane's direction, in that lane
+    uint32_t before = ((uint32_t)previous << 14) | (directions >> 2);
+    const uint32_t high = 0xaaaa;
+    uint32_t turns = (
+        ((directions | high) - (before & ~high)) ^
+        ((directions ^ ~before) & high)
+    ) & 0xffff;
+    if((turns & 0x5555) != 0x5555) {
+        *valid = false;
+    }
+    return (uint8_t)(
+        (HIGH_LANE_BITS[turns >> 8] << 4) | HIGH_LANE_BITS[turns & 0xff]
+    );
+}
+
 sxbp_direction_t sxbp_change_direction(
     sxbp_direction_t current, sxbp_rotation_t turn
 ) {
@@ -27,53 +139,451 @@ sxbp_direction_t sxbp_change_direction(
 }
 
 sxbp_spiral_t sxbp_blank_spiral(void) {
-    return (sxbp_spiral_t){0, NULL, {{NULL, 0}, 0}, false, 0, 0, 0, 0, 0, 0, };
+    return (sxbp_spiral_t){
+        0, NULL, {{NULL, 0}, 0, {{0, 0}, {0, 0}}, 0}, false, 0, 0, 0, 0, 0, 0,
+    };
+}
+
+/*
+ * private function, writes the lines made from the given bytes to lines, where
+ * the line before the first of them faces the given direction. Each byte's
+ * lines are looked up from BYTE_DIRECTIONS and turned to face the right way.
+ * Returns the direction of the last line written.
+ */
+static sxbp_direction_t write_byte_lines(
+    const uint8_t* bytes, size_t size, sxbp_direction_t current,
+    sxbp_line_t* lines
+) {
+    for(size_t s = 0; s < size; s++) {
+        uint16_t directions = BYTE_DIRECTIONS[bytes[s]];
+        for(uint8_t b = 0; b < 8; b++) {
+            lines[b] = (sxbp_line_t){
+                .direction = (current + (directions >> (14 - 2 * b))) % 4U,
+                .length = 0,
+            };
+        }
+        current = lines[7].direction;
+        lines += 8;
+    }
+    return current;
+}
+
+/*
+ * private type holding the state of a spiral's lines being built from data on
+ * several threads at once, one chunk of the data per job
+ */
+typedef struct parallel_init_t {
+    sxbp_buffer_t buffer;
+    size_t chunk_size;
+    // the direction the line before each chunk faces
+    sxbp_direction_t* starts;
+    sxbp_line_t* lines;
+} parallel_init_t;
+
+// private function, returns the first byte and size of a chunk of the data
+static size_t get_init_chunk(
+    const parallel_init_t* init, size_t chunk_index, size_t* size
+) {
+    size_t first = chunk_index * init->chunk_size;
+    *size = init->buffer.size - first;
+    *size = (*size < init->chunk_size) ? *size : init->chunk_size;
+    return first;
+}
+
+/*
+ * private function, job for sxbp_run_parallel_jobs() which finds the turn made
+ * by one chunk of the data, storing it in the chunk's start for now. Every
+ * byte makes 8 quarter-turns, which is 2 whole turns less half a turn for each
+ * 1 bit, so the chunk turns half way round if it has an odd number of 1 bits
+ * and not at all otherwise. This is just the parity of the chunk, which is
+ * much quicker to find than the chunk's lines.
+ */
+static sxbp_status_t find_chunk_turn(size_t chunk_index, void* user_data) {
+    parallel_init_t* init = (parallel_init_t*)user_data;
+    size_t size = 0;
+    size_t first = get_init_chunk(init, chunk_index, &size);
+    uint8_t parity = 0;
+    for(size_t s = 0; s < size; s++) {
+        parity ^= init->buffer.bytes[first + s];
+    }
+    parity ^= parity >> 4;
+    parity ^= parity >> 2;
+    parity ^= parity >> 1;
+    init->starts[chunk_index] = (parity & 1) ? SXBP_DOWN : SXBP_UP;
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, job for sxbp_run_parallel_jobs() which writes the lines of
+ * one chunk of the data, once the direction it starts from is known
+ */
+static sxbp_status_t init_chunk(size_t chunk_index, void* user_data) {
+    parallel_init_t* init = (parallel_init_t*)user_data;
+    size_t size = 0;
+    size_t first = get_init_chunk(init, chunk_index, &size);
+    write_byte_lines(
+        init->buffer.bytes + first, size, init->starts[chunk_index],
+        init->lines + (first * 8) + 1
+    );
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, builds the lines of a spiral (after the first UP line)
+ * from the data in chunks on up to thread_count threads. This is a parallel
+ * prefix scan: the turn made by each chunk is found alongside the others, then
+ * these are summed to give the direction each chunk starts from, and finally
+ * the chunks' lines are all written alongside each other.
+ */
+static sxbp_status_t init_lines_in_parallel(
+    sxbp_buffer_t buffer, size_t chunk_count, size_t thread_count,
+    sxbp_line_t* lines
+) {
+    parallel_init_t init = {
+        buffer, (buffer.size + chunk_count - 1) / chunk_count,
+        sxbp_malloc(sizeof(sxbp_direction_t) * chunk_count), lines,
+    };
+    if(init.starts == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    // the jobs can't fail, but the threads to run them on can
+    sxbp_status_t result = sxbp_run_parallel_jobs(
+        chunk_count, thread_count, find_chunk_turn, (void*)&init
+    );
+    if(result == SXBP_OPERATION_OK) {
+        sxbp_direction_t current = SXBP_UP;
+        for(size_t i = 0; i < chunk_count; i++) {
+            sxbp_direction_t turn = init.starts[i];
+            init.starts[i] = current;
+            current = (current + turn) % 4U;
+        }
+        result = sxbp_run_parallel_jobs(
+            chunk_count, thread_count, init_chunk, (void*)&init
+        );
+    }
+    sxbp_free(init.starts);
+    return result;
+}
+
+/*
+ * private function, returns whether a spiral of the given number of lines can
+ * be given the lines for the given number of bytes more of data, without its
+ * count of lines overflowing (or the memory for them being too big to ask for)
+ */
+static bool line_count_fits(size_t line_count, size_t byte_count) {
+    size_t max_count = SIZE_MAX / sizeof(sxbp_line_t);
+    if(max_count > SXBP_LINE_COUNT_MAX) {
+        max_count = SXBP_LINE_COUNT_MAX;
+    }
+    return (line_count <= max_count) && (
+        byte_count <= (max_count - line_count) / 8
+    );
 }
 
 sxbp_status_t sxbp_init_spiral(sxbp_buffer_t buffer, sxbp_spiral_t* spiral) {
+    return sxbp_init_spiral_in_parallel(buffer, 1, spiral);
+}
+
+sxbp_status_t sxbp_init_spiral_in_parallel(
+    sxbp_buffer_t buffer, size_t thread_count, sxbp_spiral_t* spiral
+) {
     // preconditional assertions
     assert(spiral->lines == NULL);
     assert(spiral->co_ord_cache.co_ords.items == NULL);
     // result status object
     sxbp_status_t result;
     // number of lines is number of bits of the data, + 1 for the first UP line
+    if(!line_count_fits(1, buffer.size)) {
+        return SXBP_SIZE_OVERFLOW;
+    }
     size_t line_count = (buffer.size * 8) + 1;
-    // TODO: Check here for overflow condition
     // populate spiral struct
-    spiral->size = line_count;
+    spiral->size = (sxbp_line_count_t)line_count;
     spiral->collides = -1;
     // allocate enough memory for a line_t struct for each bit
-    spiral->lines = calloc(sizeof(sxbp_line_t), line_count);
+    spiral->lines = sxbp_malloc(sizeof(sxbp_line_t) * line_count);
     // check for memory allocation failure
     if(spiral->lines == NULL) {
         result = SXBP_MALLOC_REFUSED;
         return result;
     }
     // First line is always an UP line - this is for orientation purposes
+    spiral->lines[0] = (sxbp_line_t){ .direction = SXBP_UP, .length = 0, };
+    /*
+     * now convert the data to directions that make the spiral pattern a byte
+     * at a time, in chunks on separate threads if there's enough of it
+     */
+    size_t chunk_count = buffer.size / MIN_INIT_CHUNK_SIZE;
+    chunk_count = (chunk_count < thread_count) ? chunk_count : thread_count;
+    if(chunk_count < 2) {
+        write_byte_lines(
+            buffer.bytes, buffer.size, SXBP_UP, spiral->lines + 1
+        );
+    } else {
+        result = init_lines_in_parallel(
+            buffer, chunk_count, thread_count, spiral->lines
+        );
+        if(result != SXBP_OPERATION_OK) {
+            sxbp_free(spiral->lines);
+            spiral->lines = NULL;
+            return result;
+        }
+    }
+    // all ok
+    result = SXBP_OPERATION_OK;
+    return result;
+}
+
+/*
+ * private function, resizes the lines of a spiral so that there's room for the
+ * given number of lines, leaving them as they were on memory allocation failure
+ */
+static sxbp_status_t resize_lines(
+    sxbp_spiral_t* spiral, size_t line_count
+) {
+    sxbp_line_t* lines = sxbp_realloc(
+        spiral->lines, sizeof(sxbp_line_t) * line_count
+    );
+    if(lines == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    spiral->lines = lines;
+    return SXBP_OPERATION_OK;
+}
+
+sxbp_status_t sxbp_init_spiral_from_stream(
+    size_t(* read_callback)(uint8_t* data, size_t size, void* user_data),
+    void* user_data, size_t size_hint, sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(read_callback != NULL);
+    assert(spiral->lines == NULL);
+    assert(spiral->co_ord_cache.co_ords.items == NULL);
+    // make room for as much data as we've been told to expect, if it fits
+    if(!line_count_fits(1, size_hint)) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    size_t capacity = (
+        size_hint > 0
+    ) ? (size_hint * 8) + 1 : (INIT_STREAM_BUFFER_SIZE * 8) + 1;
+    sxbp_status_t result = resize_lines(spiral, capacity);
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // First line is always an UP line - this is for orientation purposes
+    spiral->lines[0] = (sxbp_line_t){ .direction = SXBP_UP, .length = 0, };
+    size_t line_count = 1;
     sxbp_direction_t current = SXBP_UP;
-    spiral->lines[0].direction = current;
-    spiral->lines[0].length = 0;
+    // read the data a small chunk at a time, building each chunk's lines
+    uint8_t bytes[INIT_STREAM_BUFFER_SIZE];
+    size_t count = 0;
+    while(
+        (count = read_callback(bytes, INIT_STREAM_BUFFER_SIZE, user_data)) > 0
+    ) {
+        // a truncated spiral is no use, so an error means no spiral at all
+        if(count == SXBP_READ_ERROR) {
+            sxbp_free(spiral->lines);
+            spiral->lines = NULL;
+            return SXBP_OPERATION_FAIL;
+        }
+        // if the stream is longer than expected, double the room for lines
+        if(capacity - line_count < count * 8) {
+            if(!line_count_fits(line_count, count)) {
+                sxbp_free(spiral->lines);
+                spiral->lines = NULL;
+                return SXBP_SIZE_OVERFLOW;
+            }
+            size_t needed = line_count + (count * 8);
+            capacity = (
+                line_count_fits(0, capacity / 4) && (capacity * 2 > needed)
+            ) ? capacity * 2 : needed;
+            result = resize_lines(spiral, capacity);
+            if(result != SXBP_OPERATION_OK) {
+                sxbp_free(spiral->lines);
+                spiral->lines = NULL;
+                return result;
+            }
+        }
+        current = write_byte_lines(
+            bytes, count, current, spiral->lines + line_count
+        );
+        line_count += count * 8;
+    }
+    // give back any room that wasn't needed
+    if(line_count < capacity) {
+        resize_lines(spiral, line_count);
+    }
+    spiral->size = (sxbp_line_count_t)line_count;
+    spiral->collides = -1;
+    // all ok
+    result = SXBP_OPERATION_OK;
+    return result;
+}
+
+sxbp_status_t sxbp_spiral_append(sxbp_spiral_t* spiral, sxbp_buffer_t buffer) {
+    // preconditional assertions
+    assert(spiral->lines != NULL);
+    assert(spiral->size > 0);
+    if(!line_count_fits(spiral->size, buffer.size)) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    size_t line_count = spiral->size + (buffer.size * 8);
+    sxbp_status_t result = resize_lines(spiral, line_count);
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // carry on turning from wherever the last line of the spiral faces
+    write_byte_lines(
+        buffer.bytes, buffer.size, spiral->lines[spiral->size - 1].direction,
+        spiral->lines + spiral->size
+    );
+    spiral->size = (sxbp_line_count_t)line_count;
+    // all ok
+    result = SXBP_OPERATION_OK;
+    return result;
+}
+
+sxbp_status_t sxbp_spiral_edit(
+    sxbp_spiral_t* spiral, size_t offset, sxbp_buffer_t buffer
+) {
+    // preconditional assertions
+    assert(spiral->lines != NULL);
+    assert(spiral->size > 0);
+    assert(offset + buffer.size <= (spiral->size - 1) / 8);
+    // an empty edit changes nothing (and would otherwise allocate 0 bytes)
+    if(buffer.size == 0) {
+        return SXBP_OPERATION_OK;
+    }
+    // lines of the first byte start after the first UP line
+    sxbp_line_t* lines = spiral->lines + (offset * 8) + 1;
+    size_t line_count = buffer.size * 8;
+    sxbp_line_t* edited = sxbp_malloc(sizeof(sxbp_line_t) * line_count);
+    if(edited == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    write_byte_lines(buffer.bytes, buffer.size, lines[-1].direction, edited);
+    // find the first line which has actually changed, if any
+    size_t first = 0;
+    while(
+        (first < line_count) &&
+        (edited[first].direction == lines[first].direction)
+    ) {
+        first++;
+    }
+    if(first == line_count) {
+        sxbp_free(edited);
+        return SXBP_OPERATION_OK;
+    }
+    /*
+     * the lines after the edit only change if the new bytes end up facing
+     * another way than the old ones did - this can only be the opposite way,
+     * as every byte makes two whole turns less half a turn for each 1 bit
+     */
+    bool flipped = (
+        edited[line_count - 1].direction != lines[line_count - 1].direction
+    );
+    for(size_t i = first; i < line_count; i++) {
+        lines[i] = edited[i];
+    }
+    sxbp_free(edited);
+    size_t changed = (offset * 8) + 1 + first;
+    // whether the spiral collides isn't known until it's been solved again
+    spiral->collides = -1;
+    if(flipped) {
+        for(size_t i = (offset + buffer.size) * 8 + 1; i < spiral->size; i++) {
+            spiral->lines[i].direction = (
+                spiral->lines[i].direction + 2U
+            ) % 4U;
+        }
+    }
+    // everything from the first changed line onwards needs solving again
+    for(size_t i = changed; i < spiral->solved_count; i++) {
+        spiral->lines[i].length = 0;
+    }
+    spiral->solved_count = (
+        changed < spiral->solved_count
+    ) ? changed : spiral->solved_count;
+    sxbp_co_ord_cache_t* cache = &spiral->co_ord_cache;
+    cache->validity = (changed < cache->validity) ? changed : cache->validity;
+    if(cache->bounds_validity > changed) {
+        cache->bounds_validity = 0;
+    }
+    // all ok
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private read callback which reads from the file given as user_data. fread()
+ * reads nothing at both the end of the file and on an error, so the file's
+ * error indicator is checked to tell these apart.
+ */
+static size_t read_from_file(uint8_t* data, size_t size, void* user_data) {
+    FILE* file = (FILE*)user_data;
+    size_t count = fread(data, 1, size, file);
+    return ferror(file) ? SXBP_READ_ERROR : count;
+}
+
+sxbp_status_t sxbp_init_spiral_from_file(FILE* file, sxbp_spiral_t* spiral) {
+    // preconditional assertions
+    assert(file != NULL);
     /*
-     * now, iterate over all the bits in the data and convert to directions that
-     * make the spiral pattern, storing these directions in the result lines
+     * if the file can be seeked, use the length of the rest of it to size the
+     * spiral's lines. Pipes and the like can't, so these are left to grow.
      */
-    for(size_t s = 0; s < buffer.size; s++) {
-        // byte-level loop
+    size_t size_hint = 0;
+    long start = ftell(file);
+    if((start >= 0) && (fseek(file, 0, SEEK_END) == 0)) {
+        long end = ftell(file);
+        if(end > start) {
+            size_hint = (size_t)(end - start);
+        }
+        if(fseek(file, start, SEEK_SET) != 0) {
+            return SXBP_OPERATION_FAIL;
+        }
+    }
+    return sxbp_init_spiral_from_stream(
+        read_from_file, (void*)file, size_hint, spiral
+    );
+}
+
+sxbp_status_t sxbp_decode_spiral(sxbp_spiral_t spiral, sxbp_buffer_t* buffer) {
+    // preconditional assertions
+    assert(spiral.lines != NULL);
+    assert(buffer->bytes == NULL);
+    // result status object
+    sxbp_status_t result = SXBP_OPERATION_FAIL;
+    // there must be one whole byte's worth of lines after the first UP line
+    if(
+        (spiral.size < 9) || ((spiral.size - 1) % 8 != 0) ||
+        (spiral.lines[0].direction != SXBP_UP)
+    ) {
+        return result;
+    }
+    buffer->size = (spiral.size - 1) / 8;
+    buffer->bytes = sxbp_calloc(1, buffer->size);
+    // check for memory allocation failure
+    if(buffer->bytes == NULL) {
+        result = SXBP_MALLOC_REFUSED;
+        return result;
+    }
+    bool valid = true;
+    sxbp_direction_t previous = SXBP_UP;
+    for(size_t s = 0; s < buffer->size; s++) {
+        // pack the directions of this byte's lines into one word
+        const sxbp_line_t* lines = spiral.lines + (s * 8) + 1;
+        uint32_t directions = 0;
         for(uint8_t b = 0; b < 8; b++) {
-            // bit level loop
-            uint8_t e = 7 - b; // which power of two to use with bit mask
-            uint8_t bit = (buffer.bytes[s] & (1 << e)) >> e; // the current bit
-            size_t index = (s * 8) + (size_t)b + 1; // line index
-            sxbp_rotation_t rotation; // the rotation we're going to make
-            // set rotation direction based on the current bit
-            rotation = (bit == 0) ? SXBP_CLOCKWISE : SXBP_ANTI_CLOCKWISE;
-            // calculate the change of direction
-            current = sxbp_change_direction(current, rotation);
-            // store direction in result struct
-            spiral->lines[index].direction = current;
-            // set length to 0 initially
-            spiral->lines[index].length = 0;
+            directions = (directions << 2) | lines[b].direction;
         }
+        buffer->bytes[s] = decode_directions(directions, previous, &valid);
+        previous = lines[7].direction;
+    }
+    // don't give back data for spirals that couldn't have come from any
+    if(!valid) {
+        sxbp_free(buffer->bytes);
+        buffer->bytes = NULL;
+        buffer->size = 0;
+        return result;
     }
     // all ok
     result = SXBP_OPERATION_OK;
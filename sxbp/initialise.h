@@ -21,6 +21,8 @@
 #ifndef SAXBOPHONE_SAXBOSPIRAL_INITIALISE_H
 #define SAXBOPHONE_SAXBOSPIRAL_INITIALISE_H
 
+#include <stdio.h>
+
 #include "saxbospiral.h"
 
 
@@ -28,6 +30,12 @@
 extern "C"{
 #endif
 
+/**
+ * @brief The value which a read callback given to
+ * sxbp_init_spiral_from_stream() returns to signal that reading failed.
+ */
+#define SXBP_READ_ERROR ((size_t)-1)
+
 /**
  * @brief Gets the direction which is clockwise or anti-clockwise to the current
  * direction.
@@ -58,7 +66,9 @@ sxbp_spiral_t sxbp_blank_spiral(void);
  * buffer.
  * @details This converts the 0s and 1s in the buffer data into UP, LEFT, DOWN,
  * RIGHT instructions which are then used to build the pattern. Only the line
- * directions are calculated at this point, all line lengths are 0.
+ * directions are calculated at this point, all line lengths are 0. The data is
+ * converted a byte at a time, with all 8 of a byte's directions looked up
+ * together.
  *
  * @param buffer A buffer containing at least one byte of data, used to
  * determine the directions of the lines in the spiral it will create.
@@ -66,12 +76,193 @@ sxbp_spiral_t sxbp_blank_spiral(void);
  * to.
  * @return SXBP_OPERATION_OK on success.
  * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if there is too much data for the number of
+ * lines to be counted (see SXBP_WIDE_MODE).
  *
  * @note Asserts:
  * - That all the pointer members of parameter spiral are set to NULL
  */
 sxbp_status_t sxbp_init_spiral(sxbp_buffer_t buffer, sxbp_spiral_t* spiral);
 
+/**
+ * @brief Builds a partially-complete spiral from binary input data stored in a
+ * buffer, on several threads at once.
+ * @details The result is exactly the same as that of sxbp_init_spiral(). Large
+ * buffers are split into one chunk per thread. The turn made by each chunk is
+ * found first, which only depends on the parity of its bits and so is cheap,
+ * and then the lines of all the chunks are built alongside each other.
+ *
+ * @param buffer A buffer containing at least one byte of data, used to
+ * determine the directions of the lines in the spiral it will create.
+ * @param thread_count The maximum number of threads to use. 0 or 1 means do
+ * all the work on the calling thread. Buffers smaller than 2 MiB are always done
+ * on the calling thread, as threads wouldn't save any time.
+ * @param[out] spiral Spiral object which the line directions will be written
+ * to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if there is too much data for the number of
+ * lines to be counted (see SXBP_WIDE_MODE).
+ *
+ * @note Asserts:
+ * - That all the pointer members of parameter spiral are set to NULL
+ */
+sxbp_status_t sxbp_init_spiral_in_parallel(
+    sxbp_buffer_t buffer, size_t thread_count, sxbp_spiral_t* spiral
+);
+
+/**
+ * @brief Builds a partially-complete spiral from binary input data read from
+ * a stream.
+ * @details The result is exactly the same as that of sxbp_init_spiral() given
+ * all of the data in the stream, but the data is pulled in via a read callback
+ * in small chunks and turned into lines as it arrives, so it never has to be
+ * held in memory all at once.
+ *
+ * @param read_callback A function pointer with the following signature:
+ * @code
+ * size_t callback_name(uint8_t* data, size_t size, void* user_data)
+ * @endcode
+ * The callback should read up to size bytes into data, returning the number of
+ * bytes actually read. Fewer bytes than requested may be returned at any time,
+ * but returning 0 signals the end of the stream. Returning SXBP_READ_ERROR
+ * signals that the stream couldn't be read, after which the callback will not
+ * be called again.
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the read callback every time it is called (such as a file handle).
+ * @param size_hint How many bytes the stream is expected to hold, or 0 if this
+ * isn't known. Memory for the spiral's lines is allocated up front to fit this
+ * many, and grown or shrunk to fit if the stream turns out to be another size.
+ * @param[out] spiral Spiral object which the line directions will be written
+ * to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_OPERATION_FAIL if the read callback signalled an error.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if there is too much data for the number of
+ * lines to be counted (see SXBP_WIDE_MODE).
+ *
+ * @note Asserts:
+ * - That read_callback is not NULL
+ * - That all the pointer members of parameter spiral are set to NULL
+ */
+sxbp_status_t sxbp_init_spiral_from_stream(
+    size_t(* read_callback)(uint8_t* data, size_t size, void* user_data),
+    void* user_data, size_t size_hint, sxbp_spiral_t* spiral
+);
+
+/**
+ * @brief Builds a partially-complete spiral from binary input data read from
+ * a file.
+ * @details Convenience wrapper for sxbp_init_spiral_from_stream() which reads
+ * the rest of a file opened for reading in binary mode. If the file can be
+ * seeked, the length of the rest of it is used as the size hint.
+ *
+ * @param file The file to read the data from.
+ * @param[out] spiral Spiral object which the line directions will be written
+ * to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_OPERATION_FAIL if the file couldn't be seeked back to where it
+ * was after finding its length, or if it couldn't be read.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if there is too much data for the number of
+ * lines to be counted (see SXBP_WIDE_MODE).
+ *
+ * @note Asserts:
+ * - That file is not NULL
+ * - That all the pointer members of parameter spiral are set to NULL
+ */
+sxbp_status_t sxbp_init_spiral_from_file(FILE* file, sxbp_spiral_t* spiral);
+
+/**
+ * @brief Adds the lines for more binary data onto the end of a spiral.
+ * @details The lines are built just as sxbp_init_spiral() would build them,
+ * carrying on turning from the direction of the spiral's last line, so the
+ * spiral ends up the same as one built from all of the data at once. The
+ * lengths of the new lines are 0.
+ *
+ * The length of each line of a solved spiral only depends on the lines before
+ * it, so the lines which have already been solved stay solved, and the
+ * spiral's solved_count and co-ord cache are left as they are. Calling
+ * sxbp_plot_spiral() afterwards carries on solving from the first of the new
+ * lines (or wherever solving had got to, if it hadn't got that far).
+ *
+ * @param[in, out] spiral The spiral to add lines to.
+ * @param buffer A buffer containing the data to build the new lines from.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure, in which case the
+ * spiral is left as it was.
+ * @return SXBP_SIZE_OVERFLOW if there would be too many lines to count (see
+ * SXBP_WIDE_MODE), in which case the spiral is also left as it was.
+ *
+ * @note Asserts:
+ * - That spiral->lines is not NULL
+ * - That spiral->size is not 0
+ */
+sxbp_status_t sxbp_spiral_append(sxbp_spiral_t* spiral, sxbp_buffer_t buffer);
+
+/**
+ * @brief Changes some of the binary data a spiral was built from, so that
+ * only the lines from the first one changed need solving again.
+ * @details The directions of the lines built from the given bytes are
+ * rewritten. If the new bytes leave the spiral facing the other way to the
+ * old ones, all the lines after them are turned around too. The lines before
+ * the first line that changed are left exactly as they are. The spiral's
+ * solved_count and co-ord cache are cut back to that line and the lengths
+ * from there on are set to 0. Calling sxbp_plot_spiral() afterwards solves the
+ * spiral again from that line onwards, so editing the end of the data costs
+ * much less than solving the whole spiral again.
+ *
+ * @note While solving a line, the solver may lengthen some lines before it to
+ * get out of a collision. So the kept lines are always collision-free, but
+ * they may be longer than they would have been had the spiral been solved
+ * from the new data from scratch. The spiral solved after an edit is always
+ * valid and decodes to the new data, but it isn't guaranteed to match a fresh
+ * solve line for line.
+ *
+ * @param[in, out] spiral The spiral to edit.
+ * @param offset The index of the first byte of data to change.
+ * @param buffer A buffer containing the new bytes of data, which replace the
+ * same number of bytes from offset onwards.
+ * @return SXBP_OPERATION_OK on success, which includes when the bytes given
+ * are the same as those already there or the buffer is empty, in which case
+ * nothing is changed.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure, in which case the
+ * spiral is left as it was.
+ *
+ * @note Asserts:
+ * - That spiral->lines is not NULL
+ * - That spiral->size is not 0
+ * - That the bytes to change are all within the data the spiral was built from
+ */
+sxbp_status_t sxbp_spiral_edit(
+    sxbp_spiral_t* spiral, size_t offset, sxbp_buffer_t buffer
+);
+
+/**
+ * @brief Recovers the binary data that a spiral was built from.
+ * @details This is the inverse of sxbp_init_spiral(), it converts each turn
+ * between consecutive lines of the spiral back into the bit it came from (a
+ * clockwise turn for a 0 and an anti-clockwise turn for a 1). Only the line
+ * directions are used, so it works just as well on solved spirals as it does
+ * on unsolved ones. The turns are decoded a byte at a time, with all 8 of a
+ * byte's turns worked out together.
+ *
+ * @param spiral The spiral to decode.
+ * @param[out] buffer The buffer to write the decoded data to. Memory is
+ * allocated for it, which must be freed by the caller.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_OPERATION_FAIL if the spiral couldn't have been built from any
+ * data, such as if its number of lines isn't one more than a multiple of 8, if
+ * its first line isn't UP or if any line isn't a quarter-turn from the line
+ * before it. No memory is left allocated for buffer in this case.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That buffer->bytes is NULL
+ */
+sxbp_status_t sxbp_decode_spiral(sxbp_spiral_t spiral, sxbp_buffer_t* buffer);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
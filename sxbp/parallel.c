@@ -0,0 +1,159 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ *
+ * Copyright (C) 2016, 2017, Joshua Saxby joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+// only include these extra dependencies if thread support was enabled
+#ifdef LIBSXBP_THREAD_SUPPORT
+#include <stdlib.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "saxbospiral.h"
+#include "allocator.h"
+#include "parallel.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// flag for whether thread support has been compiled in, based on macro
+#ifdef LIBSXBP_THREAD_SUPPORT
+const bool SXBP_THREAD_SUPPORT = true;
+#else
+const bool SXBP_THREAD_SUPPORT = false;
+#endif
+
+/*
+ * private type holding everything one worker needs to run its share of jobs.
+ * Worker n of m runs jobs n, n + m, n + 2m, ... so that no coordination is
+ * needed between workers.
+ */
+typedef struct worker_t {
+    size_t first_job;
+    size_t job_stride;
+    size_t job_count;
+    sxbp_status_t(* job)(size_t job_index, void* user_data);
+    void* user_data;
+    // the status of the first job of this worker to fail, if any
+    sxbp_status_t result;
+    // the allocator set for the thread the jobs were started from, if any
+    const sxbp_allocator_t* allocator;
+} worker_t;
+
+// private function, runs all the jobs of one worker
+static void run_worker(worker_t* worker) {
+    worker->result = SXBP_OPERATION_OK;
+    for(
+        size_t i = worker->first_job; i < worker->job_count;
+        i += worker->job_stride
+    ) {
+        sxbp_status_t status = worker->job(i, worker->user_data);
+        if(
+            (status != SXBP_OPERATION_OK) &&
+            (worker->result == SXBP_OPERATION_OK)
+        ) {
+            worker->result = status;
+        }
+    }
+}
+
+#ifdef LIBSXBP_THREAD_SUPPORT
+/*
+ * private thread entry point, wrapping run_worker() so that the jobs allocate
+ * memory with the same allocator as the thread that started them
+ */
+static void* worker_thread(void* worker) {
+    sxbp_set_thread_allocator(((worker_t*)worker)->allocator);
+    run_worker((worker_t*)worker);
+    return NULL;
+}
+#endif
+
+size_t sxbp_get_processor_count(void) {
+    #if defined(LIBSXBP_THREAD_SUPPORT) && defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    if(count > 0) {
+        return (size_t)count;
+    }
+    #endif
+    return 1;
+}
+
+sxbp_status_t sxbp_run_parallel_jobs(
+    size_t job_count, size_t thread_count,
+    sxbp_status_t(* job)(size_t job_index, void* user_data),
+    void* user_data
+) {
+    // preconditional assertions
+    assert(job != NULL);
+    // there's no point having more threads than jobs
+    if(thread_count > job_count) {
+        thread_count = job_count;
+    }
+    #ifdef LIBSXBP_THREAD_SUPPORT
+    if(thread_count > 1) {
+        worker_t* workers = sxbp_calloc(sizeof(worker_t), thread_count);
+        pthread_t* threads = sxbp_calloc(sizeof(pthread_t), thread_count);
+        bool* started = sxbp_calloc(sizeof(bool), thread_count);
+        if((workers == NULL) || (threads == NULL) || (started == NULL)) {
+            sxbp_free(workers);
+            sxbp_free(threads);
+            sxbp_free(started);
+            return SXBP_MALLOC_REFUSED;
+        }
+        const sxbp_allocator_t* allocator = sxbp_get_thread_allocator();
+        for(size_t i = 0; i < thread_count; i++) {
+            workers[i] = (worker_t){
+                i, thread_count, job_count, job, user_data, SXBP_STATE_UNKNOWN,
+                allocator,
+            };
+        }
+        // worker 0 runs on this thread, the others get threads of their own
+        for(size_t i = 1; i < thread_count; i++) {
+            started[i] = (
+                pthread_create(&threads[i], NULL, worker_thread, &workers[i])
+                == 0
+            );
+        }
+        run_worker(&workers[0]);
+        // wait for all the threads, running the jobs of any that didn't start
+        sxbp_status_t result = workers[0].result;
+        for(size_t i = 1; i < thread_count; i++) {
+            if(started[i]) {
+                pthread_join(threads[i], NULL);
+            } else {
+                run_worker(&workers[i]);
+            }
+            if(result == SXBP_OPERATION_OK) {
+                result = workers[i].result;
+            }
+        }
+        sxbp_free(workers);
+        sxbp_free(threads);
+        sxbp_free(started);
+        return result;
+    }
+    #endif // LIBSXBP_THREAD_SUPPORT
+    // otherwise, just run all the jobs on this thread
+    worker_t worker = {
+        0, 1, job_count, job, user_data, SXBP_STATE_UNKNOWN, NULL,
+    };
+    run_worker(&worker);
+    return worker.result;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,93 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ */
+
+/**
+ * @file
+ *
+ * @brief This compilation unit provides a simple way of spreading independent
+ * jobs across several threads, used by the library's parallel algorithms.
+ *
+ * @note Thread support may have not been enabled in the compiled version of
+ * libsxbp that you have. If support is not enabled, the library boolean
+ * constant SXBP_THREAD_SUPPORT will be set to false and all jobs will be run
+ * one after the other on the calling thread instead, with the same results.
+ *
+ * @author Joshua Saxby <joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ * @date 2016, 2017
+ *
+ * @copyright Copyright (C) Joshua Saxby 2016, 2017
+ *
+ * @copyright
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef SAXBOPHONE_SAXBOSPIRAL_PARALLEL_H
+#define SAXBOPHONE_SAXBOSPIRAL_PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "saxbospiral.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Flag for whether multi-threading support has been enabled.
+ * @details This is compiled into the library, based on a macro set at build
+ * time. The value of this constant is false if thread support is not enabled
+ * and true if it is.
+ */
+extern const bool SXBP_THREAD_SUPPORT;
+
+/**
+ * @brief Returns the number of processors available to run threads on.
+ * @details This is a sensible thread count to pass to the functions that take
+ * one. If thread support is not enabled or the number can't be found out, this
+ * returns 1.
+ *
+ * @return The number of processors currently online, at least 1.
+ */
+size_t sxbp_get_processor_count(void);
+
+/**
+ * @brief Runs a number of independent jobs, spread across several threads.
+ * @details The job callback is called once for every job index from 0 up to
+ * (but not including) job_count. Jobs are divided between up to thread_count
+ * threads (one of which is the calling thread), and may be run in any order
+ * and concurrently with each other, so they must not depend on one another.
+ * This function returns once all of the jobs have finished.
+ *
+ * @param job_count The number of jobs to run.
+ * @param thread_count The maximum number of threads to use. 0 and 1 both mean
+ * that all of the jobs are run on the calling thread.
+ * @param job A function pointer with the following signature:
+ * @code
+ * sxbp_status_t callback_name(size_t job_index, void* user_data)
+ * @endcode
+ * @param user_data An optional void pointer to a user-defined type which is
+ * passed to every call of the job callback, typically holding the job's shared
+ * inputs and outputs.
+ * @return SXBP_OPERATION_OK if all the jobs returned SXBP_OPERATION_OK.
+ * @return The status of one of the failing jobs if any of them failed.
+ *
+ * @note Asserts:
+ * - That job is not NULL
+ */
+sxbp_status_t sxbp_run_parallel_jobs(
+    size_t job_count, size_t thread_count,
+    sxbp_status_t(* job)(size_t job_index, void* user_data),
+    void* user_data
+);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+// end of header file
+#endif
@@ -9,9 +9,11 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "saxbospiral.h"
+#include "allocator.h"
 #include "plot.h"
 
 
@@ -31,6 +33,13 @@ size_t sxbp_sum_lines(sxbp_spiral_t spiral, size_t start, size_t end) {
     return size;
 }
 
+// private function, returns how far the co-ord is from the origin on any axis
+static uintmax_t co_ord_reach(sxbp_co_ord_t co_ord) {
+    uintmax_t x = (co_ord.x < 0) ? -(uintmax_t)co_ord.x : (uintmax_t)co_ord.x;
+    uintmax_t y = (co_ord.y < 0) ? -(uintmax_t)co_ord.y : (uintmax_t)co_ord.y;
+    return (x > y) ? x : y;
+}
+
 sxbp_status_t sxbp_spiral_points(
     sxbp_spiral_t spiral, sxbp_co_ord_array_t* output,
     sxbp_co_ord_t start_point, size_t start, size_t end
@@ -44,8 +53,19 @@ sxbp_status_t sxbp_spiral_points(
     sxbp_status_t result;
     // the amount of space needed is the sum of all line lengths + 1 for end
     size_t size = sxbp_sum_lines(spiral, start, end) + 1;
+    /*
+     * no co-ord can be further from the start point than the sum of the line
+     * lengths, so the co-ords can't overflow if that fits in what's left
+     */
+    uintmax_t reach = co_ord_reach(start_point);
+    if(
+        (reach > (uintmax_t)SXBP_TUPLE_ITEM_MAX) ||
+        ((uintmax_t)(size - 1) > (uintmax_t)SXBP_TUPLE_ITEM_MAX - reach)
+    ) {
+        return SXBP_SIZE_OVERFLOW;
+    }
     // allocate memory
-    output->items = calloc(sizeof(sxbp_co_ord_t), size);
+    output->items = sxbp_calloc(sizeof(sxbp_co_ord_t), size);
     // catch malloc error
     if(output->items == NULL) {
         // set error information then early return
@@ -75,6 +95,48 @@ sxbp_status_t sxbp_spiral_points(
     return result;
 }
 
+// private function, widens the given bounds if needed to include the co-ord
+static void widen_bounds(sxbp_co_ord_t bounds[2], sxbp_co_ord_t co_ord) {
+    if(co_ord.x < bounds[0].x) {
+        bounds[0].x = co_ord.x;
+    }
+    if(co_ord.y < bounds[0].y) {
+        bounds[0].y = co_ord.y;
+    }
+    if(co_ord.x > bounds[1].x) {
+        bounds[1].x = co_ord.x;
+    }
+    if(co_ord.y > bounds[1].y) {
+        bounds[1].y = co_ord.y;
+    }
+}
+
+/*
+ * private function, brings the bounds of the spiral's co-ord cache up to date
+ * with its co-ords up to line limit, given that the co-ords of the lines from
+ * line start (the first of which is at co_ord_index in the cache) onwards have
+ * just been cached. Only the ends of lines are looked at, as lines are
+ * straight. If the bounds are already valid up to line start, just the new
+ * lines are added to them, otherwise they are worked out again from the first
+ * line.
+ */
+static void update_cache_bounds(
+    sxbp_spiral_t* spiral, size_t start, size_t co_ord_index, size_t limit
+) {
+    sxbp_co_ord_cache_t* cache = &spiral->co_ord_cache;
+    if((start == 0) || (cache->bounds_validity != start)) {
+        start = 0;
+        co_ord_index = 0;
+        cache->bounds[0] = cache->co_ords.items[0];
+        cache->bounds[1] = cache->co_ords.items[0];
+    }
+    for(size_t i = start; i < limit; i++) {
+        co_ord_index += spiral->lines[i].length;
+        widen_bounds(cache->bounds, cache->co_ords.items[co_ord_index]);
+    }
+    cache->bounds_validity = limit;
+}
+
 sxbp_status_t sxbp_cache_spiral_points(sxbp_spiral_t* spiral, size_t limit) {
     // preconditional assertions
     assert(spiral->lines != NULL);
@@ -89,12 +151,12 @@ sxbp_status_t sxbp_cache_spiral_points(sxbp_spiral_t* spiral, size_t limit) {
          * if no memory has been allocated for the co-ords yet, then do this now
          * allocate enough memory to store these
          */
-        spiral->co_ord_cache.co_ords.items = calloc(
+        spiral->co_ord_cache.co_ords.items = sxbp_calloc(
             sizeof(sxbp_co_ord_t), size
         );
     } else if(spiral->co_ord_cache.co_ords.size != size) {
         // if there isn't enough memory allocated, re-allocate memory instead
-        spiral->co_ord_cache.co_ords.items = realloc(
+        spiral->co_ord_cache.co_ords.items = sxbp_realloc(
             spiral->co_ord_cache.co_ords.items, sizeof(sxbp_co_ord_t) * size
         );
     }
@@ -139,17 +201,51 @@ sxbp_status_t sxbp_cache_spiral_points(sxbp_spiral_t* spiral, size_t limit) {
     }
     // free dynamically allocated memory, if any was allocated
     if(missing.items != NULL) {
-        free(missing.items);
+        sxbp_free(missing.items);
     }
-    // set validity to the largest of limit and current validity
-    spiral->co_ord_cache.validity = (
-        limit > spiral->co_ord_cache.validity
-    ) ? limit : spiral->co_ord_cache.validity;
+    // widen the bounds to take in the new co-ords
+    update_cache_bounds(spiral, smallest, result_index, limit);
+    /*
+     * the cache now holds the co-ords of exactly the lines up to limit - any
+     * it held for lines beyond that have been cut off by resizing it
+     */
+    spiral->co_ord_cache.validity = limit;
     // return ok
     result = SXBP_OPERATION_OK;
     return result;
 }
 
+void sxbp_get_spiral_bounds(
+    const sxbp_spiral_t* spiral, sxbp_co_ord_t bounds[2]
+) {
+    // preconditional assertions
+    assert(spiral->lines != NULL);
+    assert(bounds != NULL);
+    const sxbp_co_ord_cache_t* cache = &spiral->co_ord_cache;
+    // use the cached bounds if they are valid for all the lines
+    if(
+        (cache->co_ords.items != NULL) &&
+        (cache->validity == spiral->size) &&
+        (cache->bounds_validity == spiral->size)
+    ) {
+        bounds[0] = cache->bounds[0];
+        bounds[1] = cache->bounds[1];
+        return;
+    }
+    sxbp_co_ord_t current = { 0, 0, };
+    bounds[0] = current;
+    bounds[1] = current;
+    // lines are straight, so only their ends can be furthest out
+    for(size_t i = 0; i < spiral->size; i++) {
+        sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[
+            spiral->lines[i].direction
+        ];
+        current.x += direction.x * (sxbp_tuple_item_t)spiral->lines[i].length;
+        current.y += direction.y * (sxbp_tuple_item_t)spiral->lines[i].length;
+        widen_bounds(bounds, current);
+    }
+}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -71,6 +71,8 @@ size_t sxbp_sum_lines(sxbp_spiral_t spiral, size_t start, size_t end);
  * segment which is being calculated.
  * @return SXBP_OPERATION_OK on success.
  * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the co-ords would be too big for
+ * sxbp_tuple_item_t.
  *
  * @note For this function to do anything useful, the spiral should at least
  * have some line lengths calculated, but this is not essential.
@@ -95,12 +97,15 @@ sxbp_status_t sxbp_spiral_points(
  * in the spiral's internal cache, then these will be calculated and stored in
  * the cache. Subsequent identical calls will not incur the overhead of
  * re-calculating these co-ords, provided the lengths of any of the spiral's
- * lines are not changed in the process.
+ * lines are not changed in the process. The bounds of the cached co-ords are
+ * kept up to date as they are cached (see sxbp_get_spiral_bounds()).
  *
  * @param[in, out] spiral The spiral for which co-ords should be cached.
  * @param limit The highest index of line for which co-ords should be cached to.
  * @return SXBP_OPERATION_OK on success.
  * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the co-ords would be too big for
+ * sxbp_tuple_item_t.
  *
  * @note Asserts:
  * - That spiral->lines is not NULL
@@ -108,6 +113,25 @@ sxbp_status_t sxbp_spiral_points(
  */
 sxbp_status_t sxbp_cache_spiral_points(sxbp_spiral_t* spiral, size_t limit);
 
+/**
+ * @brief Finds the smallest and largest co-ords that a spiral's lines reach.
+ * @details The co-ords found always include the origin. If the spiral's co-ord
+ * cache is valid for all of its lines, the bounds kept up to date in the cache
+ * by sxbp_cache_spiral_points() are used. Otherwise, they are found by going
+ * over the ends of all the spiral's lines.
+ *
+ * @param spiral The spiral to find the bounds of.
+ * @param[out] bounds A 2-item array to write the bounds to, the smallest x
+ * and y first and the largest x and y second.
+ *
+ * @note Asserts:
+ * - That spiral->lines is not NULL
+ * - That bounds is not NULL
+ */
+void sxbp_get_spiral_bounds(
+    const sxbp_spiral_t* spiral, sxbp_co_ord_t bounds[2]
+);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
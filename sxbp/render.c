@@ -10,12 +10,17 @@
  */
 #include <assert.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "saxbospiral.h"
+#include "allocator.h"
+#include "parallel.h"
 #include "plot.h"
 #include "render.h"
+#include "solve.h"
 
 
 #ifdef __cplusplus
@@ -23,43 +28,602 @@ extern "C"{
 #endif
 
 /*
- * given a spiral struct with co-ords in it's cache and a pointer to a
- * 2-item-long array of type co_ord_t, find and store the co-ords for the
- * corners of the square needed to contain the points.
- * NOTE: This should NEVER be called with a pointer to anything other than a
- * 2-item array of type co_ord_t
+ * private type representing a rectangle of pixels which are all black in the
+ * rendered image, with inclusive bounds. Every line of a spiral is drawn as one
+ * of these (except for the first, which is drawn as two).
+ */
+typedef struct pixel_rect_t {
+    uint32_t left;
+    uint32_t top;
+    uint32_t right;
+    uint32_t bottom;
+} pixel_rect_t;
+
+/*
+ * private type holding everything needed to rasterise a spiral, the size of
+ * the image and the rectangles to draw on it, sorted by their top row
+ */
+typedef struct raster_t {
+    uint32_t width;
+    uint32_t height;
+    pixel_rect_t* rects;
+    size_t count;
+} raster_t;
+
+/*
+ * private function, returns the options to use for rendering, with any which
+ * were left as 0 replaced with their defaults
+ */
+static sxbp_render_options_t resolve_options(sxbp_render_options_t options) {
+    if(options.scale == 0) {
+        options.scale = 2;
+    }
+    if(options.thickness == 0) {
+        options.thickness = 1;
+    }
+    return options;
+}
+
+/*
+ * private function, returns the rectangle covering the pixels between the two
+ * given co-ords of the spiral (which must be in a straight line), given the
+ * bounds of the spiral and the render options. Each co-ord is drawn as a square
+ * of thickness pixels across, scale pixels from its neighbours and with a
+ * border of thickness pixels around the whole image. The y-axis is flipped so
+ * that up is towards the top of the image.
+ */
+static pixel_rect_t get_pixel_rect(
+    sxbp_co_ord_t a, sxbp_co_ord_t b, sxbp_co_ord_t* bounds,
+    sxbp_render_options_t options
+) {
+    /*
+     * the image has been checked to fit in 32-bit dimensions, so the distances
+     * can be worked out in 32 bits without the co-ords themselves overflowing
+     */
+    uint32_t border = options.thickness;
+    uint32_t a_column = (
+        ((uint32_t)a.x - (uint32_t)bounds[0].x) * options.scale + border
+    );
+    uint32_t a_row = (
+        ((uint32_t)bounds[1].y - (uint32_t)a.y) * options.scale + border
+    );
+    uint32_t b_column = (
+        ((uint32_t)b.x - (uint32_t)bounds[0].x) * options.scale + border
+    );
+    uint32_t b_row = (
+        ((uint32_t)bounds[1].y - (uint32_t)b.y) * options.scale + border
+    );
+    pixel_rect_t rect = {
+        .left = (a_column < b_column) ? a_column : b_column,
+        .top = (a_row < b_row) ? a_row : b_row,
+        .right = ((a_column < b_column) ? b_column : a_column),
+        .bottom = ((a_row < b_row) ? b_row : a_row),
+    };
+    // the square at each end extends right and down by the thickness
+    rect.right += options.thickness - 1;
+    rect.bottom += options.thickness - 1;
+    return rect;
+}
+
+// private function, qsort() comparison for sorting rects by their top row
+static int compare_rects(const void* a, const void* b) {
+    uint32_t a_top = ((const pixel_rect_t*)a)->top;
+    uint32_t b_top = ((const pixel_rect_t*)b)->top;
+    return (a_top > b_top) - (a_top < b_top);
+}
+
+/*
+ * private function, shrinks the given rect of a line going in the given
+ * direction so that it doesn't include the square of pixels at its start
+ */
+static void trim_rect_start(
+    pixel_rect_t* rect, sxbp_direction_t direction, uint32_t thickness
+) {
+    // the y-axis is flipped, so lines going up start at the bottom of the rect
+    switch(direction) {
+        case SXBP_UP:
+            rect->bottom -= thickness;
+            break;
+        case SXBP_RIGHT:
+            rect->left += thickness;
+            break;
+        case SXBP_DOWN:
+            rect->top += thickness;
+            break;
+        case SXBP_LEFT:
+            rect->right -= thickness;
+            break;
+    }
+}
+
+/*
+ * private function, works out the rects of pixels to draw for the given line,
+ * which is the line at the given index of its spiral and starts at the co-ord
+ * pointed to by current, given the bounds of the spiral and the (resolved)
+ * options. The rects are stored in rects, and the number of them (0 to 2) is
+ * returned. current is moved on to the end of the line.
+ * If disjoint is true and this isn't the first line, the square at the start of
+ * the line is left out (see build_raster()).
+ */
+static size_t get_line_rects(
+    sxbp_line_t line, size_t index, sxbp_co_ord_t* current,
+    sxbp_co_ord_t* bounds, sxbp_render_options_t options, bool disjoint,
+    pixel_rect_t rects[2]
+) {
+    size_t count = 0;
+    sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[line.direction];
+    sxbp_co_ord_t end = {
+        current->x + direction.x * (sxbp_tuple_item_t)line.length,
+        current->y + direction.y * (sxbp_tuple_item_t)line.length,
+    };
+    sxbp_co_ord_t start = *current;
+    if(index == 0) {
+        /*
+         * the first line leaves a gap of one pixel after its start point,
+         * so draw the start point on its own and the rest of it after that
+         */
+        rects[count++] = get_pixel_rect(start, start, bounds, options);
+        start.x += direction.x;
+        start.y += direction.y;
+    }
+    if(index == 0 && line.length > 0) {
+        rects[count++] = get_pixel_rect(start, end, bounds, options);
+    } else if(index != 0 && (!disjoint || line.length > 0)) {
+        rects[count] = get_pixel_rect(start, end, bounds, options);
+        if(disjoint) {
+            trim_rect_start(&rects[count], line.direction, options.thickness);
+        }
+        count++;
+    }
+    *current = end;
+    return count;
+}
+
+/*
+ * private function, works out how many pixels across the image of co-ords from
+ * low to high inclusive is with the given (resolved) options, which includes
+ * the line thickness and a border each side, storing it in size. Returns
+ * SXBP_SIZE_OVERFLOW if it doesn't fit in 32 bits.
+ */
+static sxbp_status_t get_image_size(
+    sxbp_tuple_item_t low, sxbp_tuple_item_t high,
+    sxbp_render_options_t options, uint32_t* size
+) {
+    // this is worked out in 64 bits, so it can't overflow before it's checked
+    uint64_t span = (uint64_t)high - (uint64_t)low;
+    uint64_t padding = (uint64_t)options.thickness * 3U;
+    if(
+        (padding > UINT32_MAX) ||
+        (span > (UINT32_MAX - padding) / options.scale)
+    ) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    *size = (uint32_t)((span * options.scale) + padding);
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, returns whether the co-ords of the given lines of a spiral
+ * fit in sxbp_tuple_item_t - no co-ord can be further from the origin than the
+ * sum of the lengths of the lines
+ */
+static bool co_ords_fit(const sxbp_spiral_t* spiral, size_t count) {
+    return (uintmax_t)sxbp_sum_lines(*spiral, 0, count) <= (
+        (uintmax_t)SXBP_TUPLE_ITEM_MAX
+    );
+}
+
+/*
+ * private function, works out the size of the image that the spiral will be
+ * rendered to with the given (resolved) options and the rects of pixels to draw
+ * for each of its lines, storing these in raster. raster->rects must be freed
+ * by the caller.
+ * If disjoint is true, each line after the first leaves out the square at its
+ * start (which is already drawn as the end of the line before it), so that the
+ * rects of a solved spiral never overlap one another.
+ *
+ * Asserts:
+ * - That spiral->lines is not NULL
+ */
+static sxbp_status_t build_raster(
+    const sxbp_spiral_t* spiral, sxbp_render_options_t options, bool disjoint,
+    raster_t* raster
+) {
+    // preconditional assertions
+    assert(spiral->lines != NULL);
+    /*
+     * get the min and max bounds of the spiral's co-ords - these come straight
+     * from the spiral's co-ord cache if it has been cached all the way through
+     */
+    if(!co_ords_fit(spiral, spiral->size)) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    sxbp_co_ord_t bounds[2] = {{0, 0}};
+    sxbp_get_spiral_bounds(spiral, bounds);
+    // image dimensions are the scaled size + line thickness + border each side
+    sxbp_status_t result = get_image_size(
+        bounds[0].x, bounds[1].x, options, &raster->width
+    );
+    if(result == SXBP_OPERATION_OK) {
+        result = get_image_size(
+            bounds[0].y, bounds[1].y, options, &raster->height
+        );
+    }
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // one rect per line, plus one for the start of the first line
+    raster->rects = sxbp_calloc(sizeof(pixel_rect_t), (size_t)spiral->size + 1);
+    if(raster->rects == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    raster->count = 0;
+    sxbp_co_ord_t current = { 0, 0, };
+    for(size_t i = 0; i < spiral->size; i++) {
+        raster->count += get_line_rects(
+            spiral->lines[i], i, &current, bounds, options, disjoint,
+            raster->rects + raster->count
+        );
+    }
+    qsort(raster->rects, raster->count, sizeof(pixel_rect_t), compare_rects);
+    return SXBP_OPERATION_OK;
+}
+
+bool sxbp_get_bitmap_pixel(sxbp_bitmap_t bitmap, uint32_t x, uint32_t y) {
+    // preconditional assertions
+    assert(bitmap.pixels != NULL);
+    assert(x < bitmap.width);
+    assert(y < bitmap.height);
+    return (bitmap.pixels[(y * bitmap.stride) + (x / 8)] >> (7 - (x % 8))) & 1;
+}
+
+/*
+ * private function, sets the pixels from column left to column right inclusive
+ * of the given rows of the image to black. The bits to set are worked out once
+ * for all of the rows: a mask for the byte at each end and whole bytes (set
+ * with memset()) for any in between. Vertical lines, which only cover one or
+ * two bytes of each row, cost just one or two OR operations per row.
  *
  * Asserts:
- * - That spiral.co_ord_cache.co_ords.items is not NULL
- * - That bounds is not NULL
+ * - That image->pixels is not NULL
+ * - That left <= right < image->width
  */
-static void get_bounds(sxbp_spiral_t spiral, sxbp_co_ord_t* bounds) {
+static void fill_rows(
+    sxbp_bitmap_t* image, uint32_t left, uint32_t right, uint32_t top,
+    uint32_t bottom
+) {
+    // preconditional assertions
+    assert(image->pixels != NULL);
+    assert(left <= right);
+    assert(right < image->width);
+    size_t first_byte = left / 8;
+    size_t last_byte = right / 8;
+    uint8_t first_mask = (uint8_t)(0xffU >> (left % 8));
+    uint8_t last_mask = (uint8_t)(0xffU << (7 - (right % 8)));
+    if(first_byte == last_byte) {
+        first_mask &= last_mask;
+    }
+    for(uint32_t y = top; y <= bottom; y++) {
+        uint8_t* row = image->pixels + (y * image->stride);
+        row[first_byte] |= first_mask;
+        if(last_byte > first_byte) {
+            memset(row + first_byte + 1, 0xff, last_byte - first_byte - 1);
+            row[last_byte] |= last_mask;
+        }
+    }
+}
+
+/*
+ * private function, sets the pixels from column left to column right inclusive
+ * of the given rows of the image to white, the same way that fill_rows() sets
+ * them to black
+ *
+ * Asserts:
+ * - That image->pixels is not NULL
+ * - That left <= right < image->width
+ */
+static void clear_rows(
+    sxbp_bitmap_t* image, uint32_t left, uint32_t right, uint32_t top,
+    uint32_t bottom
+) {
+    // preconditional assertions
+    assert(image->pixels != NULL);
+    assert(left <= right);
+    assert(right < image->width);
+    size_t first_byte = left / 8;
+    size_t last_byte = right / 8;
+    uint8_t first_mask = (uint8_t)(0xffU >> (left % 8));
+    uint8_t last_mask = (uint8_t)(0xffU << (7 - (right % 8)));
+    if(first_byte == last_byte) {
+        first_mask &= last_mask;
+    }
+    for(uint32_t y = top; y <= bottom; y++) {
+        uint8_t* row = image->pixels + (y * image->stride);
+        row[first_byte] &= (uint8_t)~first_mask;
+        if(last_byte > first_byte) {
+            memset(row + first_byte + 1, 0x00, last_byte - first_byte - 1);
+            row[last_byte] &= (uint8_t)~last_mask;
+        }
+    }
+}
+
+/*
+ * private function, draws the parts of the given rects which fall within the
+ * band of rows of the image starting at the given row, which has already been
+ * cleared to white. The rects must all overlap the band.
+ *
+ * Asserts:
+ * - That band->pixels is not NULL
+ */
+static void draw_band(
+    sxbp_bitmap_t* band, uint32_t first_row, pixel_rect_t* rects, size_t count
+) {
+    // preconditional assertions
+    assert(band->pixels != NULL);
+    uint32_t last_row = first_row + band->height - 1;
+    for(size_t i = 0; i < count; i++) {
+        uint32_t top = (rects[i].top > first_row) ? rects[i].top : first_row;
+        uint32_t bottom = (
+            rects[i].bottom < last_row
+        ) ? rects[i].bottom : last_row;
+        fill_rows(
+            band, rects[i].left, rects[i].right, top - first_row,
+            bottom - first_row
+        );
+    }
+}
+
+/*
+ * private function, renders the raster a band of rows at a time, passing each
+ * band to the row sink in turn. Only the rects which overlap the current band
+ * are kept track of, so memory use is proportional to the width of the image
+ * and the number of rects, but not the height of the image.
+ *
+ * Asserts:
+ * - That raster->rects is not NULL
+ * - That band_height is not 0
+ */
+static sxbp_status_t render_bands(
+    raster_t* raster, uint32_t band_height,
+    sxbp_status_t(* row_sink)(
+        sxbp_bitmap_t band, uint32_t first_row, uint32_t image_height,
+        void* user_data
+    ),
+    void* user_data
+) {
     // preconditional assertions
-    assert(spiral.co_ord_cache.co_ords.items != NULL);
-    assert(bounds != NULL);
-    sxbp_tuple_item_t min_x = 0;
-    sxbp_tuple_item_t min_y = 0;
-    sxbp_tuple_item_t max_x = 0;
-    sxbp_tuple_item_t max_y = 0;
-    for(size_t i = 0; i < spiral.co_ord_cache.co_ords.size; i++) {
-        if(spiral.co_ord_cache.co_ords.items[i].x < min_x) {
-            min_x = spiral.co_ord_cache.co_ords.items[i].x;
+    assert(raster->rects != NULL);
+    assert(band_height != 0);
+    sxbp_status_t result = SXBP_MALLOC_REFUSED;
+    if(band_height > raster->height) {
+        band_height = raster->height;
+    }
+    sxbp_bitmap_t band = {
+        .width = raster->width,
+        .height = band_height,
+        .stride = ((size_t)raster->width + 7) / 8,
+        .pixels = NULL,
+    };
+    band.pixels = sxbp_malloc(band.stride * band_height);
+    // the rects overlapping the current band
+    pixel_rect_t* active = sxbp_calloc(sizeof(pixel_rect_t), raster->count);
+    if((band.pixels == NULL) || (active == NULL)) {
+        sxbp_free(band.pixels);
+        sxbp_free(active);
+        return result;
+    }
+    size_t active_count = 0;
+    size_t next_rect = 0;
+    for(uint32_t row = 0; row < raster->height; row += band.height) {
+        if(raster->height - row < band.height) {
+            band.height = raster->height - row;
         }
-        if(spiral.co_ord_cache.co_ords.items[i].y < min_y) {
-            min_y = spiral.co_ord_cache.co_ords.items[i].y;
+        uint32_t last_row = row + band.height - 1;
+        // drop the rects which finished above this band
+        size_t kept = 0;
+        for(size_t i = 0; i < active_count; i++) {
+            if(active[i].bottom >= row) {
+                active[kept++] = active[i];
+            }
+        }
+        active_count = kept;
+        // pick up the rects which start in this band
+        while(
+            (next_rect < raster->count) &&
+            (raster->rects[next_rect].top <= last_row)
+        ) {
+            active[active_count++] = raster->rects[next_rect++];
         }
-        if(spiral.co_ord_cache.co_ords.items[i].x > max_x) {
-            max_x = spiral.co_ord_cache.co_ords.items[i].x;
+        memset(band.pixels, 0, band.stride * band.height);
+        draw_band(&band, row, active, active_count);
+        result = row_sink(band, row, raster->height, user_data);
+        if(result != SXBP_OPERATION_OK) {
+            break;
+        }
+    }
+    sxbp_free(band.pixels);
+    sxbp_free(active);
+    return result;
+}
+
+/*
+ * private type indexing the rects of a raster by the cells of a grid laid over
+ * the image, each band_height rows high and column_width columns wide. Each
+ * rect is cut into the parts of it which fall within each cell it overlaps,
+ * and the parts in each cell are stored together, those for the cell in band b
+ * and column c being from cell_starts[i] up to (but not including)
+ * cell_starts[i + 1], where i is b * column_count + c.
+ */
+typedef struct sxbp_band_index_t {
+    uint32_t band_height;
+    size_t band_count;
+    uint32_t column_width;
+    size_t column_count;
+    size_t* cell_starts;
+    pixel_rect_t* cell_rects;
+} band_index_t;
+
+// private function, frees the memory held by a band index
+static void free_band_index(band_index_t* index) {
+    sxbp_free(index->cell_starts);
+    sxbp_free(index->cell_rects);
+    index->cell_starts = NULL;
+    index->cell_rects = NULL;
+}
+
+/*
+ * private function, returns the part of the given rect which falls within the
+ * cell of the band index at the given band and column
+ */
+static pixel_rect_t clip_rect_to_cell(
+    const band_index_t* index, pixel_rect_t rect, size_t band, size_t column
+) {
+    uint64_t left = (uint64_t)column * index->column_width;
+    uint64_t right = left + index->column_width - 1;
+    uint64_t top = (uint64_t)band * index->band_height;
+    uint64_t bottom = top + index->band_height - 1;
+    pixel_rect_t part = rect;
+    if(part.left < left) {
+        part.left = (uint32_t)left;
+    }
+    if(part.right > right) {
+        part.right = (uint32_t)right;
+    }
+    if(part.top < top) {
+        part.top = (uint32_t)top;
+    }
+    if(part.bottom > bottom) {
+        part.bottom = (uint32_t)bottom;
+    }
+    return part;
+}
+
+/*
+ * private function, sorts the rects of the raster into the cells of a grid of
+ * bands of band_height rows and columns of column_width columns with a counting
+ * sort, storing them in the given band index. A rect which crosses several
+ * cells is cut into one part for each of them. The parts in each cell stay in
+ * the same order as the rects of the raster. The index must be freed by the
+ * caller, whether this succeeds or not.
+ *
+ * Asserts:
+ * - That raster->rects is not NULL
+ * - That band_height is not 0
+ * - That column_width is not 0
+ */
+static sxbp_status_t bucket_rects(
+    raster_t* raster, uint32_t band_height, uint32_t column_width,
+    band_index_t* index
+) {
+    // preconditional assertions
+    assert(raster->rects != NULL);
+    assert(band_height != 0);
+    assert(column_width != 0);
+    index->band_height = band_height;
+    index->band_count = (
+        ((size_t)raster->height + band_height - 1) / band_height
+    );
+    index->column_width = column_width;
+    index->column_count = (
+        ((size_t)raster->width + column_width - 1) / column_width
+    );
+    size_t cell_count = index->band_count * index->column_count;
+    index->cell_rects = NULL;
+    index->cell_starts = sxbp_calloc(cell_count + 1, sizeof(size_t));
+    if(index->cell_starts == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    // count the rects in each cell, storing the count for cell i at i + 1
+    size_t total = 0;
+    for(size_t i = 0; i < raster->count; i++) {
+        pixel_rect_t rect = raster->rects[i];
+        for(
+            size_t band = rect.top / band_height;
+            band <= rect.bottom / band_height;
+            band++
+        ) {
+            for(
+                size_t column = rect.left / column_width;
+                column <= rect.right / column_width;
+                column++
+            ) {
+                index->cell_starts[band * index->column_count + column + 1]++;
+                total++;
+            }
         }
-        if(spiral.co_ord_cache.co_ords.items[i].y > max_y) {
-            max_y = spiral.co_ord_cache.co_ords.items[i].y;
+    }
+    index->cell_rects = sxbp_malloc(total * sizeof(pixel_rect_t));
+    if(index->cell_rects == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    // turn the counts into the index of the end of each cell's rects
+    for(size_t cell = 1; cell <= cell_count; cell++) {
+        index->cell_starts[cell] += index->cell_starts[cell - 1];
+    }
+    // fill each cell from its end back to its start
+    for(size_t i = raster->count; i > 0; i--) {
+        pixel_rect_t rect = raster->rects[i - 1];
+        for(
+            size_t band = rect.top / band_height;
+            band <= rect.bottom / band_height;
+            band++
+        ) {
+            for(
+                size_t column = rect.left / column_width;
+                column <= rect.right / column_width;
+                column++
+            ) {
+                size_t cell = band * index->column_count + column;
+                index->cell_rects[--index->cell_starts[cell + 1]] = (
+                    clip_rect_to_cell(index, rect, band, column)
+                );
+            }
         }
     }
-    // write bounds to struct
-    bounds[0].x = min_x;
-    bounds[0].y = min_y;
-    bounds[1].x = max_x;
-    bounds[1].y = max_y;
+    // shift the starts down, as the first now holds the start of the second
+    for(size_t cell = 0; cell < cell_count; cell++) {
+        index->cell_starts[cell] = index->cell_starts[cell + 1];
+    }
+    index->cell_starts[cell_count] = total;
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private type holding the state of a spiral being rendered to a bitmap in
+ * parallel, one band of rows per job
+ */
+typedef struct parallel_render_t {
+    sxbp_bitmap_t* image;
+    band_index_t bands;
+} parallel_render_t;
+
+/*
+ * private function, job for sxbp_run_parallel_jobs() which draws one band of
+ * rows of the image. Each band covers a separate block of rows of the image, so
+ * the jobs can safely run at the same time as each other.
+ */
+static sxbp_status_t draw_band_job(size_t band_index, void* user_data) {
+    parallel_render_t* render = (parallel_render_t*)user_data;
+    band_index_t* bands = &render->bands;
+    uint32_t first_row = (uint32_t)band_index * bands->band_height;
+    uint32_t rows = render->image->height - first_row;
+    if(rows > bands->band_height) {
+        rows = bands->band_height;
+    }
+    // a view of the band's rows of the image
+    sxbp_bitmap_t band = {
+        .width = render->image->width,
+        .height = rows,
+        .stride = render->image->stride,
+        .pixels = render->image->pixels + (first_row * render->image->stride),
+    };
+    // the index has one column, so each band has just one cell
+    size_t start = bands->cell_starts[band_index];
+    draw_band(
+        &band, first_row, bands->cell_rects + start,
+        bands->cell_starts[band_index + 1] - start
+    );
+    return SXBP_OPERATION_OK;
 }
 
 sxbp_status_t sxbp_render_spiral_raw(
@@ -68,75 +632,496 @@ sxbp_status_t sxbp_render_spiral_raw(
     // preconditional assertions
     assert(image->pixels == NULL);
     assert(spiral.lines != NULL);
-    // create result status struct
-    sxbp_status_t result;
-    // plot co-ords of spiral into it's cache
-    sxbp_cache_spiral_points(&spiral, spiral.size);
-    // get the min and max bounds of the spiral's co-ords
-    sxbp_co_ord_t bounds[2] = {{0, 0}};
-    get_bounds(spiral, bounds);
-    // get the normalisation vector needed to make all values unsigned
-    sxbp_tuple_t normalisation_vector = {
-        .x = -bounds[0].x,
-        .y = -bounds[0].y,
-    };
-    // get co-ords of bottom right corner, as unsigned
-    sxbp_co_ord_t bottom_right = {
-        .x = bounds[1].x + normalisation_vector.x,
-        .y = bounds[1].y + normalisation_vector.y,
-    };
-    // initialise image struct - image dimensions are twice the size + 1
-    image->width = ((bottom_right.x + 1) * 2) + 1;
-    image->height = ((bottom_right.y + 1) * 2) + 1;
-    // allocate dynamic memory to image struct - 2D array of bools
-    image->pixels = malloc(image->width * sizeof(bool*));
+    // render with the default options
+    sxbp_render_options_t options = { .scale = 0, .thickness = 0, };
+    return sxbp_render_spiral_raw_with_options(spiral, options, image);
+}
+
+sxbp_status_t sxbp_render_spiral_raw_with_options(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, sxbp_bitmap_t* image
+) {
+    // preconditional assertions
+    assert(image->pixels == NULL);
+    assert(spiral.lines != NULL);
+    // work out what to draw and how big the image has to be
+    raster_t raster = { 0, 0, NULL, 0, };
+    sxbp_status_t result = build_raster(
+        &spiral, resolve_options(options), false, &raster
+    );
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    image->width = raster.width;
+    image->height = raster.height;
+    // each row is packed 8 pixels to a byte, rounded up to the nearest byte
+    image->stride = ((size_t)image->width + 7) / 8;
+    // allocate dynamic memory to image struct - one block for all the rows
+    image->pixels = sxbp_calloc(image->stride * image->height, sizeof(uint8_t));
     // check for malloc fail
     if(image->pixels == NULL) {
-        result = SXBP_MALLOC_REFUSED;
+        sxbp_free(raster.rects);
+        return SXBP_MALLOC_REFUSED;
+    }
+    // draw the whole image as one band
+    draw_band(image, 0, raster.rects, raster.count);
+    sxbp_free(raster.rects);
+    // status ok
+    result = SXBP_OPERATION_OK;
+    return result;
+}
+
+sxbp_status_t sxbp_render_spiral_raw_in_parallel(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, size_t thread_count,
+    sxbp_bitmap_t* image
+) {
+    // preconditional assertions
+    assert(image->pixels == NULL);
+    assert(spiral.lines != NULL);
+    // work out what to draw and how big the image has to be
+    raster_t raster = { 0, 0, NULL, 0, };
+    sxbp_status_t result = build_raster(
+        &spiral, resolve_options(options), false, &raster
+    );
+    if(result != SXBP_OPERATION_OK) {
         return result;
     }
-    for(size_t i = 0; i < image->width; i++) {
-        image->pixels[i] = calloc(image->height, sizeof(bool));
-        // check for malloc fail
-        if(image->pixels[i] == NULL) {
-            // we need to free() all previous rows
-            for(size_t j = i; j > 0; j--) {
-                free(image->pixels[j]);
+    image->width = raster.width;
+    image->height = raster.height;
+    image->stride = ((size_t)image->width + 7) / 8;
+    image->pixels = sxbp_calloc(image->stride * image->height, sizeof(uint8_t));
+    if(image->pixels == NULL) {
+        sxbp_free(raster.rects);
+        return SXBP_MALLOC_REFUSED;
+    }
+    /*
+     * split the image into a few more bands than there are threads, so that
+     * each thread's bands are interleaved down the image and dense regions of
+     * the spiral are spread between the threads rather than given to just one
+     */
+    size_t band_count = (thread_count > 1) ? thread_count * 4 : 1;
+    if(band_count > image->height) {
+        band_count = image->height;
+    }
+    uint32_t band_height = (uint32_t)(
+        (image->height + band_count - 1) / band_count
+    );
+    parallel_render_t render = { .image = image, };
+    result = bucket_rects(
+        &raster, band_height, raster.width, &render.bands
+    );
+    if(result == SXBP_OPERATION_OK) {
+        result = sxbp_run_parallel_jobs(
+            render.bands.band_count, thread_count, draw_band_job,
+            (void*)&render
+        );
+    }
+    sxbp_free(raster.rects);
+    free_band_index(&render.bands);
+    if(result != SXBP_OPERATION_OK) {
+        sxbp_free(image->pixels);
+        image->pixels = NULL;
+    }
+    return result;
+}
+
+/*
+ * private type for one side of a rect, as met when sweeping across the columns
+ * of one row of a thumbnail (see add_band_coverage()). The rect covers from
+ * the first to the last segment of rows of the band, inclusive.
+ */
+typedef struct rect_edge_t {
+    // the rect's left column, or the column after its right one
+    uint32_t column;
+    // whether this is the left side of the rect (or the right)
+    bool opening;
+    size_t first;
+    size_t last;
+} rect_edge_t;
+
+/*
+ * private type holding what is needed to work out the coverage of each pixel
+ * of a thumbnail, a row of thumbnail pixels at a time. All of the arrays are
+ * allocated big enough for every rect of the raster to be in one row at once.
+ */
+typedef struct thumbnail_sweep_t {
+    // each pixel of the thumbnail covers factor by factor full size pixels
+    uint32_t factor;
+    // the width of the thumbnail
+    uint32_t width;
+    // the number of full size pixels covered within each thumbnail pixel
+    uint64_t* coverage;
+    // the rects overlapping the current row of the thumbnail, by left column
+    pixel_rect_t* active;
+    size_t active_count;
+    // space for merging the rects starting in each row into the active ones
+    pixel_rect_t* merged;
+    /*
+     * the rows at which rects start or end within the current row of the
+     * thumbnail, which split it into segments of rows
+     */
+    uint32_t* rows;
+    size_t segment_count;
+    /*
+     * a segment tree over the segments of rows, storing for each node how many
+     * rects cover all of its rows and how many of its rows are covered at all
+     */
+    uint32_t* counts;
+    uint32_t* covered;
+    // the sides of the active rects which start or end within the current row
+    rect_edge_t* edges;
+    // the sides of the spans of columns which are covered for all of its rows
+    rect_edge_t* spans;
+} thumbnail_sweep_t;
+
+// private function, qsort() comparison for sorting rects by their left column
+static int compare_rects_left(const void* a, const void* b) {
+    uint32_t a_left = ((const pixel_rect_t*)a)->left;
+    uint32_t b_left = ((const pixel_rect_t*)b)->left;
+    return (a_left > b_left) - (a_left < b_left);
+}
+
+// private function, qsort() comparison for sorting rows
+static int compare_rows(const void* a, const void* b) {
+    uint32_t a_row = *(const uint32_t*)a;
+    uint32_t b_row = *(const uint32_t*)b;
+    return (a_row > b_row) - (a_row < b_row);
+}
+
+// private function, qsort() comparison for sorting rect edges by their column
+static int compare_edges(const void* a, const void* b) {
+    uint32_t a_column = ((const rect_edge_t*)a)->column;
+    uint32_t b_column = ((const rect_edge_t*)b)->column;
+    return (a_column > b_column) - (a_column < b_column);
+}
+
+/*
+ * private function, returns the index of the given row in the sorted rows of
+ * the sweep, which it must be one of
+ */
+static size_t find_row(const thumbnail_sweep_t* sweep, uint32_t row) {
+    size_t low = 0;
+    size_t high = sweep->segment_count;
+    while(low < high) {
+        size_t middle = low + (high - low) / 2;
+        if(sweep->rows[middle] < row) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/*
+ * private function, adds delta to the count of rects covering the segments of
+ * rows from first to last inclusive, in the subtree of the sweep's segment tree
+ * at the given node, which spans the segments from low to high inclusive
+ */
+static void update_segments(
+    thumbnail_sweep_t* sweep, size_t node, size_t low, size_t high,
+    size_t first, size_t last, bool add
+) {
+    if((last < low) || (first > high)) {
+        return;
+    }
+    if((first <= low) && (high <= last)) {
+        sweep->counts[node] += add ? 1 : -1;
+    } else {
+        size_t middle = low + (high - low) / 2;
+        update_segments(sweep, (node * 2) + 1, low, middle, first, last, add);
+        update_segments(
+            sweep, (node * 2) + 2, middle + 1, high, first, last, add
+        );
+    }
+    if(sweep->counts[node] > 0) {
+        sweep->covered[node] = sweep->rows[high + 1] - sweep->rows[low];
+    } else if(low == high) {
+        sweep->covered[node] = 0;
+    } else {
+        sweep->covered[node] = (
+            sweep->covered[(node * 2) + 1] + sweep->covered[(node * 2) + 2]
+        );
+    }
+}
+
+/*
+ * private function, adds the coverage of the active rects of the sweep to the
+ * given row of the thumbnail, which spans the full size rows from top to
+ * bottom inclusive. Rects can overlap, such as those of neighbouring lines when
+ * the lines are thicker than they are spaced apart, so the area of their union
+ * is added up rather than that of each one, by sweeping across the columns of
+ * the row and keeping track of how many of its full size rows are covered. No
+ * full size pixel is ever counted twice.
+ *
+ * Most rects (such as those of long vertical lines) cover all of the rows, and
+ * as the active rects are sorted by their left column, these are merged into
+ * spans of covered columns in one pass. Only the edges of the rects which
+ * start or end within the row have to be sorted.
+ */
+static void add_band_coverage(
+    thumbnail_sweep_t* sweep, uint32_t y, uint32_t top, uint32_t bottom
+) {
+    // every row where a rect starts or ends within the band starts a segment
+    size_t row_count = 0;
+    sweep->rows[row_count++] = top;
+    sweep->rows[row_count++] = bottom + 1;
+    for(size_t i = 0; i < sweep->active_count; i++) {
+        if(sweep->active[i].top > top) {
+            sweep->rows[row_count++] = sweep->active[i].top;
+        }
+        if(sweep->active[i].bottom < bottom) {
+            sweep->rows[row_count++] = sweep->active[i].bottom + 1;
+        }
+    }
+    qsort(sweep->rows, row_count, sizeof(uint32_t), compare_rows);
+    size_t unique = 1;
+    for(size_t i = 1; i < row_count; i++) {
+        if(sweep->rows[i] != sweep->rows[unique - 1]) {
+            sweep->rows[unique++] = sweep->rows[i];
+        }
+    }
+    sweep->segment_count = unique - 1;
+    size_t last_segment = sweep->segment_count - 1;
+    memset(sweep->counts, 0, sizeof(uint32_t) * 4 * sweep->segment_count);
+    memset(sweep->covered, 0, sizeof(uint32_t) * 4 * sweep->segment_count);
+    // find the edges of the spans and of the other rects
+    size_t edge_count = 0;
+    size_t span_count = 0;
+    pixel_rect_t span = { 0, top, 0, bottom, };
+    bool open = false;
+    for(size_t i = 0; i < sweep->active_count; i++) {
+        pixel_rect_t rect = sweep->active[i];
+        if((rect.top <= top) && (rect.bottom >= bottom)) {
+            if(open && (rect.left <= span.right)) {
+                if(rect.right > span.right) {
+                    span.right = rect.right;
+                }
+                continue;
             }
-            // now we need to free() the top-level array
-            free(image->pixels);
-            result = SXBP_MALLOC_REFUSED;
-            return result;
+            if(open) {
+                sweep->spans[span_count++] = (rect_edge_t){
+                    span.left, true, 0, last_segment,
+                };
+                sweep->spans[span_count++] = (rect_edge_t){
+                    span.right + 1, false, 0, last_segment,
+                };
+            }
+            span.left = rect.left;
+            span.right = rect.right;
+            open = true;
+        } else {
+            size_t first = find_row(sweep, (rect.top > top) ? rect.top : top);
+            size_t last = find_row(
+                sweep, ((rect.bottom < bottom) ? rect.bottom : bottom) + 1
+            ) - 1;
+            sweep->edges[edge_count++] = (rect_edge_t){
+                rect.left, true, first, last,
+            };
+            sweep->edges[edge_count++] = (rect_edge_t){
+                rect.right + 1, false, first, last,
+            };
         }
     }
-    // set 'current point' co-ordinate
-    sxbp_co_ord_t current = {
-        .x = 0,
-        .y = 0,
-    };
-    // plot the lines of the spiral as points
-    for(size_t i = 0; i < spiral.size; i++) {
-        // get current direction
-        sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[spiral.lines[i].direction];
-        // make as many jumps in this direction as this lines length
-        for(uint32_t j = 0; j < (spiral.lines[i].length * 2U) + 1U; j++) {
-            // get output co-ords
-            sxbp_tuple_item_t x_pos = current.x + (normalisation_vector.x * 2) + 1;
-            sxbp_tuple_item_t y_pos = current.y + (normalisation_vector.y * 2) + 1;
-            // skip the second pixel of the first line
-            if(!((i == 0) && (j == 1))) {
-                // flip the y-axis otherwise they appear vertically mirrored
-                image->pixels[x_pos][image->height - 1 - y_pos] = true;
+    if(open) {
+        sweep->spans[span_count++] = (rect_edge_t){
+            span.left, true, 0, last_segment,
+        };
+        sweep->spans[span_count++] = (rect_edge_t){
+            span.right + 1, false, 0, last_segment,
+        };
+    }
+    // the spans' edges are already in order, so are merged with the others'
+    qsort(sweep->edges, edge_count, sizeof(rect_edge_t), compare_edges);
+    // the rows covered stay the same between one edge and the next
+    uint64_t* coverage = sweep->coverage + ((size_t)y * sweep->width);
+    uint32_t column = 0;
+    size_t next_edge = 0;
+    size_t next_span = 0;
+    while((next_edge < edge_count) || (next_span < span_count)) {
+        rect_edge_t* edges = sweep->edges;
+        rect_edge_t* spans = sweep->spans;
+        rect_edge_t edge = (
+            (next_span == span_count) || (
+                (next_edge < edge_count) &&
+                (edges[next_edge].column < spans[next_span].column)
+            )
+        ) ? edges[next_edge++] : spans[next_span++];
+        uint64_t rows = sweep->covered[0];
+        while((rows > 0) && (column < edge.column)) {
+            uint32_t x = column / sweep->factor;
+            uint32_t next = (x + 1) * sweep->factor;
+            if((next > edge.column) || (next < column)) {
+                next = edge.column;
             }
-            if(j != (spiral.lines[i].length * 2U)) {
-                // if we're not on the last line, advance the marker along
-                current.x += direction.x;
-                current.y += direction.y;
+            coverage[x] += rows * (next - column);
+            column = next;
+        }
+        column = edge.column;
+        update_segments(
+            sweep, 0, 0, last_segment, edge.first, edge.last, edge.opening
+        );
+    }
+}
+
+/*
+ * private function, adds the given rects (which are sorted by their top row)
+ * to the active rects of the sweep, keeping those sorted by their left column
+ */
+static void add_active_rects(
+    thumbnail_sweep_t* sweep, pixel_rect_t* rects, size_t count
+) {
+    qsort(rects, count, sizeof(pixel_rect_t), compare_rects_left);
+    size_t i = 0;
+    size_t j = 0;
+    size_t merged_count = 0;
+    while((i < sweep->active_count) || (j < count)) {
+        if(
+            (j == count) || (
+                (i < sweep->active_count) &&
+                (sweep->active[i].left <= rects[j].left)
+            )
+        ) {
+            sweep->merged[merged_count++] = sweep->active[i++];
+        } else {
+            sweep->merged[merged_count++] = rects[j++];
+        }
+    }
+    pixel_rect_t* active = sweep->active;
+    sweep->active = sweep->merged;
+    sweep->merged = active;
+    sweep->active_count = merged_count;
+}
+
+// private function, frees the memory held by a thumbnail sweep
+static void free_thumbnail_sweep(thumbnail_sweep_t* sweep) {
+    sxbp_free(sweep->coverage);
+    sxbp_free(sweep->active);
+    sxbp_free(sweep->merged);
+    sxbp_free(sweep->rows);
+    sxbp_free(sweep->counts);
+    sxbp_free(sweep->covered);
+    sxbp_free(sweep->edges);
+    sxbp_free(sweep->spans);
+}
+
+sxbp_status_t sxbp_render_spiral_thumbnail(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, uint32_t max_width,
+    uint32_t max_height, sxbp_greyscale_image_t* image
+) {
+    // preconditional assertions
+    assert(image->pixels == NULL);
+    assert(spiral.lines != NULL);
+    assert(max_width != 0);
+    assert(max_height != 0);
+    // work out what would be drawn on the full size image
+    raster_t raster = { 0, 0, NULL, 0, };
+    sxbp_status_t result = build_raster(
+        &spiral, resolve_options(options), true, &raster
+    );
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // shrink by the smallest whole factor which makes the image fit
+    uint32_t factor = (raster.width + max_width - 1) / max_width;
+    uint32_t height_factor = (raster.height + max_height - 1) / max_height;
+    if(height_factor > factor) {
+        factor = height_factor;
+    }
+    image->width = (raster.width + factor - 1) / factor;
+    image->height = (raster.height + factor - 1) / factor;
+    size_t pixel_count = (size_t)image->width * image->height;
+    // there are at most two segments of rows per rect, plus one
+    size_t tree_size = 4 * ((raster.count * 2) + 1);
+    thumbnail_sweep_t sweep = {
+        .factor = factor,
+        .width = image->width,
+        .coverage = sxbp_calloc(pixel_count, sizeof(uint64_t)),
+        .active = sxbp_calloc(sizeof(pixel_rect_t), raster.count),
+        .active_count = 0,
+        .merged = sxbp_calloc(sizeof(pixel_rect_t), raster.count),
+        .rows = sxbp_calloc(sizeof(uint32_t), (raster.count * 2) + 2),
+        .segment_count = 0,
+        .counts = sxbp_calloc(sizeof(uint32_t), tree_size),
+        .covered = sxbp_calloc(sizeof(uint32_t), tree_size),
+        .edges = sxbp_calloc(sizeof(rect_edge_t), raster.count * 2),
+        .spans = sxbp_calloc(sizeof(rect_edge_t), raster.count * 2),
+    };
+    image->pixels = sxbp_malloc(pixel_count);
+    if(
+        (sweep.coverage == NULL) || (sweep.active == NULL) ||
+        (sweep.merged == NULL) || (sweep.rows == NULL) ||
+        (sweep.counts == NULL) || (sweep.covered == NULL) ||
+        (sweep.edges == NULL) || (sweep.spans == NULL) ||
+        (image->pixels == NULL)
+    ) {
+        sxbp_free(raster.rects);
+        free_thumbnail_sweep(&sweep);
+        sxbp_free(image->pixels);
+        image->pixels = NULL;
+        return SXBP_MALLOC_REFUSED;
+    }
+    // sweep down the rows of the thumbnail, as render_bands() does
+    size_t next_rect = 0;
+    for(uint32_t y = 0; y < image->height; y++) {
+        uint32_t top = y * factor;
+        uint32_t bottom = (
+            raster.height - top < factor
+        ) ? raster.height - 1 : top + factor - 1;
+        // drop the rects which finished above this row
+        size_t kept = 0;
+        for(size_t i = 0; i < sweep.active_count; i++) {
+            if(sweep.active[i].bottom >= top) {
+                sweep.active[kept++] = sweep.active[i];
             }
         }
+        sweep.active_count = kept;
+        // pick up the rects which start in this row
+        size_t first_rect = next_rect;
+        while(
+            (next_rect < raster.count) &&
+            (raster.rects[next_rect].top <= bottom)
+        ) {
+            next_rect++;
+        }
+        add_active_rects(
+            &sweep, raster.rects + first_rect, next_rect - first_rect
+        );
+        add_band_coverage(&sweep, y, top, bottom);
     }
-    // status ok
-    result = SXBP_OPERATION_OK;
+    sxbp_free(raster.rects);
+    // convert coverage to shades of grey, fully covered being black
+    uint64_t area = (uint64_t)factor * factor;
+    for(size_t i = 0; i < pixel_count; i++) {
+        image->pixels[i] = (uint8_t)(
+            255 - ((sweep.coverage[i] * 255 + (area / 2)) / area)
+        );
+    }
+    free_thumbnail_sweep(&sweep);
+    return SXBP_OPERATION_OK;
+}
+
+sxbp_status_t sxbp_render_spiral_rows(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, uint32_t band_height,
+    sxbp_status_t(* row_sink)(
+        sxbp_bitmap_t band, uint32_t first_row, uint32_t image_height,
+        void* user_data
+    ),
+    void* user_data
+) {
+    // preconditional assertions
+    assert(spiral.lines != NULL);
+    assert(band_height != 0);
+    assert(row_sink != NULL);
+    // work out what to draw and how big the image has to be
+    raster_t raster = { 0, 0, NULL, 0, };
+    sxbp_status_t result = build_raster(
+        &spiral, resolve_options(options), false, &raster
+    );
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    result = render_bands(&raster, band_height, row_sink, user_data);
+    sxbp_free(raster.rects);
     return result;
 }
 
@@ -151,15 +1136,1106 @@ sxbp_status_t sxbp_render_spiral_image(
     assert(buffer->bytes == NULL);
     assert(image_writer_callback != NULL);
     // create bitmap to render raw image to
-    sxbp_bitmap_t raw_image = {0, 0, NULL};
+    sxbp_bitmap_t raw_image = {0, 0, 0, NULL};
     // render spiral to raw image (and store success/failure)
     sxbp_status_t result = sxbp_render_spiral_raw(spiral, &raw_image);
     // check return status
     if(result != SXBP_OPERATION_OK) {
         return result;
     }
-    // render to buffer using callback (and return its status code)
-    return image_writer_callback(raw_image, buffer);
+    // render to buffer using callback
+    result = image_writer_callback(raw_image, buffer);
+    // the raw image is no longer needed
+    sxbp_free(raw_image.pixels);
+    return result;
+}
+
+sxbp_status_t sxbp_build_tile_index(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, uint32_t tile_size,
+    sxbp_tile_index_t* index
+) {
+    // preconditional assertions
+    assert(spiral.lines != NULL);
+    assert(tile_size != 0);
+    assert(index->bands == NULL);
+    // work out what to draw on the full size image
+    raster_t raster = { 0, 0, NULL, 0, };
+    sxbp_status_t result = build_raster(
+        &spiral, resolve_options(options), false, &raster
+    );
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    index->width = raster.width;
+    index->height = raster.height;
+    index->tile_size = tile_size;
+    // add levels, each half the size of the last, until one fits in a tile
+    index->levels = 1;
+    while(
+        (((raster.width - 1) >> (index->levels - 1)) >= tile_size) ||
+        (((raster.height - 1) >> (index->levels - 1)) >= tile_size)
+    ) {
+        index->levels++;
+    }
+    /*
+     * the rects are sorted into a grid of the full size tiles, which every tile
+     * of every level lines up with, so each tile only looks at the rects which
+     * overlap it
+     */
+    index->bands = sxbp_malloc(sizeof(band_index_t));
+    if(index->bands == NULL) {
+        sxbp_free(raster.rects);
+        return SXBP_MALLOC_REFUSED;
+    }
+    result = bucket_rects(&raster, tile_size, tile_size, index->bands);
+    sxbp_free(raster.rects);
+    if(result != SXBP_OPERATION_OK) {
+        sxbp_free_tile_index(index);
+    }
+    return result;
+}
+
+void sxbp_free_tile_index(sxbp_tile_index_t* index) {
+    if(index->bands != NULL) {
+        free_band_index(index->bands);
+        sxbp_free(index->bands);
+        index->bands = NULL;
+    }
+}
+
+void sxbp_get_tile_grid(
+    const sxbp_tile_index_t* index, uint32_t level, uint32_t* columns,
+    uint32_t* rows
+) {
+    // preconditional assertions
+    assert(level < index->levels);
+    // the size of the whole image at this level, rounded up
+    uint64_t width = ((uint64_t)index->width + (1ULL << level) - 1) >> level;
+    uint64_t height = ((uint64_t)index->height + (1ULL << level) - 1) >> level;
+    *columns = (uint32_t)((width + index->tile_size - 1) / index->tile_size);
+    *rows = (uint32_t)((height + index->tile_size - 1) / index->tile_size);
+}
+
+/*
+ * private function, draws the given rect onto a tile at the given level, shrunk
+ * by a factor of 2 to the power of level, where the tile starts at the given
+ * column and row of the image at that level. Pixels of the tile which any part
+ * of the rect falls within are set to black.
+ */
+static void draw_tile_rect(
+    sxbp_bitmap_t* tile, pixel_rect_t rect, uint32_t level, uint64_t left,
+    uint64_t top
+) {
+    uint64_t right = left + tile->width - 1;
+    uint64_t bottom = top + tile->height - 1;
+    uint64_t rect_left = rect.left >> level;
+    uint64_t rect_right = rect.right >> level;
+    uint64_t rect_top = rect.top >> level;
+    uint64_t rect_bottom = rect.bottom >> level;
+    // skip rects which miss the tile
+    if(
+        (rect_right < left) || (rect_left > right) ||
+        (rect_bottom < top) || (rect_top > bottom)
+    ) {
+        return;
+    }
+    fill_rows(
+        tile,
+        (uint32_t)(((rect_left > left) ? rect_left : left) - left),
+        (uint32_t)(((rect_right < right) ? rect_right : right) - left),
+        (uint32_t)(((rect_top > top) ? rect_top : top) - top),
+        (uint32_t)(((rect_bottom < bottom) ? rect_bottom : bottom) - top)
+    );
+}
+
+/*
+ * private function, renders the tile at the given level, column and row to the
+ * given bitmap, which must be freed by the caller
+ */
+static sxbp_status_t render_tile_bitmap(
+    const sxbp_tile_index_t* index, uint32_t level, uint32_t column,
+    uint32_t row, sxbp_bitmap_t* tile
+) {
+    uint32_t columns = 0;
+    uint32_t rows = 0;
+    sxbp_get_tile_grid(index, level, &columns, &rows);
+    if((column >= columns) || (row >= rows)) {
+        return SXBP_OPERATION_FAIL;
+    }
+    uint64_t width = ((uint64_t)index->width + (1ULL << level) - 1) >> level;
+    uint64_t height = ((uint64_t)index->height + (1ULL << level) - 1) >> level;
+    uint64_t left = (uint64_t)column * index->tile_size;
+    uint64_t top = (uint64_t)row * index->tile_size;
+    // tiles at the right and bottom edges are cut short
+    tile->width = (uint32_t)(
+        (width - left < index->tile_size) ? width - left : index->tile_size
+    );
+    tile->height = (uint32_t)(
+        (height - top < index->tile_size) ? height - top : index->tile_size
+    );
+    tile->stride = ((size_t)tile->width + 7) / 8;
+    tile->pixels = sxbp_calloc(tile->stride * tile->height, sizeof(uint8_t));
+    if(tile->pixels == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    // the cells of the full size image which this tile's pixels come from
+    band_index_t* bands = index->bands;
+    size_t first_band = (size_t)(top << level) / bands->band_height;
+    size_t last_band = (size_t)(
+        ((top + tile->height) << level) - 1
+    ) / bands->band_height;
+    if(last_band >= bands->band_count) {
+        last_band = bands->band_count - 1;
+    }
+    size_t first_column = (size_t)(left << level) / bands->column_width;
+    size_t last_column = (size_t)(
+        ((left + tile->width) << level) - 1
+    ) / bands->column_width;
+    if(last_column >= bands->column_count) {
+        last_column = bands->column_count - 1;
+    }
+    for(size_t band = first_band; band <= last_band; band++) {
+        size_t row_start = band * bands->column_count;
+        for(
+            size_t i = bands->cell_starts[row_start + first_column];
+            i < bands->cell_starts[row_start + last_column + 1];
+            i++
+        ) {
+            draw_tile_rect(tile, bands->cell_rects[i], level, left, top);
+        }
+    }
+    return SXBP_OPERATION_OK;
+}
+
+sxbp_status_t sxbp_render_tile(
+    const sxbp_tile_index_t* index, uint32_t level, uint32_t column,
+    uint32_t row, sxbp_buffer_t* buffer,
+    sxbp_status_t(* image_writer_callback)(
+        sxbp_bitmap_t image, sxbp_buffer_t* buffer
+    )
+) {
+    // preconditional assertions
+    assert(index->bands != NULL);
+    assert(buffer->bytes == NULL);
+    assert(image_writer_callback != NULL);
+    if(level >= index->levels) {
+        return SXBP_OPERATION_FAIL;
+    }
+    sxbp_bitmap_t tile = { 0, 0, 0, NULL, };
+    sxbp_status_t result = render_tile_bitmap(
+        index, level, column, row, &tile
+    );
+    if(result == SXBP_OPERATION_OK) {
+        result = image_writer_callback(tile, buffer);
+    }
+    sxbp_free(tile.pixels);
+    return result;
+}
+
+sxbp_status_t sxbp_render_tile_pyramid(
+    const sxbp_tile_index_t* index,
+    sxbp_status_t(* image_writer_callback)(
+        sxbp_bitmap_t image, sxbp_buffer_t* buffer
+    ),
+    sxbp_status_t(* tile_sink)(
+        uint32_t level, uint32_t column, uint32_t row, sxbp_buffer_t tile,
+        void* user_data
+    ),
+    void* user_data
+) {
+    // preconditional assertions
+    assert(index->bands != NULL);
+    assert(image_writer_callback != NULL);
+    assert(tile_sink != NULL);
+    for(uint32_t level = 0; level < index->levels; level++) {
+        uint32_t columns = 0;
+        uint32_t rows = 0;
+        sxbp_get_tile_grid(index, level, &columns, &rows);
+        for(uint32_t row = 0; row < rows; row++) {
+            for(uint32_t column = 0; column < columns; column++) {
+                sxbp_buffer_t tile = { .bytes = NULL, .size = 0, };
+                sxbp_status_t result = sxbp_render_tile(
+                    index, level, column, row, &tile, image_writer_callback
+                );
+                if(result == SXBP_OPERATION_OK) {
+                    result = tile_sink(level, column, row, tile, user_data);
+                }
+                sxbp_free(tile.bytes);
+                if(result != SXBP_OPERATION_OK) {
+                    return result;
+                }
+            }
+        }
+    }
+    return SXBP_OPERATION_OK;
+}
+
+// private function, returns whether two lines are the same
+static bool same_line(sxbp_line_t a, sxbp_line_t b) {
+    return (a.length == b.length) && (a.direction == b.direction);
+}
+
+/*
+ * private function, widens the rect pointed to by area to cover rect as well,
+ * or sets it to rect if it doesn't cover anything yet (as given by covered)
+ */
+static void merge_rects(pixel_rect_t* area, bool* covered, pixel_rect_t rect) {
+    if(!*covered) {
+        *area = rect;
+        *covered = true;
+        return;
+    }
+    area->left = (rect.left < area->left) ? rect.left : area->left;
+    area->top = (rect.top < area->top) ? rect.top : area->top;
+    area->right = (rect.right > area->right) ? rect.right : area->right;
+    area->bottom = (rect.bottom > area->bottom) ? rect.bottom : area->bottom;
+}
+
+/*
+ * private function, adds the rects of the given lines, from line first up to
+ * (but not including) line end and starting at co-ord start, to the area
+ */
+static void merge_line_rects(
+    const sxbp_line_t* lines, sxbp_line_count_t first, sxbp_line_count_t end,
+    sxbp_co_ord_t start, sxbp_co_ord_t* bounds, sxbp_render_options_t options,
+    pixel_rect_t* area, bool* covered
+) {
+    pixel_rect_t rects[2];
+    for(sxbp_line_count_t i = first; i < end; i++) {
+        size_t count = get_line_rects(
+            lines[i], i, &start, bounds, options, false, rects
+        );
+        for(size_t j = 0; j < count; j++) {
+            merge_rects(area, covered, rects[j]);
+        }
+    }
+}
+
+/*
+ * private function, makes a new canvas for a live render with room to spare
+ * around the given bounds - half the spiral's larger side again each way -
+ * storing it in image and the smallest and largest co-ords it has room for in
+ * canvas_bounds. Returns SXBP_SIZE_OVERFLOW if the canvas would be too big.
+ */
+static sxbp_status_t make_live_canvas(
+    sxbp_co_ord_t* bounds, sxbp_render_options_t options, sxbp_bitmap_t* image,
+    sxbp_co_ord_t* canvas_bounds
+) {
+    uint64_t width = (uint64_t)bounds[1].x - (uint64_t)bounds[0].x;
+    uint64_t height = (uint64_t)bounds[1].y - (uint64_t)bounds[0].y;
+    uint64_t margin = ((width > height) ? width : height) / 2 + 8;
+    // the canvas's bounds have to fit in co-ords too
+    if(
+        (margin > (uint64_t)SXBP_TUPLE_ITEM_MAX) ||
+        ((uint64_t)bounds[0].x - (uint64_t)SXBP_TUPLE_ITEM_MIN < margin) ||
+        ((uint64_t)bounds[0].y - (uint64_t)SXBP_TUPLE_ITEM_MIN < margin) ||
+        ((uint64_t)SXBP_TUPLE_ITEM_MAX - (uint64_t)bounds[1].x < margin) ||
+        ((uint64_t)SXBP_TUPLE_ITEM_MAX - (uint64_t)bounds[1].y < margin)
+    ) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    canvas_bounds[0] = (sxbp_co_ord_t){
+        bounds[0].x - (sxbp_tuple_item_t)margin,
+        bounds[0].y - (sxbp_tuple_item_t)margin,
+    };
+    canvas_bounds[1] = (sxbp_co_ord_t){
+        bounds[1].x + (sxbp_tuple_item_t)margin,
+        bounds[1].y + (sxbp_tuple_item_t)margin,
+    };
+    sxbp_status_t result = get_image_size(
+        canvas_bounds[0].x, canvas_bounds[1].x, options, &image->width
+    );
+    if(result == SXBP_OPERATION_OK) {
+        result = get_image_size(
+            canvas_bounds[0].y, canvas_bounds[1].y, options, &image->height
+        );
+    }
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    image->stride = ((size_t)image->width + 7) / 8;
+    image->pixels = sxbp_calloc(image->stride * image->height, sizeof(uint8_t));
+    if(image->pixels == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    return SXBP_OPERATION_OK;
+}
+
+// the number of rows of the canvas in each band of a live render's index
+#define LIVE_BAND_HEIGHT 64U
+// the number of lines compared at a time when looking for changed lines
+#define LIVE_COMPARE_LINES 256U
+
+// private type holding what is known about a line drawn on a live render
+typedef struct live_line_t {
+    // the co-ord the line ends at
+    sxbp_co_ord_t end;
+    // the smallest and largest co-ords of this line and all those before it
+    sxbp_co_ord_t bounds[2];
+    // the total length of this line and all those before it
+    uint64_t length;
+} live_line_t;
+
+// private type holding the part of a line's rect which falls within a band
+typedef struct live_rect_t {
+    pixel_rect_t rect;
+    sxbp_line_count_t line;
+} live_rect_t;
+
+/*
+ * private type holding the parts of the rects of the lines which cross a band
+ * of rows of a live render's canvas, in the order of the lines they belong to
+ */
+typedef struct live_band_t {
+    live_rect_t* rects;
+    size_t count;
+    size_t capacity;
+} live_band_t;
+
+/*
+ * private type holding what a live render keeps between updates, so that each
+ * update only has to look at the lines which have changed and the parts of the
+ * canvas they cover
+ */
+typedef struct sxbp_live_index_t {
+    // how many lines there is room for in drawn and in the live render's lines
+    size_t capacity;
+    live_line_t* drawn;
+    // the canvas cut into bands of LIVE_BAND_HEIGHT rows
+    size_t band_count;
+    live_band_t* bands;
+} live_index_t;
+
+// private function, frees the given bands of a live render's index
+static void free_live_bands(live_band_t* bands, size_t band_count) {
+    if(bands == NULL) {
+        return;
+    }
+    for(size_t i = 0; i < band_count; i++) {
+        sxbp_free(bands[i].rects);
+    }
+    sxbp_free(bands);
+}
+
+/*
+ * private function, makes sure there is room for count lines in the live
+ * render's lines and its index, making the index if it hasn't been already.
+ * Anything already stored is kept, so the live render is still usable if this
+ * fails.
+ */
+static sxbp_status_t reserve_live_lines(
+    sxbp_live_render_t* live, sxbp_line_count_t count
+) {
+    if(live->index == NULL) {
+        live->index = sxbp_calloc(1, sizeof(live_index_t));
+        if(live->index == NULL) {
+            return SXBP_MALLOC_REFUSED;
+        }
+    }
+    live_index_t* index = live->index;
+    if(count <= index->capacity) {
+        return SXBP_OPERATION_OK;
+    }
+    // grow by at least double, so lines added one at a time are cheap
+    size_t capacity = (size_t)index->capacity * 2;
+    if(capacity < count) {
+        capacity = count;
+    }
+    if(capacity > SIZE_MAX / sizeof(live_line_t)) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    sxbp_line_t* lines = sxbp_realloc(
+        live->lines, sizeof(sxbp_line_t) * capacity
+    );
+    if(lines == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    live->lines = lines;
+    live_line_t* drawn = sxbp_realloc(
+        index->drawn, sizeof(live_line_t) * capacity
+    );
+    if(drawn == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    index->drawn = drawn;
+    index->capacity = capacity;
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, works out where each of the given lines from line first up
+ * to (but not including) line end ends, and the bounds and total length of the
+ * lines up to there, carrying on from previous, which is what is known about
+ * the line before first. These are stored in drawn (from index first on) if it
+ * isn't NULL, and those of the last line are returned. If the total length
+ * grows larger than the largest co-ord, it is returned as soon as it does,
+ * before any co-ords can overflow.
+ */
+static live_line_t follow_live_lines(
+    const sxbp_line_t* lines, sxbp_line_count_t first, sxbp_line_count_t end,
+    live_line_t previous, live_line_t* drawn
+) {
+    for(sxbp_line_count_t i = first; i < end; i++) {
+        previous.length += lines[i].length;
+        if(previous.length > (uint64_t)SXBP_TUPLE_ITEM_MAX) {
+            return previous;
+        }
+        sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[lines[i].direction];
+        sxbp_co_ord_t* at = &previous.end;
+        sxbp_co_ord_t* bounds = previous.bounds;
+        at->x += direction.x * (sxbp_tuple_item_t)lines[i].length;
+        at->y += direction.y * (sxbp_tuple_item_t)lines[i].length;
+        bounds[0].x = (at->x < bounds[0].x) ? at->x : bounds[0].x;
+        bounds[0].y = (at->y < bounds[0].y) ? at->y : bounds[0].y;
+        bounds[1].x = (at->x > bounds[1].x) ? at->x : bounds[1].x;
+        bounds[1].y = (at->y > bounds[1].y) ? at->y : bounds[1].y;
+        if(drawn != NULL) {
+            drawn[i] = previous;
+        }
+    }
+    return previous;
+}
+
+/*
+ * private function, counts how many parts the rects of the given lines from
+ * line first up to (but not including) line end, starting at co-ord start, are
+ * cut into by the bands they cross, adding the count for each band to added,
+ * which starts at band first_band
+ */
+static void count_live_rects(
+    const sxbp_line_t* lines, sxbp_line_count_t first, sxbp_line_count_t end,
+    sxbp_co_ord_t start, sxbp_co_ord_t* canvas_bounds,
+    sxbp_render_options_t options, size_t first_band, size_t* added
+) {
+    pixel_rect_t rects[2];
+    for(sxbp_line_count_t i = first; i < end; i++) {
+        size_t count = get_line_rects(
+            lines[i], i, &start, canvas_bounds, options, false, rects
+        );
+        for(size_t j = 0; j < count; j++) {
+            for(
+                size_t band = rects[j].top / LIVE_BAND_HEIGHT;
+                band <= rects[j].bottom / LIVE_BAND_HEIGHT;
+                band++
+            ) {
+                added[band - first_band]++;
+            }
+        }
+    }
+}
+
+/*
+ * private function, makes sure there is room in each of the bands from band
+ * first_band to band last_band inclusive for as many more rects as added holds
+ * for it. Anything already stored is kept, so the bands are still usable if
+ * this fails.
+ */
+static sxbp_status_t reserve_live_rects(
+    live_band_t* bands, size_t first_band, size_t last_band,
+    const size_t* added
+) {
+    for(size_t band = first_band; band <= last_band; band++) {
+        live_band_t* rects = &bands[band];
+        size_t needed = rects->count + added[band - first_band];
+        if(needed <= rects->capacity) {
+            continue;
+        }
+        // grow by at least double, so lines added one at a time are cheap
+        size_t capacity = rects->capacity * 2;
+        if(capacity < needed) {
+            capacity = needed;
+        }
+        if(capacity > SIZE_MAX / sizeof(live_rect_t)) {
+            return SXBP_SIZE_OVERFLOW;
+        }
+        live_rect_t* grown = sxbp_realloc(
+            rects->rects, sizeof(live_rect_t) * capacity
+        );
+        if(grown == NULL) {
+            return SXBP_MALLOC_REFUSED;
+        }
+        rects->rects = grown;
+        rects->capacity = capacity;
+    }
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, adds the rects of the given lines from line first up to
+ * (but not including) line end, starting at co-ord start, to the bands they
+ * cross, cut into the part of them which falls within each band. There must
+ * already be room for them (see reserve_live_rects()).
+ */
+static void add_live_rects(
+    const sxbp_line_t* lines, sxbp_line_count_t first, sxbp_line_count_t end,
+    sxbp_co_ord_t start, sxbp_co_ord_t* canvas_bounds,
+    sxbp_render_options_t options, live_band_t* bands
+) {
+    pixel_rect_t rects[2];
+    for(sxbp_line_count_t i = first; i < end; i++) {
+        size_t count = get_line_rects(
+            lines[i], i, &start, canvas_bounds, options, false, rects
+        );
+        for(size_t j = 0; j < count; j++) {
+            for(
+                size_t band = rects[j].top / LIVE_BAND_HEIGHT;
+                band <= rects[j].bottom / LIVE_BAND_HEIGHT;
+                band++
+            ) {
+                uint32_t top = (uint32_t)band * LIVE_BAND_HEIGHT;
+                uint32_t bottom = top + (LIVE_BAND_HEIGHT - 1);
+                pixel_rect_t part = rects[j];
+                part.top = (part.top > top) ? part.top : top;
+                part.bottom = (part.bottom < bottom) ? part.bottom : bottom;
+                bands[band].rects[bands[band].count++] = (live_rect_t){
+                    part, i,
+                };
+            }
+        }
+    }
+}
+
+/*
+ * private function, draws the parts of the rects in the bands from band
+ * first_band to band last_band inclusive which fall within the given area of
+ * the image
+ */
+static void draw_live_rects(
+    sxbp_bitmap_t* image, const live_band_t* bands, size_t first_band,
+    size_t last_band, pixel_rect_t area
+) {
+    for(size_t band = first_band; band <= last_band; band++) {
+        for(size_t i = 0; i < bands[band].count; i++) {
+            pixel_rect_t clip = bands[band].rects[i].rect;
+            clip.left = (clip.left > area.left) ? clip.left : area.left;
+            clip.top = (clip.top > area.top) ? clip.top : area.top;
+            clip.right = (clip.right < area.right) ? clip.right : area.right;
+            clip.bottom = (
+                clip.bottom < area.bottom
+            ) ? clip.bottom : area.bottom;
+            if((clip.left <= clip.right) && (clip.top <= clip.bottom)) {
+                fill_rows(image, clip.left, clip.right, clip.top, clip.bottom);
+            }
+        }
+    }
+}
+
+/*
+ * private function, draws the first count lines of the spiral on a new canvas
+ * with room to spare around the given bounds. The old canvas and its bands are
+ * only replaced once the new ones have been made, so the live render is left
+ * as it was if this fails.
+ */
+static sxbp_status_t redraw_live_canvas(
+    const sxbp_spiral_t* spiral, sxbp_line_count_t count, sxbp_co_ord_t* bounds,
+    sxbp_render_options_t options, sxbp_live_render_t* live
+) {
+    sxbp_bitmap_t image = { .pixels = NULL, };
+    sxbp_co_ord_t canvas_bounds[2];
+    sxbp_status_t result = make_live_canvas(
+        bounds, options, &image, canvas_bounds
+    );
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    size_t band_count = (
+        ((size_t)image.height + LIVE_BAND_HEIGHT - 1) / LIVE_BAND_HEIGHT
+    );
+    live_band_t* bands = sxbp_calloc(band_count, sizeof(live_band_t));
+    size_t* added = sxbp_calloc(band_count, sizeof(size_t));
+    if((bands == NULL) || (added == NULL)) {
+        result = SXBP_MALLOC_REFUSED;
+    } else {
+        sxbp_co_ord_t start = { 0, 0, };
+        count_live_rects(
+            spiral->lines, 0, count, start, canvas_bounds, options, 0, added
+        );
+        result = reserve_live_rects(bands, 0, band_count - 1, added);
+        if(result == SXBP_OPERATION_OK) {
+            add_live_rects(
+                spiral->lines, 0, count, start, canvas_bounds, options, bands
+            );
+        }
+    }
+    sxbp_free(added);
+    if(result != SXBP_OPERATION_OK) {
+        free_live_bands(bands, band_count);
+        sxbp_free(image.pixels);
+        return result;
+    }
+    pixel_rect_t area = { 0, 0, image.width - 1, image.height - 1, };
+    draw_live_rects(&image, bands, 0, band_count - 1, area);
+    // swap the new canvas in for the old one
+    free_live_bands(live->index->bands, live->index->band_count);
+    sxbp_free(live->image.pixels);
+    live->index->bands = bands;
+    live->index->band_count = band_count;
+    live->image = image;
+    live->canvas_bounds[0] = canvas_bounds[0];
+    live->canvas_bounds[1] = canvas_bounds[1];
+    live->dirty = (sxbp_bitmap_region_t){ 0, 0, image.width, image.height, };
+    live->resized = true;
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, erases the lines of the live render from line first on and
+ * draws the lines of the spiral from there up to line count in their place,
+ * where line first starts at co-ord start. Only the parts of the other lines
+ * which cross the area that this changes are redrawn. Room is made for the new
+ * lines before anything is erased, so the live render is left as it was if
+ * this fails.
+ */
+static sxbp_status_t redraw_live_lines(
+    const sxbp_spiral_t* spiral, sxbp_line_count_t first,
+    sxbp_line_count_t count, sxbp_co_ord_t start,
+    sxbp_render_options_t options, sxbp_live_render_t* live
+) {
+    // the changed lines cover where they were and where they are now
+    sxbp_co_ord_t* canvas_bounds = live->canvas_bounds;
+    pixel_rect_t dirty = { 0, 0, 0, 0, };
+    bool covered = false;
+    merge_line_rects(
+        live->lines, first, live->line_count, start, canvas_bounds, options,
+        &dirty, &covered
+    );
+    merge_line_rects(
+        spiral->lines, first, count, start, canvas_bounds, options, &dirty,
+        &covered
+    );
+    if(!covered) {
+        return SXBP_OPERATION_OK;
+    }
+    live_band_t* bands = live->index->bands;
+    size_t first_band = dirty.top / LIVE_BAND_HEIGHT;
+    size_t last_band = dirty.bottom / LIVE_BAND_HEIGHT;
+    size_t* added = sxbp_calloc(last_band - first_band + 1, sizeof(size_t));
+    if(added == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    count_live_rects(
+        spiral->lines, first, count, start, canvas_bounds, options, first_band,
+        added
+    );
+    sxbp_status_t result = reserve_live_rects(
+        bands, first_band, last_band, added
+    );
+    sxbp_free(added);
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // the rects of the old lines are the last in each band that they cross
+    for(size_t band = first_band; band <= last_band; band++) {
+        while(
+            (bands[band].count > 0) &&
+            (bands[band].rects[bands[band].count - 1].line >= first)
+        ) {
+            bands[band].count--;
+        }
+    }
+    add_live_rects(
+        spiral->lines, first, count, start, canvas_bounds, options, bands
+    );
+    /*
+     * redraw everything within the dirty area - the lines which haven't
+     * changed may have been partly erased along with those that have
+     */
+    clear_rows(&live->image, dirty.left, dirty.right, dirty.top, dirty.bottom);
+    draw_live_rects(&live->image, bands, first_band, last_band, dirty);
+    live->dirty = (sxbp_bitmap_region_t){
+        dirty.left, dirty.top, dirty.right - dirty.left + 1,
+        dirty.bottom - dirty.top + 1,
+    };
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, returns the index of the first of the given lines which is
+ * not the same as the line drawn at that index, or count if they all are.
+ * Blocks of lines which are the same bit for bit are skipped over with
+ * memcmp(), which is much quicker than comparing the lines one at a time.
+ */
+static sxbp_line_count_t find_changed_line(
+    const sxbp_line_t* lines, const sxbp_line_t* drawn, sxbp_line_count_t count
+) {
+    sxbp_line_count_t start = 0;
+    while(start < count) {
+        sxbp_line_count_t block = (
+            count - start < LIVE_COMPARE_LINES
+        ) ? count - start : LIVE_COMPARE_LINES;
+        if(
+            memcmp(
+                lines + start, drawn + start, sizeof(sxbp_line_t) * block
+            ) != 0
+        ) {
+            // the bits of a line can differ without the line itself differing
+            for(sxbp_line_count_t i = start; i < start + block; i++) {
+                if(!same_line(lines[i], drawn[i])) {
+                    return i;
+                }
+            }
+        }
+        start += block;
+    }
+    return count;
+}
+
+sxbp_live_render_t sxbp_blank_live_render(sxbp_render_options_t options) {
+    return (sxbp_live_render_t){
+        .options = options, .image = { .pixels = NULL, }, .lines = NULL,
+        .index = NULL,
+    };
+}
+
+sxbp_status_t sxbp_update_live_render(
+    const sxbp_spiral_t* spiral, sxbp_live_render_t* live
+) {
+    // preconditional assertions
+    assert(spiral->lines != NULL);
+    sxbp_render_options_t options = resolve_options(live->options);
+    sxbp_line_count_t count = (
+        spiral->solved_count < spiral->size
+    ) ? spiral->solved_count : spiral->size;
+    live->dirty = (sxbp_bitmap_region_t){ 0, 0, 0, 0, };
+    live->resized = false;
+    // find the first line which has changed since the last update
+    sxbp_line_count_t unchanged = find_changed_line(
+        spiral->lines, live->lines,
+        (count < live->line_count) ? count : live->line_count
+    );
+    if(
+        (live->image.pixels != NULL) && (unchanged == count) &&
+        (count == live->line_count)
+    ) {
+        return SXBP_OPERATION_OK;
+    }
+    // the lines before the first changed one are where they were last time
+    sxbp_status_t result = reserve_live_lines(live, count);
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    live_index_t* index = live->index;
+    live_line_t previous = { { 0, 0, }, { { 0, 0, }, { 0, 0, }, }, 0, };
+    if(unchanged > 0) {
+        previous = index->drawn[unchanged - 1];
+    }
+    live_line_t last = follow_live_lines(
+        spiral->lines, unchanged, count, previous, NULL
+    );
+    if(last.length > (uint64_t)SXBP_TUPLE_ITEM_MAX) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    sxbp_co_ord_t* bounds = last.bounds;
+    sxbp_co_ord_t* canvas_bounds = live->canvas_bounds;
+    if(
+        (live->image.pixels == NULL) ||
+        (bounds[0].x < canvas_bounds[0].x) ||
+        (bounds[0].y < canvas_bounds[0].y) ||
+        (bounds[1].x > canvas_bounds[1].x) ||
+        (bounds[1].y > canvas_bounds[1].y)
+    ) {
+        // the spiral has outgrown the canvas, so draw it all on a new one
+        result = redraw_live_canvas(spiral, count, bounds, options, live);
+    } else {
+        result = redraw_live_lines(
+            spiral, unchanged, count, previous.end, options, live
+        );
+    }
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // keep the changed lines and where they are, to compare with next time
+    follow_live_lines(spiral->lines, unchanged, count, previous, index->drawn);
+    if(count > unchanged) {
+        memcpy(
+            live->lines + unchanged, spiral->lines + unchanged,
+            sizeof(sxbp_line_t) * (count - unchanged)
+        );
+    }
+    live->line_count = count;
+    // the spiral sits within the canvas as it would in a bitmap of its own
+    live->content = (sxbp_bitmap_region_t){
+        ((uint32_t)bounds[0].x - (uint32_t)canvas_bounds[0].x) * options.scale,
+        ((uint32_t)canvas_bounds[1].y - (uint32_t)bounds[1].y) * options.scale,
+        ((uint32_t)bounds[1].x - (uint32_t)bounds[0].x) * options.scale +
+        options.thickness * 3U,
+        ((uint32_t)bounds[1].y - (uint32_t)bounds[0].y) * options.scale +
+        options.thickness * 3U,
+    };
+    return SXBP_OPERATION_OK;
+}
+
+void sxbp_free_live_render(sxbp_live_render_t* live) {
+    sxbp_free(live->image.pixels);
+    sxbp_free(live->lines);
+    if(live->index != NULL) {
+        free_live_bands(live->index->bands, live->index->band_count);
+        sxbp_free(live->index->drawn);
+        sxbp_free(live->index);
+    }
+    *live = sxbp_blank_live_render(live->options);
+}
+
+/*
+ * private type holding the state of a spiral being plotted with a live render
+ * kept up to date alongside it
+ */
+typedef struct live_plot_t {
+    sxbp_live_render_t* live;
+    void(* progress_callback)(
+        sxbp_spiral_t* spiral, const sxbp_live_render_t* live,
+        sxbp_line_count_t latest_line, sxbp_line_count_t target_line,
+        void* user_data
+    );
+    void* user_data;
+    // the status of the first update of the live render to fail, if any
+    sxbp_status_t result;
+} live_plot_t;
+
+/*
+ * private progress callback for sxbp_plot_spiral(), which updates the live
+ * render of the live_plot_t given as user_data and passes it on to its callback
+ */
+static void update_live_plot(
+    sxbp_spiral_t* spiral, sxbp_line_count_t latest_line,
+    sxbp_line_count_t target_line, void* user_data
+) {
+    live_plot_t* plot = (live_plot_t*)user_data;
+    if(plot->result != SXBP_OPERATION_OK) {
+        return;
+    }
+    plot->result = sxbp_update_live_render(spiral, plot->live);
+    if(
+        (plot->result == SXBP_OPERATION_OK) &&
+        (plot->progress_callback != NULL)
+    ) {
+        plot->progress_callback(
+            spiral, plot->live, latest_line, target_line, plot->user_data
+        );
+    }
+}
+
+sxbp_status_t sxbp_plot_spiral_live(
+    sxbp_spiral_t* spiral, sxbp_length_t perfection_threshold,
+    sxbp_line_count_t max_line, sxbp_live_render_t* live,
+    void(* progress_callback)(
+        sxbp_spiral_t* spiral, const sxbp_live_render_t* live,
+        sxbp_line_count_t latest_line, sxbp_line_count_t target_line,
+        void* user_data
+    ),
+    void* user_data
+) {
+    // preconditional assertions
+    assert(spiral->lines != NULL);
+    // start off with whatever has been solved already
+    live_plot_t plot = {
+        live, progress_callback, user_data,
+        sxbp_update_live_render(spiral, live),
+    };
+    if(plot.result != SXBP_OPERATION_OK) {
+        return plot.result;
+    }
+    sxbp_status_t result = sxbp_plot_spiral(
+        spiral, perfection_threshold, max_line, update_live_plot, &plot
+    );
+    return (result == SXBP_OPERATION_OK) ? plot.result : result;
+}
+
+/*
+ * private function, copies the given rows of the bytes from first_byte to
+ * last_byte inclusive of each row of image from source, where pixel (0, 0) of
+ * image is pixel (x, y) of source. The bits of each byte are taken from the
+ * two bytes of source they straddle, so no pixel is copied on its own. Pixels
+ * of source past the end of its rows are taken to be white.
+ *
+ * Asserts:
+ * - That source.pixels is not NULL
+ * - That image->pixels is not NULL
+ */
+static void crop_bitmap_rows(
+    sxbp_bitmap_t source, uint32_t x, uint32_t y, sxbp_bitmap_t* image,
+    size_t first_byte, size_t last_byte, uint32_t top, uint32_t bottom
+) {
+    // preconditional assertions
+    assert(source.pixels != NULL);
+    assert(image->pixels != NULL);
+    uint8_t shift = x % 8;
+    // the number of bytes of each row of source from the one pixel x is in
+    size_t available = source.stride - (x / 8);
+    for(uint32_t row = top; row <= bottom; row++) {
+        const uint8_t* from = (
+            source.pixels + ((size_t)(row + y) * source.stride) + (x / 8)
+        );
+        uint8_t* to = image->pixels + ((size_t)row * image->stride);
+        for(size_t i = first_byte; i <= last_byte; i++) {
+            uint16_t bits = (uint16_t)(from[i] << 8);
+            if(i + 1 < available) {
+                bits |= from[i + 1];
+            }
+            to[i] = (uint8_t)(bits >> (8 - shift));
+        }
+    }
+}
+
+/*
+ * private type holding the state of a spiral being plotted into a sequence of
+ * animation frames
+ */
+typedef struct animation_t {
+    sxbp_live_render_t live;
+    sxbp_animation_frame_t frame;
+    // the region of the live render's canvas the last frame was taken from
+    sxbp_bitmap_region_t content;
+    uint32_t lines_per_frame;
+    uint32_t lines_since_frame;
+    sxbp_status_t(* frame_callback)(
+        const sxbp_animation_frame_t* frame, void* user_data
+    );
+    void* user_data;
+    // the status of the first frame to fail, if any
+    sxbp_status_t result;
+} animation_t;
+
+/*
+ * private function, brings the live render of the animation up to date with
+ * the spiral and builds the next frame from it. Only the part of the frame
+ * which the live render reports as having changed is copied across, unless
+ * the spiral has moved or changed size within the canvas, in which case all
+ * of it is.
+ */
+static sxbp_status_t build_animation_frame(
+    const sxbp_spiral_t* spiral, animation_t* animation
+) {
+    sxbp_status_t result = sxbp_update_live_render(spiral, &animation->live);
+    if(result != SXBP_OPERATION_OK) {
+        return result;
+    }
+    sxbp_live_render_t* live = &animation->live;
+    sxbp_animation_frame_t* frame = &animation->frame;
+    sxbp_bitmap_region_t content = live->content;
+    sxbp_bitmap_region_t last = animation->content;
+    sxbp_bitmap_region_t changed = { 0, 0, 0, 0, };
+    if(
+        (frame->image.pixels == NULL) || live->resized ||
+        (content.x != last.x) || (content.y != last.y) ||
+        (content.width != last.width) || (content.height != last.height)
+    ) {
+        if(
+            (frame->image.pixels == NULL) ||
+            (content.width != frame->image.width) ||
+            (content.height != frame->image.height)
+        ) {
+            sxbp_bitmap_t image = {
+                .width = content.width, .height = content.height,
+                .stride = ((size_t)content.width + 7) / 8, .pixels = NULL,
+            };
+            image.pixels = sxbp_malloc(image.stride * image.height);
+            if(image.pixels == NULL) {
+                return SXBP_MALLOC_REFUSED;
+            }
+            sxbp_free(frame->image.pixels);
+            frame->image = image;
+        }
+        changed = (sxbp_bitmap_region_t){
+            0, 0, content.width, content.height,
+        };
+    } else if((live->dirty.width > 0) && (live->dirty.height > 0)) {
+        // only the part of the dirty region within the spiral can differ
+        uint32_t left = (
+            live->dirty.x > content.x
+        ) ? live->dirty.x : content.x;
+        uint32_t top = (live->dirty.y > content.y) ? live->dirty.y : content.y;
+        uint32_t right = live->dirty.x + live->dirty.width;
+        uint32_t bottom = live->dirty.y + live->dirty.height;
+        right = (
+            right < content.x + content.width
+        ) ? right : content.x + content.width;
+        bottom = (
+            bottom < content.y + content.height
+        ) ? bottom : content.y + content.height;
+        if((left < right) && (top < bottom)) {
+            changed = (sxbp_bitmap_region_t){
+                left - content.x, top - content.y, right - left, bottom - top,
+            };
+        }
+    }
+    if((changed.width > 0) && (changed.height > 0)) {
+        crop_bitmap_rows(
+            live->image, content.x, content.y, &frame->image,
+            changed.x / 8, (changed.x + changed.width - 1) / 8, changed.y,
+            changed.y + changed.height - 1
+        );
+    }
+    animation->content = content;
+    frame->changed = changed;
+    frame->line_count = live->line_count;
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private progress callback for sxbp_plot_spiral(), which builds a frame of
+ * the animation_t given as user_data every lines_per_frame lines and after
+ * the last line, and passes each one on to the frame callback
+ */
+static void plot_animation_frame(
+    sxbp_spiral_t* spiral, sxbp_line_count_t latest_line,
+    sxbp_line_count_t target_line, void* user_data
+) {
+    animation_t* animation = (animation_t*)user_data;
+    if(animation->result != SXBP_OPERATION_OK) {
+        return;
+    }
+    animation->lines_since_frame++;
+    if(
+        (animation->lines_since_frame < animation->lines_per_frame) &&
+        (latest_line + 1 < target_line)
+    ) {
+        return;
+    }
+    animation->lines_since_frame = 0;
+    animation->result = build_animation_frame(spiral, animation);
+    if(animation->result == SXBP_OPERATION_OK) {
+        animation->result = animation->frame_callback(
+            &animation->frame, animation->user_data
+        );
+        animation->frame.number++;
+    }
+}
+
+sxbp_status_t sxbp_plot_spiral_animation(
+    sxbp_spiral_t* spiral, sxbp_length_t perfection_threshold,
+    sxbp_line_count_t max_line, sxbp_animation_options_t options,
+    sxbp_status_t(* frame_callback)(
+        const sxbp_animation_frame_t* frame, void* user_data
+    ),
+    void* user_data
+) {
+    // preconditional assertions
+    assert(spiral->lines != NULL);
+    assert(frame_callback != NULL);
+    animation_t animation = {
+        .live = sxbp_blank_live_render(options.render),
+        .frame = { .number = 0, .image = { .pixels = NULL, }, },
+        .lines_per_frame = (
+            options.lines_per_frame == 0
+        ) ? 1 : options.lines_per_frame,
+        .frame_callback = frame_callback,
+        .user_data = user_data,
+        .result = SXBP_OPERATION_OK,
+    };
+    // start off with whatever has been solved already, without making a frame
+    animation.result = sxbp_update_live_render(spiral, &animation.live);
+    sxbp_status_t result = animation.result;
+    if(result == SXBP_OPERATION_OK) {
+        animation.content = animation.live.content;
+        result = sxbp_plot_spiral(
+            spiral, perfection_threshold, max_line, plot_animation_frame,
+            &animation
+        );
+    }
+    sxbp_free_live_render(&animation.live);
+    sxbp_free(animation.frame.image.pixels);
+    return (result == SXBP_OPERATION_OK) ? animation.result : result;
 }
 
 #ifdef __cplusplus
@@ -23,6 +23,7 @@
 #define SAXBOPHONE_SAXBOSPIRAL_RENDER_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "saxbospiral.h"
@@ -34,8 +35,11 @@ extern "C"{
 
 /**
  * @brief Used to represent a basic 1-bit, pure black/white bitmap image.
- * @details The image has integer height and width, and a 2-dimensional array of
- * 1-bit pixels which are either black or white.
+ * @details The image has integer height and width, and its 1-bit pixels are
+ * packed 8 to a byte in one contiguous block of memory, row by row from the top
+ * of the image down. Within each row, the leftmost pixel is stored in the most
+ * significant bit of the first byte. This is the same as the layout used by the
+ * PBM and 1-bit PNG image formats, so rows can be copied straight out of it.
  */
 typedef struct sxbp_bitmap_t {
     /** @brief The width of the bitmap in pixels */
@@ -43,21 +47,226 @@ typedef struct sxbp_bitmap_t {
     /** @brief The height of the bitmap in pixels */
     uint32_t height;
     /**
-     * @brief A 2-dimensional array of pixels.
-     * @details false is black and true is white.
+     * @brief The number of bytes from the start of one row of pixels to the
+     * start of the next.
+     * @details This is at least enough bytes to hold width bits. Any bits left
+     * over at the end of a row are always 0.
      */
-    bool** pixels;
+    size_t stride;
+    /**
+     * @brief The pixels of the bitmap, stride * height bytes in size.
+     * @details A bit of 1 is black and a bit of 0 is white.
+     */
+    uint8_t* pixels;
 } sxbp_bitmap_t;
 
+/**
+ * @brief Used to represent an 8-bit greyscale image.
+ * @details The pixels are stored one byte each, row by row from the top of the
+ * image down, with no padding between rows. A value of 0 is black and 255 is
+ * white, the same as in 8-bit greyscale PNG images.
+ */
+typedef struct sxbp_greyscale_image_t {
+    /** @brief The width of the image in pixels */
+    uint32_t width;
+    /** @brief The height of the image in pixels */
+    uint32_t height;
+    /** @brief The pixels of the image, width * height bytes in size. */
+    uint8_t* pixels;
+} sxbp_greyscale_image_t;
+
+/**
+ * @brief Options controlling how a spiral is drawn by the render functions.
+ * @details A zero-initialised instance of this struct gives the default
+ * behaviour, which is the same as that of sxbp_render_spiral_raw().
+ */
+typedef struct sxbp_render_options_t {
+    /**
+     * @brief The number of pixels between adjacent co-ords of the spiral.
+     * @details 0 means the default of 2.
+     */
+    uint32_t scale;
+    /**
+     * @brief The width of the lines in pixels, which is also the width of the
+     * white border left around the image.
+     * @details 0 means the default of 1.
+     */
+    uint32_t thickness;
+} sxbp_render_options_t;
+
+// the private part of a tile index, defined in render.c
+struct sxbp_band_index_t;
+// the private part of a live render, defined in render.c
+struct sxbp_live_index_t;
+
+/**
+ * @brief An index of the lines of a spiral, used to render tiles of a zoomable
+ * image of it.
+ * @details The tiles form a pyramid of levels. Level 0 is the full size image,
+ * as rendered by sxbp_render_spiral_raw_with_options(), and each level after it
+ * is half the width and height of the one before (rounded up), down to the
+ * last level, which fits in a single tile. Each level is cut into square tiles
+ * of tile_size pixels, counting columns from the left and rows from the top,
+ * except that tiles at the right and bottom edges are cut short.
+ *
+ * When shrunk, a pixel is black if any of the pixels it stands for would be
+ * black at full size, so that lines never vanish when zoomed out.
+ */
+typedef struct sxbp_tile_index_t {
+    /** @brief The width of the full size image in pixels */
+    uint32_t width;
+    /** @brief The height of the full size image in pixels */
+    uint32_t height;
+    /** @brief The width and height of each tile in pixels */
+    uint32_t tile_size;
+    /** @brief The number of levels of the pyramid */
+    uint32_t levels;
+    /**
+     * @brief The lines of the spiral, sorted by the full size tiles they
+     * cross.
+     * @details This is private to the library. It should be NULL before the
+     * index is built.
+     */
+    struct sxbp_band_index_t* bands;
+} sxbp_tile_index_t;
+
+/**
+ * @brief A rectangular region of the pixels of a bitmap.
+ * @details A region with a width or height of 0 is empty.
+ */
+typedef struct sxbp_bitmap_region_t {
+    /** @brief The column of the leftmost pixels of the region */
+    uint32_t x;
+    /** @brief The row of the topmost pixels of the region */
+    uint32_t y;
+    /** @brief The width of the region in pixels */
+    uint32_t width;
+    /** @brief The height of the region in pixels */
+    uint32_t height;
+} sxbp_bitmap_region_t;
+
+/**
+ * @brief A bitmap of a spiral which is kept up to date as the spiral is solved.
+ * @details Each time it is updated, only the lines which have changed since
+ * the last update are redrawn, and the region of the bitmap which changed is
+ * reported, so a live preview of a solve costs only as much as the changes.
+ *
+ * The spiral is drawn on a canvas with room to spare around it, so that it
+ * doesn't have to be made again every time the spiral grows. When the spiral
+ * does outgrow the canvas, a new one is made about twice the size of the
+ * spiral, which means this happens only a few times over a whole solve.
+ *
+ * This should be made with sxbp_blank_live_render() and freed with
+ * sxbp_free_live_render().
+ */
+typedef struct sxbp_live_render_t {
+    /** @brief The options the lines are drawn with */
+    sxbp_render_options_t options;
+    /** @brief The canvas the spiral is drawn on */
+    sxbp_bitmap_t image;
+    /**
+     * @brief The region of image holding the spiral.
+     * @details This is exactly the bitmap that
+     * sxbp_render_spiral_raw_with_options() would render from the lines of the
+     * spiral drawn so far. The rest of the canvas is white.
+     */
+    sxbp_bitmap_region_t content;
+    /** @brief The region of image changed by the last update */
+    sxbp_bitmap_region_t dirty;
+    /**
+     * @brief Whether the last update had to make a new canvas.
+     * @details If it did, the whole of image is dirty.
+     */
+    bool resized;
+    /**
+     * @brief The smallest and largest co-ords the canvas has room for.
+     * @private
+     */
+    sxbp_co_ord_t canvas_bounds[2];
+    /**
+     * @brief The lines drawn on the canvas so far.
+     * @private
+     */
+    sxbp_line_t* lines;
+    /**
+     * @brief The number of lines drawn on the canvas so far.
+     * @private
+     */
+    sxbp_line_count_t line_count;
+    /**
+     * @brief Where the lines drawn so far are, and which bands of rows of the
+     * canvas they cross.
+     * @private
+     */
+    struct sxbp_live_index_t* index;
+} sxbp_live_render_t;
+
+/**
+ * @brief Options for sxbp_plot_spiral_animation().
+ * @details A zero-initialised instance of this struct gives the default
+ * behaviour, which is a frame for every line plotted, drawn as
+ * sxbp_render_spiral_raw() would draw it.
+ */
+typedef struct sxbp_animation_options_t {
+    /** @brief The options to draw each frame with */
+    sxbp_render_options_t render;
+    /**
+     * @brief How many lines to plot between frames.
+     * @details 0 is taken to mean 1.
+     */
+    uint32_t lines_per_frame;
+} sxbp_animation_options_t;
+
+/**
+ * @brief One frame of an animation of a spiral being plotted.
+ * @details Frames are made by sxbp_plot_spiral_animation() and are only
+ * valid until the frame callback returns.
+ */
+typedef struct sxbp_animation_frame_t {
+    /** @brief The number of the frame, counting from 0 */
+    uint32_t number;
+    /** @brief The number of lines of the spiral drawn in the frame */
+    sxbp_line_count_t line_count;
+    /**
+     * @brief The frame itself.
+     * @details This is exactly the bitmap that
+     * sxbp_render_spiral_raw_with_options() would render from the lines drawn.
+     */
+    sxbp_bitmap_t image;
+    /**
+     * @brief The region of image which differs from the previous frame.
+     * @details This is all of the image for the first frame and whenever the
+     * spiral has grown or moved since the last one.
+     */
+    sxbp_bitmap_region_t changed;
+} sxbp_animation_frame_t;
+
+/**
+ * @brief Gets the colour of one pixel of a bitmap.
+ *
+ * @param bitmap The bitmap to get the pixel from.
+ * @param x The x co-ordinate of the pixel, from the left of the image.
+ * @param y The y co-ordinate of the pixel, from the top of the image.
+ * @return true if the pixel is black, false if it is white.
+ *
+ * @note Asserts:
+ * - That bitmap.pixels is not NULL
+ * - That x is less than bitmap.width
+ * - That y is less than bitmap.height
+ */
+bool sxbp_get_bitmap_pixel(sxbp_bitmap_t bitmap, uint32_t x, uint32_t y);
+
 /**
  * @brief Renders the line of a spiral to a bitmap.
  * @details The lines of the spiral are plotted on a white background and the
  * pixel data representing the resulting shape is written to the given image.
+ * The spiral's co-ord cache is not needed.
  *
  * @param spiral The spiral which should be rendered.
  * @param[out] image The bitmap to write the pixel data out to.
  * @return SXBP_OPERATION_OK on success.
  * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
  *
  * @note Asserts:
  * - That image->pixels is NULL
@@ -67,6 +276,143 @@ sxbp_status_t sxbp_render_spiral_raw(
     sxbp_spiral_t spiral, sxbp_bitmap_t* image
 );
 
+/**
+ * @brief Renders the line of a spiral to a bitmap, with the given options.
+ * @details As sxbp_render_spiral_raw(), but the spacing of the co-ords and the
+ * thickness of the lines are given by the options. The image is
+ * (s * w + 3 * t) pixels wide and (s * h + 3 * t) pixels high, where w and h
+ * are the width and height of the spiral in co-ords (less one), s is the scale
+ * and t is the thickness.
+ *
+ * Each line is drawn as a solid rectangle of pixels, one span of whole bytes
+ * per row, rather than pixel by pixel, so the time taken grows with the area
+ * of the lines in bytes rather than in pixels.
+ *
+ * @param spiral The spiral which should be rendered.
+ * @param options The options to render with.
+ * @param[out] image The bitmap to write the pixel data out to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ *
+ * @note Asserts:
+ * - That image->pixels is NULL
+ * - That spiral.lines is not NULL
+ */
+sxbp_status_t sxbp_render_spiral_raw_with_options(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, sxbp_bitmap_t* image
+);
+
+/**
+ * @brief Renders the line of a spiral to a bitmap, using several threads.
+ * @details The bitmap produced is exactly the same as that produced by
+ * sxbp_render_spiral_raw_with_options(). The image is split into horizontal
+ * bands of rows and the lines are sorted into the bands that they cross, after
+ * which the bands are drawn in parallel, each thread only drawing the lines
+ * which cross the bands it has been given.
+ *
+ * @param spiral The spiral which should be rendered.
+ * @param options The options to render with.
+ * @param thread_count The maximum number of threads to use. 0 or 1 means do
+ * all of the work on the calling thread. This is ignored if the library was
+ * built without thread support (see SXBP_THREAD_SUPPORT).
+ * @param[out] image The bitmap to write the pixel data out to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ *
+ * @note Asserts:
+ * - That image->pixels is NULL
+ * - That spiral.lines is not NULL
+ */
+sxbp_status_t sxbp_render_spiral_raw_in_parallel(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, size_t thread_count,
+    sxbp_bitmap_t* image
+);
+
+/**
+ * @brief Renders a reduced size preview of a spiral in shades of grey.
+ * @details The image is shrunk from the size that
+ * sxbp_render_spiral_raw_with_options() would render it at by the smallest
+ * whole factor which makes it fit within max_width by max_height pixels. Each
+ * pixel of the preview is shaded by how much of the square of full size pixels
+ * it stands for is covered by the line, so thin lines fade rather than vanish.
+ *
+ * The full size image is never produced: the area of the line falling within
+ * each preview pixel is added up directly, row by row of the preview, with
+ * lines that overlap (as they do when thickness is greater than scale) merged
+ * so that no full size pixel is counted twice. The time taken depends on the
+ * number of lines and the number of preview pixels they pass through, however
+ * big the full size image would have been.
+ *
+ * @param spiral The spiral which should be rendered.
+ * @param options The options giving the full size image that is shrunk.
+ * @param max_width The maximum width of the preview, in pixels.
+ * @param max_height The maximum height of the preview, in pixels.
+ * @param[out] image The greyscale image to write the preview to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ *
+ * @note Asserts:
+ * - That image->pixels is NULL
+ * - That spiral.lines is not NULL
+ * - That max_width and max_height are not 0
+ */
+sxbp_status_t sxbp_render_spiral_thumbnail(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, uint32_t max_width,
+    uint32_t max_height, sxbp_greyscale_image_t* image
+);
+
+/**
+ * @brief Renders the line of a spiral a band of rows at a time.
+ * @details The image is rendered exactly as
+ * sxbp_render_spiral_raw_with_options() would render it, but instead of the
+ * whole image being held in memory at once, it is produced in bands of
+ * band_height rows from the top of the image down, each of which is passed to
+ * the row sink callback as soon as it has been drawn. Memory use is
+ * proportional to the width of the image times band_height plus the number of
+ * lines in the spiral, rather than the width times the height.
+ *
+ * The band bitmap passed to the row sink is only valid until it returns. All
+ * bands except the last have band_height rows. The spiral's co-ord cache is
+ * not needed.
+ *
+ * @param spiral The spiral which should be rendered.
+ * @param options The options to render with.
+ * @param band_height The maximum number of rows to render at once.
+ * @param row_sink A function pointer with the following signature:
+ * @code
+ * sxbp_status_t callback_name(
+ *     sxbp_bitmap_t band, uint32_t first_row, uint32_t image_height,
+ *     void* user_data
+ * )
+ * @endcode
+ * It is given each band in turn, along with the index of the band's first row
+ * in the whole image and the height of the whole image (the width of the whole
+ * image is the width of the band). If it returns anything other than
+ * SXBP_OPERATION_OK, rendering stops and that status is returned.
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the row sink every time it is called.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ * @return Any status returned by the row sink other than SXBP_OPERATION_OK.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That band_height is not 0
+ * - That the function pointer is not NULL
+ */
+sxbp_status_t sxbp_render_spiral_rows(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, uint32_t band_height,
+    sxbp_status_t(* row_sink)(
+        sxbp_bitmap_t band, uint32_t first_row, uint32_t image_height,
+        void* user_data
+    ),
+    void* user_data
+);
+
 /**
  * @brief Renders the line of a spiral to an image format.
  * @details The lines of the spiral are plotted on a white background and the
@@ -74,7 +420,7 @@ sxbp_status_t sxbp_render_spiral_raw(
  * image file format, using the callback function to achieve this conversion.
  * The callback function should inspect the pixels of the bitmap passed to it
  * and write the file data representing the bitmap in it's respective file
- * format out to the buffer.
+ * format out to the buffer. The bitmap is freed once the callback returns.
  * 
  * @details The function signature of the callback is the same as that of the
  * image rendering functions provided by the library: sxbp_render_backend_pbm
@@ -107,6 +453,267 @@ sxbp_status_t sxbp_render_spiral_image(
     )
 );
 
+/**
+ * @brief Builds an index of a spiral's lines, for rendering tiles from.
+ * @details Building the index takes time proportional to the number of lines
+ * of the spiral, after which any tile can be rendered from it without looking
+ * at the lines that don't cross it, and without rendering the rest of the
+ * image. The spiral is no longer needed once the index has been built.
+ *
+ * @param spiral The spiral which should be rendered.
+ * @param options The options to render the full size image with.
+ * @param tile_size The width and height of each tile in pixels.
+ * @param[out] index The tile index to build. This must be freed with
+ * sxbp_free_tile_index() when it is no longer needed.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That tile_size is not 0
+ * - That index->bands is NULL
+ */
+sxbp_status_t sxbp_build_tile_index(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, uint32_t tile_size,
+    sxbp_tile_index_t* index
+);
+
+/**
+ * @brief Frees the memory held by a tile index.
+ * @details It is safe to call this on an index which has already been freed.
+ *
+ * @param index The tile index to free.
+ */
+void sxbp_free_tile_index(sxbp_tile_index_t* index);
+
+/**
+ * @brief Gets the number of columns and rows of tiles at a level of the
+ * pyramid.
+ *
+ * @param index The tile index to get the grid of.
+ * @param level The level of the pyramid.
+ * @param[out] columns The number of columns of tiles.
+ * @param[out] rows The number of rows of tiles.
+ *
+ * @note Asserts:
+ * - That level is less than index->levels
+ */
+void sxbp_get_tile_grid(
+    const sxbp_tile_index_t* index, uint32_t level, uint32_t* columns,
+    uint32_t* rows
+);
+
+/**
+ * @brief Renders a single tile to an image format.
+ * @details This is for rendering tiles on demand, such as when they are
+ * requested by a viewer. The tile is rendered to a bitmap which is then passed
+ * to the image writer callback, in the same way as sxbp_render_spiral_image()
+ * does with the whole image, so any of the render backends can be used.
+ *
+ * @param index The tile index to render from.
+ * @param level The level of the pyramid the tile is on.
+ * @param column The column of the tile, counting from the left.
+ * @param row The row of the tile, counting from the top.
+ * @param[out] buffer The buffer to write the tile image to.
+ * @param image_writer_callback A function pointer to the backend to write the
+ * tile with, such as sxbp_render_backend_pbm or sxbp_render_backend_png.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_OPERATION_FAIL if there is no such tile.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ * @return Any other status returned by the image writer callback.
+ *
+ * @note Asserts:
+ * - That index->bands is not NULL
+ * - That buffer->bytes is NULL
+ * - That the function pointer is not NULL
+ */
+sxbp_status_t sxbp_render_tile(
+    const sxbp_tile_index_t* index, uint32_t level, uint32_t column,
+    uint32_t row, sxbp_buffer_t* buffer,
+    sxbp_status_t(* image_writer_callback)(
+        sxbp_bitmap_t image, sxbp_buffer_t* buffer
+    )
+);
+
+/**
+ * @brief Renders every tile of every level of the pyramid.
+ * @details Each tile is rendered as sxbp_render_tile() would render it, and
+ * passed to the tile sink, from level 0 upwards and row by row within each
+ * level. Only one tile is held in memory at a time.
+ *
+ * @param index The tile index to render from.
+ * @param image_writer_callback A function pointer to the backend to write the
+ * tiles with, such as sxbp_render_backend_pbm or sxbp_render_backend_png.
+ * @param tile_sink A function pointer with the following signature:
+ * @code
+ * sxbp_status_t callback_name(
+ *     uint32_t level, uint32_t column, uint32_t row, sxbp_buffer_t tile,
+ *     void* user_data
+ * )
+ * @endcode
+ * It is given each tile image along with its position, and would typically
+ * save it to a file named after these. The tile's buffer is freed once it
+ * returns. If it returns anything other than SXBP_OPERATION_OK, rendering
+ * stops and that status is returned.
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the tile sink every time it is called.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ * @return Any other status returned by the image writer callback or the tile
+ * sink.
+ *
+ * @note Asserts:
+ * - That index->bands is not NULL
+ * - That the function pointers are not NULL
+ */
+sxbp_status_t sxbp_render_tile_pyramid(
+    const sxbp_tile_index_t* index,
+    sxbp_status_t(* image_writer_callback)(
+        sxbp_bitmap_t image, sxbp_buffer_t* buffer
+    ),
+    sxbp_status_t(* tile_sink)(
+        uint32_t level, uint32_t column, uint32_t row, sxbp_buffer_t tile,
+        void* user_data
+    ),
+    void* user_data
+);
+
+/**
+ * @brief Returns a live render with nothing drawn on it yet.
+ *
+ * @param options The options to draw the lines with (see
+ * sxbp_render_options_t).
+ * @return A live render which can be passed to sxbp_update_live_render().
+ */
+sxbp_live_render_t sxbp_blank_live_render(sxbp_render_options_t options);
+
+/**
+ * @brief Brings a live render up to date with the solved lines of a spiral.
+ * @details The first spiral->solved_count lines of the spiral are drawn. These
+ * are compared with the lines drawn at the last update, and only those from
+ * the first line that differs onwards are erased and redrawn, along with the
+ * parts of any other lines which cross the region they cover. Where the lines
+ * are and which rows of the canvas they cross is kept between updates, so an
+ * update costs little more than the lines which have changed, unless the
+ * spiral outgrows the canvas. Afterwards, live->dirty holds the region of the
+ * canvas which changed, which is empty if nothing did.
+ *
+ * @param spiral The spiral to draw.
+ * @param[in, out] live The live render to update.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure, in which case the
+ * live render is left as it was.
+ * @return SXBP_SIZE_OVERFLOW if the canvas would be too big to address, in
+ * which case the live render is also left as it was.
+ *
+ * @note Asserts:
+ * - That spiral->lines is not NULL
+ */
+sxbp_status_t sxbp_update_live_render(
+    const sxbp_spiral_t* spiral, sxbp_live_render_t* live
+);
+
+/**
+ * @brief Frees the memory held by a live render.
+ * @details The live render is left blank, so it can be used again.
+ *
+ * @param[in, out] live The live render to free.
+ */
+void sxbp_free_live_render(sxbp_live_render_t* live);
+
+/**
+ * @brief Plots a spiral as sxbp_plot_spiral() does, keeping a live render of
+ * it up to date as it goes.
+ * @details After every line is plotted, the live render is updated with
+ * sxbp_update_live_render() and then the callback (if any) is called, from
+ * which the dirty region of the live render can be shown.
+ *
+ * @param[in, out] spiral The spiral to plot.
+ * @param perfection_threshold As for sxbp_plot_spiral().
+ * @param max_line As for sxbp_plot_spiral().
+ * @param[in, out] live The live render to keep up to date.
+ * @param progress_callback A function pointer with the following signature:
+ * @code
+ * void callback_name(
+ *     sxbp_spiral_t* spiral, const sxbp_live_render_t* live,
+ *     sxbp_line_count_t latest_line, sxbp_line_count_t target_line,
+ *     void* user_data
+ * )
+ * @endcode
+ * Or NULL if no callback is wanted.
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the callback every time it is called.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the canvas would be too big to address.
+ * If the live render couldn't be updated, the spiral is still plotted, but the
+ * live render and callback are left alone from then on.
+ *
+ * @note Asserts:
+ * - That spiral->lines is not NULL
+ */
+sxbp_status_t sxbp_plot_spiral_live(
+    sxbp_spiral_t* spiral, sxbp_length_t perfection_threshold,
+    sxbp_line_count_t max_line, sxbp_live_render_t* live,
+    void(* progress_callback)(
+        sxbp_spiral_t* spiral, const sxbp_live_render_t* live,
+        sxbp_line_count_t latest_line, sxbp_line_count_t target_line,
+        void* user_data
+    ),
+    void* user_data
+);
+
+/**
+ * @brief Plots a spiral as sxbp_plot_spiral() does, making an animation of it
+ * being solved as it goes.
+ * @details A frame is made every options.lines_per_frame lines and after the
+ * last line, and passed to the frame callback, from which it can be written
+ * out (with sxbp_render_backend_pbm(), for example, to make a sequence of
+ * numbered images). The lines already solved when this is called are drawn in
+ * the first frame, but don't get a frame of their own.
+ *
+ * Each frame is built from the one before: a live render (see
+ * sxbp_live_render_t) is brought up to date with the lines changed since then
+ * and only the region it reports as changed is copied into the frame, so
+ * making a frame costs only as much as the changes since the last one.
+ *
+ * @param[in, out] spiral The spiral to plot.
+ * @param perfection_threshold As for sxbp_plot_spiral().
+ * @param max_line As for sxbp_plot_spiral().
+ * @param options The options to make the animation with (see
+ * sxbp_animation_options_t).
+ * @param frame_callback A function pointer with the following signature:
+ * @code
+ * sxbp_status_t callback_name(
+ *     const sxbp_animation_frame_t* frame, void* user_data
+ * )
+ * @endcode
+ * The callback should return SXBP_OPERATION_OK if the frame was dealt with.
+ * If it returns anything else, the spiral is still plotted, but no more frames
+ * are made and that status is returned.
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the frame callback every time it is called.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the frames would be too big to address.
+ * @return Whatever the frame callback returned, if it didn't succeed.
+ *
+ * @note Asserts:
+ * - That spiral->lines is not NULL
+ * - That frame_callback is not NULL
+ */
+sxbp_status_t sxbp_plot_spiral_animation(
+    sxbp_spiral_t* spiral, sxbp_length_t perfection_threshold,
+    sxbp_line_count_t max_line, sxbp_animation_options_t options,
+    sxbp_status_t(* frame_callback)(
+        const sxbp_animation_frame_t* frame, void* user_data
+    ),
+    void* user_data
+);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -10,7 +10,6 @@
  */
 #include <assert.h>
 #include <inttypes.h>
-#include <math.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -18,6 +17,7 @@
 #include <string.h>
 
 #include "../saxbospiral.h"
+#include "../allocator.h"
 #include "../render.h"
 #include "backend_pbm.h"
 
@@ -26,40 +26,78 @@
 extern "C"{
 #endif
 
+/*
+ * the longest a PBM header can be: "P4" magic number + whitespace, then the
+ * width and height of the image in decimal - these may be up to 10 characters
+ * each (max uint32_t is 10 digits long) - each followed by whitespace. 1 extra
+ * char is allowed for the null-terminator.
+ */
+#define PBM_HEADER_MAX_SIZE (3 + 11 + 11 + 1)
+
+/*
+ * private function, writes the PBM header for an image of the given size to
+ * header, which must be at least PBM_HEADER_MAX_SIZE chars long, and returns
+ * the number of chars in it (excluding the null-terminator)
+ */
+static size_t write_pbm_header(
+    uint32_t width, uint32_t height, char header[PBM_HEADER_MAX_SIZE]
+) {
+    return (size_t)sprintf(
+        header, "P4\n%" PRIu32 "\n%" PRIu32 "\n", width, height
+    );
+}
+
+/*
+ * private function, writes the PBM image of the bitmap to the start of the
+ * buffer, which must have room for all of it, given its header
+ */
+static void write_pbm_image(
+    sxbp_bitmap_t bitmap, const char* header, size_t header_length,
+    sxbp_buffer_t* buffer
+) {
+    size_t index = 0; // this index is used to index the buffer
+    // magic number, image width and image height
+    memcpy(buffer->bytes + index, header, header_length);
+    index += header_length;
+    /*
+     * now for the image data, packed into rows to the nearest byte. The
+     * bitmap's rows are already packed in exactly this way, so they can be
+     * copied straight in
+     */
+    size_t bytes_per_row = ((size_t)bitmap.width + 7) / 8;
+    for(size_t y = 0; y < bitmap.height; y++) { // row loop
+        memcpy(
+            buffer->bytes + index, bitmap.pixels + (y * bitmap.stride),
+            bytes_per_row
+        );
+        // increment index so next row is written in the correct place
+        index += bytes_per_row;
+    }
+}
+
 sxbp_status_t sxbp_render_backend_pbm(
     sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
 ) {
     // preconditional assertsions
     assert(bitmap.pixels != NULL);
     assert(buffer->bytes == NULL);
+    // build the header first, so we know how long it is
+    char header[PBM_HEADER_MAX_SIZE];
+    size_t header_length = write_pbm_header(
+        bitmap.width, bitmap.height, header
+    );
     /*
-     * allocate two char arrays for the width and height strings - these may be
-     * up to 10 characters each (max uint32_t is 10 digits long), so allocate 2
-     * char arrays of 11 chars each (1 extra char for null-terminator)
-     */
-    char width_string[11], height_string[11];
-    // these are used to keep track of how many digits each is
-    int width_string_length, height_string_length = 0;
-    // convert width and height to a decimal string, store lengths
-    width_string_length = sprintf(width_string, "%" PRIu32, bitmap.width);
-    height_string_length = sprintf(height_string, "%" PRIu32, bitmap.height);
-    /*
-     * now that we know the length of the image dimension strings, we can now
-     * calculate how much memory we'll have to allocate for the image buffer
+     * now that we know the length of the header, we can now calculate how much
+     * memory we'll have to allocate for the image buffer
      */
     // calculate number of bytes per row - this is ceiling(width / 8)
-    size_t bytes_per_row = (size_t)ceil((double)bitmap.width / 8.0);
+    size_t bytes_per_row = ((size_t)bitmap.width + 7) / 8;
     // calculate number of bytes for the entire image pixels (rows and columns)
     size_t image_bytes = bytes_per_row * bitmap.height;
     // finally put it all together to get total image buffer size
-    size_t image_buffer_size = (
-        3 // "P4" magic number + whitespace
-        + width_string_length + 1 // width of image in decimal + whitespace
-        + height_string_length + 1 // height of image in decimal + whitespace
-        + image_bytes // lastly, the bytes which make up the image pixels
-    );
+    size_t image_buffer_size = header_length + image_bytes;
     // try and allocate the data for the buffer
-    buffer->bytes = calloc(image_buffer_size, sizeof(uint8_t));
+    buffer->bytes = sxbp_calloc(image_buffer_size, sizeof(uint8_t));
     // check fo memory allocation failure
     if(buffer->bytes == NULL) {
         return SXBP_MALLOC_REFUSED;
@@ -67,42 +105,101 @@ sxbp_status_t sxbp_render_backend_pbm(
         // set buffer size
         buffer->size = image_buffer_size;
         // otherwise carry on
-        size_t index = 0; // this index is used to index the buffer
-        // construct magic number + whitespace
-        memcpy(buffer->bytes + index, "P4\n", 3);
-        index += 3;
-        // image width
-        memcpy(buffer->bytes + index, width_string, width_string_length);
-        index += width_string_length;
-        // whitespace
-        memcpy(buffer->bytes + index, "\n", 1);
-        index += 1;
-        // image height
-        memcpy(buffer->bytes + index, height_string, height_string_length);
-        index += height_string_length;
-        // whitespace
-        memcpy(buffer->bytes + index, "\n", 1);
-        index += 1;
-        // now for the image data, packed into rows to the nearest byte
-        for(size_t y = 0; y < bitmap.height; y++) { // row loop
-            for(size_t x = 0; x < bitmap.width; x++) {
-                // byte index is index + floor(x / 8)
-                size_t byte_index = index + (x / 8);
-                // bit index is x mod 8
-                uint8_t bit_index = x % 8;
-                // write bits most-significant-bit first
-                buffer->bytes[byte_index] |= (
-                    // black pixel = bool true = 1, just like in PBM format
-                    bitmap.pixels[x][y] << (7 - bit_index)
-                );
-            }
-            // increment index so next row is written in the correct place
-            index += bytes_per_row;
-        }
+        write_pbm_image(bitmap, header, header_length, buffer);
         return SXBP_OPERATION_OK;
     }
 }
 
+size_t sxbp_get_pbm_size(uint32_t width, uint32_t height) {
+    char header[PBM_HEADER_MAX_SIZE];
+    return (
+        write_pbm_header(width, height, header) +
+        (((size_t)width + 7) / 8) * height
+    );
+}
+
+sxbp_status_t sxbp_render_backend_pbm_into(
+    sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
+) {
+    // preconditional assertsions
+    assert(bitmap.pixels != NULL);
+    assert(buffer->bytes != NULL);
+    char header[PBM_HEADER_MAX_SIZE];
+    size_t header_length = write_pbm_header(
+        bitmap.width, bitmap.height, header
+    );
+    size_t size = header_length + (((size_t)bitmap.width + 7) / 8) * (
+        bitmap.height
+    );
+    // check that the image will fit in the buffer
+    if(buffer->size < size) {
+        return SXBP_OPERATION_FAIL;
+    }
+    buffer->size = size;
+    write_pbm_image(bitmap, header, header_length, buffer);
+    return SXBP_OPERATION_OK;
+}
+
+// private type for the write callback used by the PBM row sink
+typedef struct pbm_stream_t {
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data);
+    void* user_data;
+} pbm_stream_t;
+
+/*
+ * private row sink which writes the PBM header before the first band, then the
+ * rows of each band as they come, out to the write callback of the pbm_stream_t
+ * given as user_data
+ */
+static sxbp_status_t write_pbm_rows(
+    sxbp_bitmap_t band, uint32_t first_row, uint32_t image_height,
+    void* user_data
+) {
+    pbm_stream_t* stream = (pbm_stream_t*)user_data;
+    if(first_row == 0) {
+        char header[PBM_HEADER_MAX_SIZE];
+        size_t header_length = write_pbm_header(
+            band.width, image_height, header
+        );
+        if(
+            stream->write_callback(
+                (const uint8_t*)header, header_length, stream->user_data
+            ) != header_length
+        ) {
+            return SXBP_OPERATION_FAIL;
+        }
+    }
+    // the band's rows are packed just as PBM's are
+    size_t bytes_per_row = ((size_t)band.width + 7) / 8;
+    for(size_t y = 0; y < band.height; y++) {
+        if(
+            stream->write_callback(
+                band.pixels + (y * band.stride), bytes_per_row,
+                stream->user_data
+            ) != bytes_per_row
+        ) {
+            return SXBP_OPERATION_FAIL;
+        }
+    }
+    return SXBP_OPERATION_OK;
+}
+
+sxbp_status_t sxbp_render_spiral_to_pbm_stream(
+    sxbp_spiral_t spiral, sxbp_render_options_t options,
+    uint32_t band_height,
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data),
+    void* user_data
+) {
+    // preconditional assertions
+    assert(spiral.lines != NULL);
+    assert(band_height != 0);
+    assert(write_callback != NULL);
+    pbm_stream_t stream = { write_callback, user_data, };
+    return sxbp_render_spiral_rows(
+        spiral, options, band_height, write_pbm_rows, (void*)&stream
+    );
+}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
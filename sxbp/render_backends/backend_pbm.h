@@ -25,6 +25,9 @@
 #ifndef SAXBOPHONE_SAXBOSPIRAL_BACKEND_PBM_H
 #define SAXBOPHONE_SAXBOSPIRAL_BACKEND_PBM_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "../saxbospiral.h"
 #include "../render.h"
 
@@ -49,6 +52,81 @@ sxbp_status_t sxbp_render_backend_pbm(
     sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
 );
 
+/**
+ * @brief Gets the exact size of a PBM image of the given size.
+ * @details This is the number of bytes that sxbp_render_backend_pbm() would
+ * write for a bitmap of this size, and so how big a buffer
+ * sxbp_render_backend_pbm_into() needs.
+ *
+ * @param width The width of the image in pixels.
+ * @param height The height of the image in pixels.
+ * @return The size of the PBM image in bytes.
+ */
+size_t sxbp_get_pbm_size(uint32_t width, uint32_t height);
+
+/**
+ * @brief Renders a bitmap image to a PBM image, in a buffer provided by the
+ * caller.
+ * @details Writes exactly the same image as sxbp_render_backend_pbm() would,
+ * but into memory the caller already has rather than a newly allocated buffer.
+ * Use sxbp_get_pbm_size() to find out how big the buffer needs to be.
+ *
+ * @param bitmap Bitmap containing the image to render.
+ * @param[in, out] buffer Buffer to write out the PBM image data to. Its size
+ * should be the number of bytes available at buffer->bytes. On success, this
+ * is set to the number of bytes written, which start at buffer->bytes.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_OPERATION_FAIL if the buffer is too small, in which case nothing
+ * is written.
+ *
+ * @note Asserts:
+ * - That bitmap.pixels is not NULL
+ * - That buffer->bytes is not NULL
+ */
+sxbp_status_t sxbp_render_backend_pbm_into(
+    sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
+);
+
+/**
+ * @brief Renders a spiral to a PBM image, streaming the image out as it is
+ * rendered.
+ * @details The spiral is rendered a band of rows at a time with
+ * sxbp_render_spiral_rows(), and each band's rows are written out in PBM format
+ * via the write callback as soon as it has been drawn, so neither the whole
+ * image nor the whole PBM file ever has to be held in memory. The data written
+ * is exactly the same as that produced by rendering the spiral with
+ * sxbp_render_spiral_raw_with_options() and sxbp_render_backend_pbm().
+ *
+ * @param spiral The spiral which should be rendered.
+ * @param options The options to render the spiral with (see
+ * sxbp_render_options_t).
+ * @param band_height The maximum number of rows to render at once.
+ * @param write_callback A function pointer with the following signature:
+ * @code
+ * size_t callback_name(const uint8_t* data, size_t size, void* user_data)
+ * @endcode
+ * The callback should write out all size bytes of data, returning the number
+ * of bytes actually written. Returning anything less than size is treated as
+ * an error, after which the callback will not be called again.
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the write callback every time it is called (such as a file handle).
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_OPERATION_FAIL if the write callback didn't write all the data.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That band_height is not 0
+ * - That write_callback is not NULL
+ */
+sxbp_status_t sxbp_render_spiral_to_pbm_stream(
+    sxbp_spiral_t spiral, sxbp_render_options_t options,
+    uint32_t band_height,
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data),
+    void* user_data
+);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
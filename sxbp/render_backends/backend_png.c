@@ -9,15 +9,23 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include <assert.h>
-// only include these extra dependencies if support for PNG output was enabled
-#ifdef LIBSXBP_PNG_SUPPORT
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+// only include these extra dependencies if support for libpng was enabled
+#ifdef LIBSXBP_PNG_SUPPORT
+#include <setjmp.h>
 
 #include <png.h>
+#include <zlib.h>
 #endif
 
 #include "../saxbospiral.h"
+#include "../allocator.h"
+#include "../checksum.h"
+#include "../parallel.h"
 #include "../render.h"
 #include "backend_png.h"
 
@@ -26,28 +34,250 @@
 extern "C"{
 #endif
 
-// only define the following private functions if libpng support was enabled
+// the number of metadata text entries written to every image
+#define PNG_METADATA_COUNT 5
+
+// the keys and values of the metadata text entries written to every image
+static const char* PNG_METADATA[PNG_METADATA_COUNT][2] = {
+    { "Author", "Joshua Saxby (https://github.com/saxbophone)", },
+    {
+        "Description",
+        "Experimental generation of 2D spiralling lines based on input binary "
+        "data",
+    },
+    { "Copyright", "Copyright Joshua Saxby", },
+    // LIBSXBP_VERSION_STRING is a macro that expands to a double-quoted string
+    { "Software", "libsxbp v" LIBSXBP_VERSION_STRING, },
+    { "Comment", "https://github.com/saxbophone/libsxbp", },
+};
+
+// the size the output buffer starts at, it doubles in size whenever it's full
+#define PNG_INITIAL_CAPACITY 4096
+
+/*
+ * private type holding the state of a PNG image being written, which is written
+ * either to the end of a buffer or out to a write callback
+ */
+typedef struct png_writer_t {
+    // if this is not NULL, data is written to this buffer
+    sxbp_buffer_t* buffer;
+    // the number of bytes allocated for the buffer, which may be more than used
+    size_t capacity;
+    // if true, the buffer belongs to the caller and can't be grown or shrunk
+    bool fixed;
+    // otherwise, data is written to this callback
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data);
+    void* user_data;
+    sxbp_png_options_t options;
+    // the running checksum of the chunk being written
+    uint32_t crc;
+    #ifdef LIBSXBP_PNG_SUPPORT
+    png_structp png_ptr;
+    png_infop info_ptr;
+    // the status to return if libpng reports an error
+    sxbp_status_t error;
+    #else
+    // the number of bytes in each row of the image, excluding the filter type
+    size_t row_bytes;
+    // whether rows are 1-bit, and so have to be inverted (0 is black in PNG)
+    bool invert;
+    // the running checksum of the image data
+    uint32_t adler;
+    // whether the zlib header at the start of the image data has been written
+    bool started;
+    // the number of bytes of image data left in the current chunk and block
+    size_t chunk_left;
+    size_t block_left;
+    // one row of the image as it is stored, led by its filter type byte
+    uint8_t* row;
+    #endif
+} png_writer_t;
+
+// private function, returns a new writer for the given output and options
+static png_writer_t init_png_writer(
+    sxbp_buffer_t* buffer,
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data),
+    void* user_data, sxbp_png_options_t options
+) {
+    png_writer_t writer;
+    memset(&writer, 0, sizeof(png_writer_t));
+    writer.buffer = buffer;
+    writer.write_callback = write_callback;
+    writer.user_data = user_data;
+    writer.options = options;
+    return writer;
+}
+
+/*
+ * private function, writes the given data to the writer's output. When writing
+ * to a buffer, the buffer's allocation is doubled whenever it runs out of room,
+ * rather than re-allocated for every write. A fixed buffer is never grown, so
+ * running out of room in one is an error.
+ */
+static sxbp_status_t write_output(
+    png_writer_t* writer, const uint8_t* data, size_t size
+) {
+    if(size == 0) {
+        return SXBP_OPERATION_OK;
+    }
+    if(writer->buffer == NULL) {
+        if(writer->write_callback(data, size, writer->user_data) != size) {
+            return SXBP_OPERATION_FAIL;
+        }
+        return SXBP_OPERATION_OK;
+    }
+    sxbp_buffer_t* p = writer->buffer;
+    if((p->size + size > writer->capacity) && writer->fixed) {
+        return SXBP_OPERATION_FAIL;
+    } else if(p->size + size > writer->capacity) {
+        size_t capacity = (
+            (writer->capacity != 0) ? writer->capacity : PNG_INITIAL_CAPACITY
+        );
+        while(capacity < p->size + size) {
+            capacity *= 2;
+        }
+        // sxbp_realloc() allocates if the buffer bytes pointer is NULL
+        uint8_t* bytes = sxbp_realloc(p->bytes, capacity);
+        if(bytes == NULL) {
+            return SXBP_MALLOC_REFUSED;
+        }
+        p->bytes = bytes;
+        writer->capacity = capacity;
+    }
+    // copy new bytes to end of buffer
+    memcpy(p->bytes + p->size, data, size);
+    p->size += size;
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, gives back any memory allocated for the output buffer but
+ * not used. If this fails, the buffer is just left larger than it needs to be.
+ */
+static void shrink_output(png_writer_t* writer) {
+    sxbp_buffer_t* p = writer->buffer;
+    if(
+        (p != NULL) && !writer->fixed && (p->bytes != NULL) &&
+        (p->size < writer->capacity)
+    ) {
+        uint8_t* bytes = sxbp_realloc(p->bytes, p->size);
+        if(bytes != NULL) {
+            p->bytes = bytes;
+            writer->capacity = p->size;
+        }
+    }
+}
+
+// roughly how many bytes of image data to put in each IDAT chunk
+#define IDAT_CHUNK_SIZE (1024 * 1024)
+
+// private function, stores a 32-bit number in big-endian order, as PNG does
+static void store_uint32_t(uint32_t value, uint8_t* bytes) {
+    bytes[0] = (uint8_t)(value >> 24);
+    bytes[1] = (uint8_t)(value >> 16);
+    bytes[2] = (uint8_t)(value >> 8);
+    bytes[3] = (uint8_t)value;
+}
+
+// private function, writes the length and type which start a chunk
+static sxbp_status_t start_chunk(
+    png_writer_t* writer, const char* type, uint32_t length
+) {
+    uint8_t header[8];
+    store_uint32_t(length, header);
+    memcpy(header + 4, type, 4);
+    // the chunk's checksum includes its type, but not its length
+    writer->crc = sxbp_crc32(0, header + 4, 4);
+    return write_output(writer, header, 8);
+}
+
+// private function, writes some of the data of the current chunk
+static sxbp_status_t write_chunk_data(
+    png_writer_t* writer, const uint8_t* data, size_t size
+) {
+    writer->crc = sxbp_crc32(writer->crc, data, size);
+    return write_output(writer, data, size);
+}
+
+// private function, writes the checksum which ends the current chunk
+static sxbp_status_t end_chunk(png_writer_t* writer) {
+    uint8_t crc[4];
+    store_uint32_t(writer->crc, crc);
+    return write_output(writer, crc, 4);
+}
+
+// private function, writes a whole chunk of the given type and data
+static sxbp_status_t write_chunk(
+    png_writer_t* writer, const char* type, const uint8_t* data, uint32_t size
+) {
+    sxbp_status_t result = start_chunk(writer, type, size);
+    if(result == SXBP_OPERATION_OK) {
+        result = write_chunk_data(writer, data, size);
+    }
+    if(result == SXBP_OPERATION_OK) {
+        result = end_chunk(writer);
+    }
+    return result;
+}
+
+/*
+ * private function, writes out the signature and the chunks which come before
+ * the image data of a greyscale PNG image of the given size and bit depth
+ */
+static sxbp_status_t write_png_header(
+    png_writer_t* writer, uint32_t width, uint32_t height, uint8_t bit_depth
+) {
+    const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n', };
+    sxbp_status_t result = write_output(writer, signature, 8);
+    // width, height, bit depth, greyscale, deflate, basic filters, no interlace
+    uint8_t header[13] = { 0, 0, 0, 0, 0, 0, 0, 0, bit_depth, 0, 0, 0, 0, };
+    store_uint32_t(width, header);
+    store_uint32_t(height, header + 4);
+    if(result == SXBP_OPERATION_OK) {
+        result = write_chunk(writer, "IHDR", header, 13);
+    }
+    // all of the bits of the gray channel are significant
+    if(result == SXBP_OPERATION_OK) {
+        result = write_chunk(writer, "sBIT", &bit_depth, 1);
+    }
+    // each metadata entry is its key and text, separated by a null byte
+    for(uint8_t i = 0; i < PNG_METADATA_COUNT; i++) {
+        size_t key_size = strlen(PNG_METADATA[i][0]) + 1;
+        size_t text_size = strlen(PNG_METADATA[i][1]);
+        if(result == SXBP_OPERATION_OK) {
+            result = start_chunk(
+                writer, "tEXt", (uint32_t)(key_size + text_size)
+            );
+        }
+        if(result == SXBP_OPERATION_OK) {
+            result = write_chunk_data(
+                writer, (const uint8_t*)PNG_METADATA[i][0], key_size
+            );
+        }
+        if(result == SXBP_OPERATION_OK) {
+            result = write_chunk_data(
+                writer, (const uint8_t*)PNG_METADATA[i][1], text_size
+            );
+        }
+        if(result == SXBP_OPERATION_OK) {
+            result = end_chunk(writer);
+        }
+    }
+    return result;
+}
+
 #ifdef LIBSXBP_PNG_SUPPORT
-// private custom libPNG buffer write function
-static void buffer_write_data(
+// private custom libPNG write function, writes to the png_writer_t's output
+static void writer_write_data(
     png_structp png_ptr, png_bytep data, png_size_t length
 ) {
-    // retrieve pointer to buffer
-    sxbp_buffer_t* p = (sxbp_buffer_t*)png_get_io_ptr(png_ptr);
-    size_t new_size = p->size + length;
-    // if buffer bytes pointer is not NULL, then re-allocate
-    if(p->bytes != NULL) {
-        p->bytes = realloc(p->bytes, new_size);
-    } else {
-        // otherwise, allocate
-        p->bytes = malloc(new_size);
-    }
-    if(!p->bytes) {
+    // retrieve pointer to writer
+    png_writer_t* writer = (png_writer_t*)png_get_io_ptr(png_ptr);
+    sxbp_status_t result = write_output(writer, data, length);
+    if(result != SXBP_OPERATION_OK) {
+        writer->error = result;
         png_error(png_ptr, "Write Error");
     }
-    // copy new bytes to end of buffer
-    memcpy(p->bytes + p->size, data, length);
-    p->size += length;
 }
 
 // disable GCC warning about the unused parameter, as this is a dummy function
@@ -55,134 +285,829 @@ static void buffer_write_data(
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 // dummy function for unecessary flush function
 static void dummy_png_flush(png_structp png_ptr) {}
+
+/*
+ * private libpng error function, which jumps straight back to the writer's
+ * setjmp() rather than printing the message to stderr as libpng's one does -
+ * the error is reported through the status returned instead
+ */
+static void silent_png_error(png_structp png_ptr, png_const_charp message) {
+    longjmp(png_jmpbuf(png_ptr), 1);
+}
+
+// private libpng warning function, which ignores warnings rather than printing
+static void silent_png_warning(png_structp png_ptr, png_const_charp message) {}
+
+#ifdef PNG_USER_MEM_SUPPORTED
+// private custom libpng memory functions, which use the library's allocator
+static png_voidp png_allocate(png_structp png_ptr, png_alloc_size_t size) {
+    return sxbp_malloc(size);
+}
+
+static void png_deallocate(png_structp png_ptr, png_voidp pointer) {
+    sxbp_free(pointer);
+}
+#endif
 // re-enable all warnings
 #pragma GCC diagnostic pop
 
 // simple libpng cleanup function - used mainly for freeing memory
-static void cleanup_png_lib(
-    png_structp png_ptr, png_infop info_ptr, png_bytep row
-) {
-    if(info_ptr != NULL) {
-        png_free_data(png_ptr, info_ptr, PNG_FREE_ALL, -1);
-    }
-    if(png_ptr != NULL) {
-        png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
+static void cleanup_png_writer(png_writer_t* writer) {
+    if(writer->info_ptr != NULL) {
+        png_free_data(writer->png_ptr, writer->info_ptr, PNG_FREE_ALL, -1);
     }
-    if(row != NULL) {
-        free(row);
+    if(writer->png_ptr != NULL) {
+        png_destroy_write_struct(&writer->png_ptr, &writer->info_ptr);
     }
+    writer->png_ptr = NULL;
+    writer->info_ptr = NULL;
 }
-#endif // LIBSXBP_PNG_SUPPORT
 
-// flag for whether PNG output support has been compiled in based, on macro
-#ifdef LIBSXBP_PNG_SUPPORT
-const bool SXBP_PNG_SUPPORT = true;
-#else
-const bool SXBP_PNG_SUPPORT = false;
-#endif
+// private function, returns the libpng filter flags for the given filter
+static int get_png_filters(sxbp_png_filter_t filter) {
+    switch(filter) {
+        case SXBP_PNG_FILTER_NONE:
+            return PNG_FILTER_NONE;
+        case SXBP_PNG_FILTER_SUB:
+            return PNG_FILTER_SUB;
+        case SXBP_PNG_FILTER_UP:
+            return PNG_FILTER_UP;
+        case SXBP_PNG_FILTER_AVERAGE:
+            return PNG_FILTER_AVG;
+        case SXBP_PNG_FILTER_PAETH:
+            return PNG_FILTER_PAETH;
+        case SXBP_PNG_FILTER_ALL:
+            return PNG_ALL_FILTERS;
+        default:
+            return PNG_NO_FILTERS;
+    }
+}
 
-sxbp_status_t sxbp_render_backend_png(
-    sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
+/*
+ * private function, sets up libpng to write a greyscale image of the given size
+ * and bit depth (1 or 8) and writes out everything that comes before the rows
+ * of the image. The writer must be cleaned up afterwards, whether this succeeds
+ * or not.
+ */
+static sxbp_status_t start_png(
+    png_writer_t* writer, uint32_t width, uint32_t height, uint8_t bit_depth
 ) {
-    // preconditional assertsions
-    assert(bitmap.pixels != NULL);
-    assert(buffer->bytes == NULL);
-    // only do PNG operations if support is enabled
-    #ifndef LIBSXBP_PNG_SUPPORT
-    // return SXBP_NOT_IMPLEMENTED
-    return SXBP_NOT_IMPLEMENTED;
+    // allocate libpng memory, with the library's allocator if possible
+    #ifdef PNG_USER_MEM_SUPPORTED
+    writer->png_ptr = png_create_write_struct_2(
+        PNG_LIBPNG_VER_STRING, NULL, silent_png_error, silent_png_warning,
+        NULL, png_allocate, png_deallocate
+    );
     #else
-    // result status
-    sxbp_status_t result;
-    // init buffer
-    buffer->size = 0;
-    // init libpng stuff
-    png_structp png_ptr = NULL;
-    png_infop info_ptr = NULL;
-    png_bytep row = NULL;
-    // allocate libpng memory
-    png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    writer->png_ptr = png_create_write_struct(
+        PNG_LIBPNG_VER_STRING, NULL, silent_png_error, silent_png_warning
+    );
+    #endif
     // catch malloc fail
-    if(png_ptr == NULL) {
-        result = SXBP_MALLOC_REFUSED;
-        // cleanup
-        cleanup_png_lib(png_ptr, info_ptr, row);
-        return result;
+    if(writer->png_ptr == NULL) {
+        return SXBP_MALLOC_REFUSED;
     }
     // allocate libpng memory
-    info_ptr = png_create_info_struct(png_ptr);
+    writer->info_ptr = png_create_info_struct(writer->png_ptr);
     // catch malloc fail
-    if(info_ptr == NULL) {
-        result = SXBP_MALLOC_REFUSED;
-        // cleanup
-        cleanup_png_lib(png_ptr, info_ptr, row);
-        return result;
+    if(writer->info_ptr == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    // libpng reports errors by jumping back to here
+    writer->error = SXBP_OPERATION_FAIL;
+    if(setjmp(png_jmpbuf(writer->png_ptr))) {
+        return writer->error;
+    }
+    png_structp png_ptr = writer->png_ptr;
+    png_infop info_ptr = writer->info_ptr;
+    // set PNG write function - in this case, a function that writes to output
+    png_set_write_fn(png_ptr, writer, writer_write_data, dummy_png_flush);
+    // apply the compression level and filters, if they're not the defaults
+    if(writer->options.compression_level == SXBP_PNG_COMPRESSION_NONE) {
+        png_set_compression_level(png_ptr, 0);
+    } else if(writer->options.compression_level != 0) {
+        png_set_compression_level(png_ptr, writer->options.compression_level);
     }
-    // set PNG write function - in this case, a function that writes to buffer
-    png_set_write_fn(png_ptr, buffer, buffer_write_data, dummy_png_flush);
-    // Write header - specify a 1-bit grayscale image with adam7 interlacing
+    if(writer->options.filter != SXBP_PNG_FILTER_DEFAULT) {
+        png_set_filter(
+            png_ptr, PNG_FILTER_TYPE_BASE,
+            get_png_filters(writer->options.filter)
+        );
+    }
+    // Write header - specify a grayscale image with no interlacing
     png_set_IHDR(
-        png_ptr, info_ptr, bitmap.width, bitmap.height,
-        1, PNG_COLOR_TYPE_GRAY, PNG_INTERLACE_NONE,
+        png_ptr, info_ptr, width, height,
+        bit_depth, PNG_COLOR_TYPE_GRAY, PNG_INTERLACE_NONE,
         PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE
     );
-    // configure bit packing - 1 bit gray channel
+    // all of the bits of the gray channel are significant
     png_color_8 sig_bit;
-    sig_bit.gray = 1;
+    sig_bit.gray = bit_depth;
     png_set_sBIT(png_ptr, info_ptr, &sig_bit);
     // Set image metadata
-    png_text metadata[5]; // Author, Description, Copyright, Software, Comment
-    metadata[0].key = "Author";
-    metadata[0].text = "Joshua Saxby (https://github.com/saxbophone)";
-    metadata[1].key = "Description";
-    metadata[1].text = (
-        "Experimental generation of 2D spiralling lines based on input binary "
-        "data"
-    );
-    metadata[2].key = "Copyright";
-    metadata[2].text = "Copyright Joshua Saxby";
-    metadata[3].key = "Software";
-    // LIBSXBP_VERSION_STRING is a macro that expands to a double-quoted string
-    metadata[3].text = "libsxbp v" LIBSXBP_VERSION_STRING;
-    metadata[4].key = "Comment";
-    metadata[4].text = "https://github.com/saxbophone/libsxbp";
-    // set compression of each metadata key
-    for(uint8_t i = 0; i < 5; i++) {
+    png_text metadata[PNG_METADATA_COUNT];
+    for(uint8_t i = 0; i < PNG_METADATA_COUNT; i++) {
+        metadata[i].key = (png_charp)PNG_METADATA[i][0];
+        metadata[i].text = (png_charp)PNG_METADATA[i][1];
         metadata[i].compression = PNG_TEXT_COMPRESSION_NONE;
     }
     // write metadata
-    png_set_text(png_ptr, info_ptr, metadata, 5);
+    png_set_text(png_ptr, info_ptr, metadata, PNG_METADATA_COUNT);
     png_write_info(png_ptr, info_ptr);
-    // set bit shift - TODO: Check if this is acutally needed
-    png_set_shift(png_ptr, &sig_bit);
-    // set bit packing
-    // NOTE: I'm pretty sure this bit is needed but worth checking
-    png_set_packing(png_ptr);
-    // Allocate memory for one row (1 byte per pixel - RGB)
-    row = (png_bytep) malloc(bitmap.width * sizeof(png_byte));
-    // catch malloc fail
-    if(row == NULL) {
+    /*
+     * 1-bit rows are given to libpng already packed, but they use 1 for black
+     * where PNG uses 0, so have libpng invert them as it writes them
+     */
+    if(bit_depth == 1) {
+        png_set_invert_mono(png_ptr);
+    }
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private function, writes out the given rows of pixels, which are already
+ * packed as the image's bit depth, each starting stride bytes after the last
+ */
+static sxbp_status_t write_png_rows(
+    png_writer_t* writer, const uint8_t* pixels, size_t stride, uint32_t rows
+) {
+    // libpng reports errors by jumping back to here
+    writer->error = SXBP_OPERATION_FAIL;
+    if(setjmp(png_jmpbuf(writer->png_ptr))) {
+        return writer->error;
+    }
+    for(uint32_t y = 0; y < rows; y++) {
+        png_write_row(writer->png_ptr, pixels + (y * stride));
+    }
+    return SXBP_OPERATION_OK;
+}
+
+// private function, writes out everything that comes after the rows
+static sxbp_status_t finish_png(png_writer_t* writer) {
+    // libpng reports errors by jumping back to here
+    writer->error = SXBP_OPERATION_FAIL;
+    if(setjmp(png_jmpbuf(writer->png_ptr))) {
+        return writer->error;
+    }
+    // End write
+    png_write_end(writer->png_ptr, NULL);
+    return SXBP_OPERATION_OK;
+}
+#else
+/*
+ * Without libpng, images are written by the following small encoder instead,
+ * which stores the image data in uncompressed deflate blocks. The images are
+ * larger than libpng would make them, but just as valid.
+ */
+
+// the largest number of bytes a stored deflate block can hold
+#define STORED_BLOCK_MAX_SIZE 65535
+
+// simple cleanup function for freeing the writer's memory
+static void cleanup_png_writer(png_writer_t* writer) {
+    sxbp_free(writer->row);
+    writer->row = NULL;
+}
+
+/*
+ * private function, writes some of the image data of the current IDAT chunk,
+ * starting a new stored block whenever the current one is full
+ */
+static sxbp_status_t write_stored_data(
+    png_writer_t* writer, const uint8_t* data, size_t size
+) {
+    sxbp_status_t result = SXBP_OPERATION_OK;
+    writer->adler = sxbp_adler32(writer->adler, data, size);
+    while((size > 0) && (result == SXBP_OPERATION_OK)) {
+        if(writer->block_left == 0) {
+            // the block holds as much of the rest of the chunk's data as fits
+            size_t length = (
+                (writer->chunk_left < STORED_BLOCK_MAX_SIZE) ?
+                writer->chunk_left : STORED_BLOCK_MAX_SIZE
+            );
+            // not final, no compression, then the length and its complement
+            uint8_t header[5] = {
+                0x00,
+                (uint8_t)length, (uint8_t)(length >> 8),
+                (uint8_t)~length, (uint8_t)(~length >> 8),
+            };
+            result = write_chunk_data(writer, header, 5);
+            writer->block_left = length;
+        }
+        size_t part = (size < writer->block_left) ? size : writer->block_left;
+        if(result == SXBP_OPERATION_OK) {
+            result = write_chunk_data(writer, data, part);
+        }
+        data += part;
+        size -= part;
+        writer->block_left -= part;
+        writer->chunk_left -= part;
+    }
+    return result;
+}
+
+/*
+ * private function, writes out the start of a greyscale PNG image of the given
+ * size and bit depth (1 or 8) - the compression level and filter options don't
+ * apply to this encoder, so are ignored. The writer must be cleaned up
+ * afterwards, whether this succeeds or not.
+ */
+static sxbp_status_t start_png(
+    png_writer_t* writer, uint32_t width, uint32_t height, uint8_t bit_depth
+) {
+    writer->row_bytes = (((size_t)width * bit_depth) + 7) / 8;
+    writer->invert = (bit_depth == 1);
+    writer->adler = 1;
+    writer->row = sxbp_malloc(writer->row_bytes + 1);
+    if(writer->row == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    return write_png_header(writer, width, height, bit_depth);
+}
+
+/*
+ * private function, writes out the given rows of pixels, which are already
+ * packed as the image's bit depth, each starting stride bytes after the last.
+ * The rows are written in IDAT chunks of about IDAT_CHUNK_SIZE bytes.
+ */
+static sxbp_status_t write_png_rows(
+    png_writer_t* writer, const uint8_t* pixels, size_t stride, uint32_t rows
+) {
+    sxbp_status_t result = SXBP_OPERATION_OK;
+    size_t row_size = writer->row_bytes + 1;
+    size_t rows_per_chunk = IDAT_CHUNK_SIZE / row_size;
+    if(rows_per_chunk == 0) {
+        rows_per_chunk = 1;
+    }
+    uint32_t y = 0;
+    while((y < rows) && (result == SXBP_OPERATION_OK)) {
+        size_t count = rows - y;
+        if(count > rows_per_chunk) {
+            count = rows_per_chunk;
+        }
+        // the chunk's length includes the headers of its stored blocks
+        writer->chunk_left = count * row_size;
+        writer->block_left = 0;
+        size_t block_count = (
+            (writer->chunk_left + STORED_BLOCK_MAX_SIZE - 1) /
+            STORED_BLOCK_MAX_SIZE
+        );
+        size_t length = writer->chunk_left + (block_count * 5);
+        // the zlib header comes before the first of the image data
+        if(!writer->started) {
+            length += 2;
+        }
+        result = start_chunk(writer, "IDAT", (uint32_t)length);
+        if((result == SXBP_OPERATION_OK) && !writer->started) {
+            // deflate with a 32KiB window, no dictionary, fastest compression
+            const uint8_t zlib_header[2] = { 0x78, 0x01, };
+            result = write_chunk_data(writer, zlib_header, 2);
+            writer->started = true;
+        }
+        for(size_t i = 0; (i < count) && (result == SXBP_OPERATION_OK); i++) {
+            const uint8_t* source = pixels + ((y + i) * stride);
+            // no filtering
+            writer->row[0] = 0;
+            for(size_t b = 0; b < writer->row_bytes; b++) {
+                writer->row[b + 1] = (uint8_t)(
+                    writer->invert ? ~source[b] : source[b]
+                );
+            }
+            result = write_stored_data(writer, writer->row, row_size);
+        }
+        if(result == SXBP_OPERATION_OK) {
+            result = end_chunk(writer);
+        }
+        y += (uint32_t)count;
+    }
+    return result;
+}
+
+// private function, writes out everything that comes after the rows
+static sxbp_status_t finish_png(png_writer_t* writer) {
+    // an empty final block then the checksum of the image data end the stream
+    uint8_t end[11] = { 0x78, 0x01, 0x01, 0x00, 0x00, 0xff, 0xff, };
+    store_uint32_t(writer->adler, end + 7);
+    sxbp_status_t result = (
+        writer->started ?
+        write_chunk(writer, "IDAT", end + 2, 9) :
+        write_chunk(writer, "IDAT", end, 11)
+    );
+    if(result == SXBP_OPERATION_OK) {
+        result = write_chunk(writer, "IEND", NULL, 0);
+    }
+    return result;
+}
+#endif // LIBSXBP_PNG_SUPPORT
+
+/*
+ * private function, writes a whole image from the given rows of pixels (which
+ * are already packed as the image's bit depth) to the writer's buffer. The
+ * buffer is left empty if this fails (a fixed buffer is kept, but its size is
+ * set to 0).
+ */
+static sxbp_status_t write_png_image(
+    png_writer_t* writer, uint32_t width, uint32_t height, uint8_t bit_depth,
+    const uint8_t* pixels, size_t stride
+) {
+    // init buffer
+    writer->buffer->size = 0;
+    sxbp_status_t result = start_png(writer, width, height, bit_depth);
+    if(result == SXBP_OPERATION_OK) {
+        result = write_png_rows(writer, pixels, stride, height);
+    }
+    if(result == SXBP_OPERATION_OK) {
+        result = finish_png(writer);
+    }
+    // cleanup
+    cleanup_png_writer(writer);
+    if(result == SXBP_OPERATION_OK) {
+        shrink_output(writer);
+    } else {
+        // don't leave a partially written image behind
+        if(!writer->fixed) {
+            sxbp_free(writer->buffer->bytes);
+            writer->buffer->bytes = NULL;
+        }
+        writer->buffer->size = 0;
+    }
+    return result;
+}
+
+/*
+ * private row sink which starts the PNG image before the first band, writes
+ * out the rows of each band as they come and finishes the image after the last
+ * band, using the png_writer_t given as user_data
+ */
+static sxbp_status_t write_png_band(
+    sxbp_bitmap_t band, uint32_t first_row, uint32_t image_height,
+    void* user_data
+) {
+    png_writer_t* writer = (png_writer_t*)user_data;
+    sxbp_status_t result = SXBP_OPERATION_OK;
+    if(first_row == 0) {
+        result = start_png(writer, band.width, image_height, 1);
+    }
+    if(result == SXBP_OPERATION_OK) {
+        result = write_png_rows(writer, band.pixels, band.stride, band.height);
+    }
+    if(
+        (result == SXBP_OPERATION_OK) &&
+        (first_row + band.height == image_height)
+    ) {
+        result = finish_png(writer);
+    }
+    return result;
+}
+
+#ifdef LIBSXBP_PNG_SUPPORT
+/*
+ * The parallel encoder splits the image into strips of rows and deflates each
+ * strip on its own thread, as pigz does. Every strip but the last ends with a
+ * sync flush, which finishes its last block on a byte boundary without ending
+ * the stream, so the strips can just be joined one after the other to make a
+ * single zlib stream. Each strip is primed with the end of the strip before it,
+ * so that it compresses almost as well as if the image was deflated in one go.
+ */
+
+// how far back a deflate stream can refer to data it has already seen
+#define DEFLATE_WINDOW_SIZE 32768
+
+// the least image data worth deflating on a thread of its own
+#define MIN_STRIP_SIZE (128 * 1024)
+
+/*
+ * deflateBound() doesn't allow for a sync flush, which adds an empty stored
+ * block (up to 5 bytes after a partial byte) - this leaves room for it
+ */
+#define SYNC_FLUSH_MAX_SIZE 6
+
+// private type holding one strip of the image once it has been deflated
+typedef struct png_strip_t {
+    // the compressed data of this strip
+    uint8_t* bytes;
+    size_t size;
+    // the checksum of the data of this strip before it was compressed
+    uint32_t adler;
+} png_strip_t;
+
+// private type holding everything the strip jobs share
+typedef struct parallel_png_t {
+    sxbp_bitmap_t bitmap;
+    // the zlib compression level to use
+    int level;
+    // the number of bytes in each row of the image, including the filter type
+    size_t row_size;
+    uint32_t rows_per_strip;
+    size_t strip_count;
+    png_strip_t* strips;
+} parallel_png_t;
+
+// disable GCC warning about the unused parameter, zlib's opaque pointer
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+// private custom zlib memory functions, which use the library's allocator
+static voidpf zlib_allocate(voidpf opaque, uInt items, uInt size) {
+    return sxbp_calloc(items, size);
+}
+
+static void zlib_deallocate(voidpf opaque, voidpf pointer) {
+    sxbp_free(pointer);
+}
+// re-enable all warnings
+#pragma GCC diagnostic pop
+
+/*
+ * private function, stores row y of the bitmap as it is stored in the PNG
+ * image - led by its filter type (none) and inverted, as 0 is black in PNG
+ */
+static void store_png_row(
+    const parallel_png_t* image, uint32_t y, uint8_t* row
+) {
+    const uint8_t* source = image->bitmap.pixels + (y * image->bitmap.stride);
+    row[0] = 0;
+    for(size_t b = 1; b < image->row_size; b++) {
+        row[b] = (uint8_t)~source[b - 1];
+    }
+}
+
+/*
+ * private function, primes the deflate stream of the strip starting at the
+ * given row with the image data that comes just before it
+ */
+static sxbp_status_t prime_strip(
+    const parallel_png_t* image, uint32_t first_row, z_stream* stream
+) {
+    size_t rows = (DEFLATE_WINDOW_SIZE + image->row_size - 1) / image->row_size;
+    if(rows > first_row) {
+        rows = first_row;
+    }
+    uint8_t* window = sxbp_malloc(rows * image->row_size);
+    if(window == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    for(size_t i = 0; i < rows; i++) {
+        store_png_row(
+            image, first_row - (uint32_t)(rows - i),
+            window + (i * image->row_size)
+        );
+    }
+    // only the last window's worth of the data can be referred to
+    size_t size = rows * image->row_size;
+    size_t skip = (size > DEFLATE_WINDOW_SIZE) ? size - DEFLATE_WINDOW_SIZE : 0;
+    int status = deflateSetDictionary(
+        stream, window + skip, (uInt)(size - skip)
+    );
+    sxbp_free(window);
+    return (status == Z_OK) ? SXBP_OPERATION_OK : SXBP_OPERATION_FAIL;
+}
+
+/*
+ * private job which deflates one strip of the image, given by the job index,
+ * using the parallel_png_t given as user_data. Room is left before the first
+ * strip for the zlib header and after the last strip for the checksum.
+ */
+static sxbp_status_t deflate_strip(size_t strip_index, void* user_data) {
+    parallel_png_t* image = (parallel_png_t*)user_data;
+    png_strip_t* strip = &image->strips[strip_index];
+    uint32_t first_row = (uint32_t)strip_index * image->rows_per_strip;
+    uint32_t last_row = first_row + image->rows_per_strip;
+    if(last_row > image->bitmap.height) {
+        last_row = image->bitmap.height;
+    }
+    bool last_strip = (strip_index + 1 == image->strip_count);
+    size_t head = (strip_index == 0) ? 2 : 0;
+    size_t tail = last_strip ? 4 : 0;
+    // raw deflate data, as the strips are joined into one zlib stream later
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    stream.zalloc = zlib_allocate;
+    stream.zfree = zlib_deallocate;
+    int status = deflateInit2(
+        &stream, image->level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY
+    );
+    if(status != Z_OK) {
+        return (
+            (status == Z_MEM_ERROR) ? SXBP_MALLOC_REFUSED : SXBP_OPERATION_FAIL
+        );
+    }
+    sxbp_status_t result = SXBP_OPERATION_OK;
+    if(first_row > 0) {
+        result = prime_strip(image, first_row, &stream);
+    }
+    size_t capacity = head + tail + SYNC_FLUSH_MAX_SIZE + deflateBound(
+        &stream, (uLong)((last_row - first_row) * image->row_size)
+    );
+    uint8_t* row = sxbp_malloc(image->row_size);
+    strip->bytes = sxbp_malloc(capacity);
+    if(
+        (result == SXBP_OPERATION_OK) &&
+        ((row == NULL) || (strip->bytes == NULL))
+    ) {
         result = SXBP_MALLOC_REFUSED;
-        // cleanup
-        cleanup_png_lib(png_ptr, info_ptr, row);
-        return result;
     }
-    // Write image data
-    for(size_t y = 0 ; y < bitmap.height; y++) {
-        for(size_t x = 0; x < bitmap.width; x++) {
-            // set to black if there is a point here, white if not
-            row[x] = bitmap.pixels[x][y] ? 0 : 1;
+    if(result == SXBP_OPERATION_OK) {
+        stream.next_out = strip->bytes + head;
+        stream.avail_out = (uInt)(capacity - head - tail);
+        strip->adler = adler32(0, Z_NULL, 0);
+        for(uint32_t y = first_row; (y < last_row) && (status == Z_OK); y++) {
+            store_png_row(image, y, row);
+            strip->adler = adler32(strip->adler, row, (uInt)image->row_size);
+            stream.next_in = row;
+            stream.avail_in = (uInt)image->row_size;
+            status = deflate(&stream, Z_NO_FLUSH);
+            // there's always room for the output, so all the input is taken
+            if(stream.avail_in != 0) {
+                status = Z_BUF_ERROR;
+            }
+        }
+        if(status == Z_OK) {
+            status = deflate(&stream, last_strip ? Z_FINISH : Z_SYNC_FLUSH);
         }
-       png_write_row(png_ptr, row);
+        // a sync flush has only finished if it didn't run out of room
+        if(
+            (status != (last_strip ? Z_STREAM_END : Z_OK)) ||
+            (stream.avail_out == 0)
+        ) {
+            result = SXBP_OPERATION_FAIL;
+        }
+        strip->size = (size_t)(stream.next_out - strip->bytes) + tail;
     }
-    // End write
-    png_write_end(png_ptr, NULL);
+    deflateEnd(&stream);
+    sxbp_free(row);
+    return result;
+}
+
+// private function, writes the given image data out in one or more IDAT chunks
+static sxbp_status_t write_idat_chunks(
+    png_writer_t* writer, const uint8_t* data, size_t size
+) {
+    sxbp_status_t result = SXBP_OPERATION_OK;
+    while((size > 0) && (result == SXBP_OPERATION_OK)) {
+        size_t part = (size < IDAT_CHUNK_SIZE) ? size : IDAT_CHUNK_SIZE;
+        result = write_chunk(writer, "IDAT", data, (uint32_t)part);
+        data += part;
+        size -= part;
+    }
+    return result;
+}
+
+/*
+ * private function, writes a whole 1-bit image from the given bitmap to the
+ * writer's buffer, deflating strips of it on up to thread_count threads at
+ * once.
+ * The writer's filter option doesn't apply to this, as the rows are always left
+ * unfiltered (which is what libpng does by default for 1-bit images anyway).
+ * The buffer is left empty if this fails.
+ */
+static sxbp_status_t write_png_image_in_parallel(
+    png_writer_t* writer, sxbp_bitmap_t bitmap, size_t thread_count
+) {
+    parallel_png_t image = {
+        .bitmap = bitmap,
+        .level = Z_DEFAULT_COMPRESSION,
+        .row_size = (((size_t)bitmap.width + 7) / 8) + 1,
+    };
+    if(writer->options.compression_level == SXBP_PNG_COMPRESSION_NONE) {
+        image.level = 0;
+    } else if(writer->options.compression_level != 0) {
+        image.level = writer->options.compression_level;
+    }
+    // one strip per thread, unless that would make the strips too small
+    size_t min_rows = MIN_STRIP_SIZE / image.row_size;
+    if(min_rows == 0) {
+        min_rows = 1;
+    }
+    size_t strip_count = (bitmap.height + min_rows - 1) / min_rows;
+    if(strip_count > thread_count) {
+        strip_count = thread_count;
+    }
+    if(strip_count == 0) {
+        strip_count = 1;
+    }
+    image.rows_per_strip = (uint32_t)(
+        (bitmap.height + strip_count - 1) / strip_count
+    );
+    // rounding the rows per strip up may leave fewer strips needed
+    if(image.rows_per_strip > 0) {
+        strip_count = (
+            (bitmap.height + image.rows_per_strip - 1) / image.rows_per_strip
+        );
+    }
+    image.strip_count = strip_count;
+    image.strips = sxbp_calloc(strip_count, sizeof(png_strip_t));
+    if(image.strips == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    sxbp_status_t result = sxbp_run_parallel_jobs(
+        strip_count, thread_count, deflate_strip, (void*)&image
+    );
+    if(result == SXBP_OPERATION_OK) {
+        // deflate with a 32KiB window and no dictionary
+        image.strips[0].bytes[0] = 0x78;
+        image.strips[0].bytes[1] = 0x9c;
+        // the checksum of the whole image data is made from those of the strips
+        uLong adler = image.strips[0].adler;
+        for(size_t i = 1; i < strip_count; i++) {
+            uint32_t first_row = (uint32_t)i * image.rows_per_strip;
+            uint32_t rows = bitmap.height - first_row;
+            if(rows > image.rows_per_strip) {
+                rows = image.rows_per_strip;
+            }
+            adler = adler32_combine(
+                adler, image.strips[i].adler, (z_off_t)(rows * image.row_size)
+            );
+        }
+        png_strip_t* last = &image.strips[strip_count - 1];
+        store_uint32_t((uint32_t)adler, last->bytes + last->size - 4);
+        writer->buffer->size = 0;
+        result = write_png_header(writer, bitmap.width, bitmap.height, 1);
+        for(
+            size_t i = 0; (i < strip_count) && (result == SXBP_OPERATION_OK); i++
+        ) {
+            result = write_idat_chunks(
+                writer, image.strips[i].bytes, image.strips[i].size
+            );
+        }
+        if(result == SXBP_OPERATION_OK) {
+            result = write_chunk(writer, "IEND", NULL, 0);
+        }
+    }
+    // cleanup
+    for(size_t i = 0; i < strip_count; i++) {
+        sxbp_free(image.strips[i].bytes);
+    }
+    sxbp_free(image.strips);
+    if(result == SXBP_OPERATION_OK) {
+        shrink_output(writer);
+    } else {
+        // don't leave a partially written image behind
+        sxbp_free(writer->buffer->bytes);
+        writer->buffer->bytes = NULL;
+        writer->buffer->size = 0;
+    }
+    return result;
+}
+#else
+// disable GCC warning about the unused parameter, as there's only one thread
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+/*
+ * private function, without libpng this just writes the image as usual - the
+ * built-in encoder doesn't compress, so there's no work worth sharing out
+ */
+static sxbp_status_t write_png_image_in_parallel(
+    png_writer_t* writer, sxbp_bitmap_t bitmap, size_t thread_count
+) {
+    return write_png_image(
+        writer, bitmap.width, bitmap.height, 1, bitmap.pixels, bitmap.stride
+    );
+}
+// re-enable all warnings
+#pragma GCC diagnostic pop
+#endif // LIBSXBP_PNG_SUPPORT
+
+// flag for whether libpng support has been compiled in based, on macro
+#ifdef LIBSXBP_PNG_SUPPORT
+const bool SXBP_PNG_SUPPORT = true;
+#else
+const bool SXBP_PNG_SUPPORT = false;
+#endif
+
+sxbp_status_t sxbp_render_backend_png(
+    sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
+) {
+    // preconditional assertsions
+    assert(bitmap.pixels != NULL);
+    assert(buffer->bytes == NULL);
+    // use the default options
+    sxbp_png_options_t options = {
+        .compression_level = 0, .filter = SXBP_PNG_FILTER_DEFAULT,
+    };
+    return sxbp_render_backend_png_with_options(bitmap, options, buffer);
+}
+
+sxbp_status_t sxbp_render_backend_png_with_options(
+    sxbp_bitmap_t bitmap, sxbp_png_options_t options, sxbp_buffer_t* buffer
+) {
+    // preconditional assertsions
+    assert(bitmap.pixels != NULL);
+    assert(buffer->bytes == NULL);
+    png_writer_t writer = init_png_writer(buffer, NULL, NULL, options);
+    // the bitmap's rows are already packed as 1-bit PNG rows
+    return write_png_image(
+        &writer, bitmap.width, bitmap.height, 1, bitmap.pixels, bitmap.stride
+    );
+}
+
+size_t sxbp_get_png_max_size(uint32_t width, uint32_t height) {
+    // each row is led by its filter type byte
+    size_t raw_size = (((size_t)width + 7) / 8 + 1) * height;
+    /*
+     * the most the image data can grow by when deflated, whatever the options
+     * (as zlib's compressBound() works it out, but more loosely - the built-in
+     * encoder's stored blocks fit in this too), plus the zlib header and
+     * checksum and the headers of the first and last deflate blocks
+     */
+    size_t data_size = raw_size + ((raw_size + 7) / 8) + (
+        (raw_size + 63) / 64
+    ) + 6 + 10;
+    /*
+     * the data may be split into IDAT chunks as small as 1KiB, each of which
+     * has 12 bytes of length, type and checksum, plus there may be one more
+     * chunk at either end
+     */
+    size_t size = data_size + (12 * ((data_size / 1024) + 2));
+    // signature, IHDR, sBIT, then IEND at the end
+    size += 8 + (12 + 13) + (12 + 1) + 12;
+    // each metadata entry is its key and text, separated by a null byte
+    for(uint8_t i = 0; i < PNG_METADATA_COUNT; i++) {
+        size += 12 + strlen(PNG_METADATA[i][0]) + 1 + strlen(
+            PNG_METADATA[i][1]
+        );
+    }
+    return size;
+}
+
+sxbp_status_t sxbp_render_backend_png_into(
+    sxbp_bitmap_t bitmap, sxbp_png_options_t options, sxbp_buffer_t* buffer
+) {
+    // preconditional assertsions
+    assert(bitmap.pixels != NULL);
+    assert(buffer->bytes != NULL);
+    png_writer_t writer = init_png_writer(buffer, NULL, NULL, options);
+    // the image is written over whatever is in the buffer, which can't grow
+    writer.capacity = buffer->size;
+    writer.fixed = true;
+    return write_png_image(
+        &writer, bitmap.width, bitmap.height, 1, bitmap.pixels, bitmap.stride
+    );
+}
+
+sxbp_status_t sxbp_render_backend_png_threaded(
+    sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
+) {
+    // preconditional assertsions
+    assert(bitmap.pixels != NULL);
+    assert(buffer->bytes == NULL);
+    // use the default options and one thread per processor
+    sxbp_png_options_t options = {
+        .compression_level = 0, .filter = SXBP_PNG_FILTER_DEFAULT,
+    };
+    return sxbp_render_backend_png_in_parallel(
+        bitmap, options, sxbp_get_processor_count(), buffer
+    );
+}
+
+sxbp_status_t sxbp_render_backend_png_in_parallel(
+    sxbp_bitmap_t bitmap, sxbp_png_options_t options, size_t thread_count,
+    sxbp_buffer_t* buffer
+) {
+    // preconditional assertsions
+    assert(bitmap.pixels != NULL);
+    assert(buffer->bytes == NULL);
+    png_writer_t writer = init_png_writer(buffer, NULL, NULL, options);
+    return write_png_image_in_parallel(&writer, bitmap, thread_count);
+}
+
+sxbp_status_t sxbp_render_backend_png_greyscale(
+    sxbp_greyscale_image_t image, sxbp_buffer_t* buffer
+) {
+    // preconditional assertsions
+    assert(image.pixels != NULL);
+    assert(buffer->bytes == NULL);
+    sxbp_png_options_t options = {
+        .compression_level = 0, .filter = SXBP_PNG_FILTER_DEFAULT,
+    };
+    png_writer_t writer = init_png_writer(buffer, NULL, NULL, options);
+    return write_png_image(
+        &writer, image.width, image.height, 8, image.pixels, image.width
+    );
+}
+
+sxbp_status_t sxbp_render_spiral_to_png_stream(
+    sxbp_spiral_t spiral, sxbp_render_options_t options,
+    uint32_t band_height,
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data),
+    void* user_data
+) {
+    // preconditional assertions
+    assert(spiral.lines != NULL);
+    assert(band_height != 0);
+    assert(write_callback != NULL);
+    sxbp_png_options_t png_options = {
+        .compression_level = 0, .filter = SXBP_PNG_FILTER_DEFAULT,
+    };
+    png_writer_t writer = init_png_writer(
+        NULL, write_callback, user_data, png_options
+    );
+    // the image is written out a band at a time as it is rendered
+    sxbp_status_t result = sxbp_render_spiral_rows(
+        spiral, options, band_height, write_png_band, (void*)&writer
+    );
     // cleanup
-    cleanup_png_lib(png_ptr, info_ptr, row);
-    // status ok
-    result = SXBP_OPERATION_OK;
+    cleanup_png_writer(&writer);
     return result;
-    #endif // LIBSXBP_PNG_SUPPORT
 }
 
 #ifdef __cplusplus
@@ -9,10 +9,12 @@
  * @brief This compilation unit provides functionality to render a bitmap struct
  * to a PNG image (stored in a buffer).
  * 
- * @note PNG output support may have not been enabled in the compiled version
- * of libsxbp that you have. If support is not enabled, the library
- * boolean constant SXBP_PNG_SUPPORT will be set to false and the one public
- * function defined in this unit will return SXBP_NOT_IMPLEMENTED.
+ * @note libpng support may have not been enabled in the compiled version of
+ * libsxbp that you have. If support is not enabled, the library boolean
+ * constant SXBP_PNG_SUPPORT will be set to false and the public functions
+ * defined in this unit will write images with a small built-in encoder
+ * instead, which stores the image data uncompressed. The images are still
+ * valid, but much larger.
  *
  * @author Joshua Saxby <joshua.a.saxby+TNOPLuc8vM==@gmail.com
  * @date 2016, 2017
@@ -28,6 +30,8 @@
 #define SAXBOPHONE_SAXBOSPIRAL_BACKEND_PNG_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "../saxbospiral.h"
 #include "../render.h"
@@ -40,19 +44,69 @@ extern "C"{
 /**
  * @brief Flag for whether PNG output support has been enabled.
  * @details This is compiled into the library, based on a macro set at build
- * time. The value of this constant is false if PNG support is not enabled and
- * true if it is.
+ * time. The value of this constant is false if libpng support is not enabled
+ * and true if it is. PNG images can be written either way, but they are only
+ * compressed if it is true.
  */
 extern const bool SXBP_PNG_SUPPORT;
 
+/**
+ * @brief Value of sxbp_png_options_t.compression_level which stores the image
+ * data without compressing it at all.
+ */
+#define SXBP_PNG_COMPRESSION_NONE 10
+
+/**
+ * @brief The filters which may be applied to each row of a PNG image before
+ * it is compressed.
+ * @details Filters can make images compress better, at the cost of taking
+ * longer to encode.
+ */
+typedef enum sxbp_png_filter_t {
+    /** @brief let libpng choose (this is no filtering for 1-bit images) */
+    SXBP_PNG_FILTER_DEFAULT,
+    /** @brief no filtering, the fastest */
+    SXBP_PNG_FILTER_NONE,
+    /** @brief each byte less the one to its left */
+    SXBP_PNG_FILTER_SUB,
+    /** @brief each byte less the one above it */
+    SXBP_PNG_FILTER_UP,
+    /** @brief each byte less the average of the ones left and above it */
+    SXBP_PNG_FILTER_AVERAGE,
+    /** @brief each byte less a prediction from the bytes around it */
+    SXBP_PNG_FILTER_PAETH,
+    /** @brief try every filter on each row and use the best, the slowest */
+    SXBP_PNG_FILTER_ALL,
+} sxbp_png_filter_t;
+
+/**
+ * @brief Options for trading the size of PNG images for encoding speed.
+ * @details A zero-initialised instance of this struct gives the default
+ * behaviour, which is the same as that of sxbp_render_backend_png(). These
+ * options only apply if libpng support is enabled (see SXBP_PNG_SUPPORT).
+ */
+typedef struct sxbp_png_options_t {
+    /**
+     * @brief How hard to try to compress the image.
+     * @details 0 means libpng's default. Otherwise, 1 (fastest) to 9
+     * (smallest), or SXBP_PNG_COMPRESSION_NONE to not compress it at all.
+     */
+    uint8_t compression_level;
+    /** @brief The filter to apply to the rows of the image */
+    sxbp_png_filter_t filter;
+} sxbp_png_options_t;
+
 /**
  * @brief Renders a bitmap image to a PNG image.
+ * @details The image is written as a 1-bit greyscale PNG image. The bitmap's
+ * rows are already packed the same way as PNG rows, so they are passed to the
+ * encoder as they are rather than a pixel at a time.
  *
  * @param bitmap Bitmap containing the image to render.
- * @param[out] buffer Buffer to write out the PBM image data to.
+ * @param[out] buffer Buffer to write out the PNG image data to.
  * @return SXBP_OPERATION_OK on success.
- * @return SXBP_NOT_IMPLEMENTED if PNG support has not been enabled.
  * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_OPERATION_FAIL on other libpng errors.
  *
  * @note Asserts:
  * - That bitmap.pixels is not NULL
@@ -62,6 +116,178 @@ sxbp_status_t sxbp_render_backend_png(
     sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
 );
 
+/**
+ * @brief Renders a bitmap image to a PNG image, with the given options.
+ * @details As sxbp_render_backend_png(), but with control over how the image
+ * is compressed.
+ *
+ * @param bitmap Bitmap containing the image to render.
+ * @param options The compression options to use.
+ * @param[out] buffer Buffer to write out the PNG image data to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_OPERATION_FAIL on other libpng errors.
+ *
+ * @note Asserts:
+ * - That bitmap.pixels is not NULL
+ * - That buffer->bytes is NULL
+ */
+sxbp_status_t sxbp_render_backend_png_with_options(
+    sxbp_bitmap_t bitmap, sxbp_png_options_t options, sxbp_buffer_t* buffer
+);
+
+/**
+ * @brief Gets the most bytes a PNG image of the given size can take up.
+ * @details Unlike the other image formats, the size of a PNG image depends on
+ * how well its pixels compress, so this is an upper bound on the size of the
+ * image written by sxbp_render_backend_png_into() (or by
+ * sxbp_render_backend_png_with_options()) whatever its pixels and options are.
+ * A buffer this big always has room for the image.
+ *
+ * @param width The width of the image in pixels.
+ * @param height The height of the image in pixels.
+ * @return The largest size the PNG image can be in bytes.
+ */
+size_t sxbp_get_png_max_size(uint32_t width, uint32_t height);
+
+/**
+ * @brief Renders a bitmap image to a PNG image, in a buffer provided by the
+ * caller.
+ * @details Writes exactly the same image as
+ * sxbp_render_backend_png_with_options() would, but into memory the caller
+ * already has rather than a newly allocated buffer. Use sxbp_get_png_max_size()
+ * to find out how big the buffer needs to be to be sure the image fits.
+ *
+ * @param bitmap Bitmap containing the image to render.
+ * @param options The compression options to use.
+ * @param[in, out] buffer Buffer to write out the PNG image data to. Its size
+ * should be the number of bytes available at buffer->bytes. On success, this
+ * is set to the number of bytes written, which start at buffer->bytes.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_OPERATION_FAIL if the buffer is too small, in which case its
+ * size is set to 0 (the bytes in it may have been overwritten), or on other
+ * libpng errors.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ *
+ * @note Asserts:
+ * - That bitmap.pixels is not NULL
+ * - That buffer->bytes is not NULL
+ */
+sxbp_status_t sxbp_render_backend_png_into(
+    sxbp_bitmap_t bitmap, sxbp_png_options_t options, sxbp_buffer_t* buffer
+);
+
+/**
+ * @brief Renders a bitmap image to a PNG image, compressing it on one thread
+ * per processor.
+ * @details This is sxbp_render_backend_png_in_parallel() with the default
+ * options and the number of threads given by sxbp_get_processor_count(). Like
+ * sxbp_render_backend_png(), it can be passed to sxbp_render_spiral_image().
+ *
+ * @param bitmap Bitmap containing the image to render.
+ * @param[out] buffer Buffer to write out the PNG image data to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_OPERATION_FAIL on other zlib errors.
+ *
+ * @note Asserts:
+ * - That bitmap.pixels is not NULL
+ * - That buffer->bytes is NULL
+ */
+sxbp_status_t sxbp_render_backend_png_threaded(
+    sxbp_bitmap_t bitmap, sxbp_buffer_t* buffer
+);
+
+/**
+ * @brief Renders a bitmap image to a PNG image, compressing strips of it on
+ * several threads at once.
+ * @details The rows of the image are split into one strip per thread, and each
+ * strip is compressed on its own. The strips are then joined back together
+ * into one stream of image data, so the image is a normal PNG image which
+ * decodes to exactly the same pixels as that made by
+ * sxbp_render_backend_png_with_options(). It may be very slightly larger, and
+ * the rows are always left unfiltered, so the filter option is ignored.
+ *
+ * @param bitmap Bitmap containing the image to render.
+ * @param options The compression options to use.
+ * @param thread_count The maximum number of threads to use. 0 or 1 means do
+ * all the work on the calling thread.
+ * @param[out] buffer Buffer to write out the PNG image data to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_OPERATION_FAIL on other zlib errors.
+ *
+ * @note Without libpng support (see SXBP_PNG_SUPPORT) the image data isn't
+ * compressed, so this just writes the image on the calling thread.
+ *
+ * @note Asserts:
+ * - That bitmap.pixels is not NULL
+ * - That buffer->bytes is NULL
+ */
+sxbp_status_t sxbp_render_backend_png_in_parallel(
+    sxbp_bitmap_t bitmap, sxbp_png_options_t options, size_t thread_count,
+    sxbp_buffer_t* buffer
+);
+
+/**
+ * @brief Writes out a greyscale image as an 8-bit greyscale PNG image.
+ * @details This is intended for previews made with
+ * sxbp_render_spiral_thumbnail().
+ *
+ * @param image The greyscale image to write out.
+ * @param[out] buffer The buffer to write the PNG data to.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_OPERATION_FAIL on other libpng errors.
+ *
+ * @note Asserts:
+ * - That image.pixels is not NULL
+ * - That buffer->bytes is NULL
+ */
+sxbp_status_t sxbp_render_backend_png_greyscale(
+    sxbp_greyscale_image_t image, sxbp_buffer_t* buffer
+);
+
+/**
+ * @brief Renders a spiral to a PNG image, streaming the image out as it is
+ * rendered.
+ * @details The spiral is rendered a band of rows at a time with
+ * sxbp_render_spiral_rows(), and each band's rows are compressed and written
+ * out via the write callback as soon as it has been drawn, so the whole image
+ * never has to be held in memory. The image is the same as that produced by
+ * rendering the spiral with sxbp_render_spiral_raw_with_options() and
+ * sxbp_render_backend_png().
+ *
+ * @param spiral The spiral which should be rendered.
+ * @param options The options to render the spiral with (see
+ * sxbp_render_options_t).
+ * @param band_height The maximum number of rows to render at once.
+ * @param write_callback A function pointer with the following signature:
+ * @code
+ * size_t callback_name(const uint8_t* data, size_t size, void* user_data)
+ * @endcode
+ * The callback should write out all size bytes of data, returning the number
+ * of bytes actually written. Returning anything less than size is treated as
+ * an error, after which the callback will not be called again.
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the write callback every time it is called (such as a file handle).
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_OPERATION_FAIL if the write callback didn't write all the data.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to address.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That band_height is not 0
+ * - That write_callback is not NULL
+ */
+sxbp_status_t sxbp_render_spiral_to_png_stream(
+    sxbp_spiral_t spiral, sxbp_render_options_t options,
+    uint32_t band_height,
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data),
+    void* user_data
+);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,148 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ *
+ * Copyright (C) 2016, 2017, Joshua Saxby joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <assert.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../saxbospiral.h"
+#include "../allocator.h"
+#include "../plot.h"
+#include "../render.h"
+#include "backend_svg.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/*
+ * the longest the parts of the SVG image around the path can be: the fixed
+ * text plus the width and height (each written three times), the start of the
+ * path (written as decimals with at most 1 decimal place) and the stroke width,
+ * allowing 24 chars for each of the numbers
+ */
+#define SVG_TEMPLATE_MAX_SIZE (384 + 10 * 24)
+
+/*
+ * the longest the command for one line of the path can be: 'h' or 'v' and a
+ * sign, followed by the length of the line in pixels - up to 20 digits long
+ */
+#define SVG_COMMAND_MAX_SIZE (2 + 20)
+
+/*
+ * private function, writes a number of pixels given in halves of a pixel to
+ * the given string as a decimal, returning the number of chars written
+ */
+static int write_half_pixels(char* output, uint64_t halves) {
+    return sprintf(
+        output, (halves % 2) ? "%" PRIu64 ".5" : "%" PRIu64, halves / 2
+    );
+}
+
+sxbp_status_t sxbp_render_spiral_to_svg(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, sxbp_buffer_t* buffer
+) {
+    // preconditional assertions
+    assert(spiral.lines != NULL);
+    assert(buffer->bytes == NULL);
+    // use the same defaults as the bitmap renderers
+    uint64_t scale = (options.scale == 0) ? 2 : options.scale;
+    uint64_t thickness = (options.thickness == 0) ? 1 : options.thickness;
+    // no co-ord can be further from the origin than all the lines put together
+    if(
+        (uintmax_t)sxbp_sum_lines(spiral, 0, spiral.size) >
+        (uintmax_t)SXBP_TUPLE_ITEM_MAX
+    ) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    // find the bounds of the spiral, from its co-ord cache if possible
+    sxbp_co_ord_t bounds[2];
+    sxbp_get_spiral_bounds(&spiral, bounds);
+    sxbp_co_ord_t min = bounds[0];
+    sxbp_co_ord_t max = bounds[1];
+    // the spans are worked out unsigned, as they may not fit in a co-ord
+    uint64_t span_x = (uint64_t)max.x - (uint64_t)min.x;
+    uint64_t span_y = (uint64_t)max.y - (uint64_t)min.y;
+    uint64_t span_max = (UINT64_MAX / 2 - thickness * 3) / scale;
+    size_t line_max = (SIZE_MAX - SVG_TEMPLATE_MAX_SIZE) / SVG_COMMAND_MAX_SIZE;
+    if(
+        (span_x > span_max) || (span_y > span_max) ||
+        (spiral.size > line_max)
+    ) {
+        return SXBP_SIZE_OVERFLOW;
+    }
+    // image size is the same as the bitmap renderers would make it
+    uint64_t width = span_x * scale + thickness * 3;
+    uint64_t height = span_y * scale + thickness * 3;
+    /*
+     * the path runs down the middle of each line, half the thickness in from
+     * the top-left of the pixels drawn for its co-ords. The y-axis is flipped
+     * so that up is towards the top of the image.
+     */
+    uint64_t start_x = (
+        (thickness + (0 - (uint64_t)min.x) * scale) * 2 + thickness
+    );
+    uint64_t start_y = (
+        (thickness + (uint64_t)max.y * scale) * 2 + thickness
+    );
+    // allocate enough for the longest the image could be, shrink it later
+    size_t max_size = (
+        SVG_TEMPLATE_MAX_SIZE + SVG_COMMAND_MAX_SIZE * (size_t)spiral.size
+    );
+    char* svg = sxbp_malloc(max_size);
+    if(svg == NULL) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    int index = sprintf(
+        svg,
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" "
+        "width=\"%" PRIu64 "\" height=\"%" PRIu64 "\" "
+        "viewBox=\"0 0 %" PRIu64 " %" PRIu64 "\">\n"
+        "<rect width=\"%" PRIu64 "\" height=\"%" PRIu64 "\" fill=\"white\"/>\n"
+        "<path fill=\"none\" stroke=\"black\" stroke-width=\"%" PRIu64 "\" "
+        "stroke-linecap=\"square\" d=\"M",
+        width, height, width, height, width, height, thickness
+    );
+    index += write_half_pixels(svg + index, start_x);
+    svg[index++] = ' ';
+    index += write_half_pixels(svg + index, start_y);
+    // one relative move per line, skipping any which have no length
+    size_t size = (size_t)index;
+    for(size_t i = 0; i < spiral.size; i++) {
+        sxbp_line_t line = spiral.lines[i];
+        if(line.length == 0) {
+            continue;
+        }
+        sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[line.direction];
+        uint64_t distance = line.length * scale;
+        size += (size_t)sprintf(
+            svg + size, "%c%s%" PRIu64,
+            (direction.x != 0) ? 'h' : 'v',
+            // up is negative in SVG, as the y-axis points down
+            ((direction.x < 0) || (direction.y > 0)) ? "-" : "",
+            distance
+        );
+    }
+    size += (size_t)sprintf(svg + size, "\"/>\n</svg>\n");
+    // give back the memory that wasn't needed
+    char* shrunk = sxbp_realloc(svg, size);
+    buffer->bytes = (uint8_t*)((shrunk != NULL) ? shrunk : svg);
+    buffer->size = size;
+    return SXBP_OPERATION_OK;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
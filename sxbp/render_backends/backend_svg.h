@@ -0,0 +1,75 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ */
+
+/**
+ * @file
+ *
+ * @brief This compilation unit provides functionality to render a spiral to an
+ * SVG image (stored in a buffer).
+ *
+ * @details Unlike the other backends, this one draws straight from the lines
+ * of the spiral rather than from a bitmap, so the size of the image grows with
+ * the number of lines rather than the area they cover.
+ *
+ * @remark Reference materials used for the SVG format are located at
+ * <https://www.w3.org/TR/SVG11/paths.html>
+ *
+ * @author Joshua Saxby <joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ * @date 2016, 2017
+ *
+ * @copyright Copyright (C) Joshua Saxby 2016, 2017
+ *
+ * @copyright
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef SAXBOPHONE_SAXBOSPIRAL_BACKEND_SVG_H
+#define SAXBOPHONE_SAXBOSPIRAL_BACKEND_SVG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../saxbospiral.h"
+#include "../render.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Renders a spiral to an SVG image.
+ * @details The whole spiral is drawn as a single path, starting at the origin
+ * and made up of one relative horizontal or vertical move per line. The image
+ * has the same size and the lines are in the same places as they would be in
+ * the bitmap produced by sxbp_render_spiral_raw_with_options(), with the
+ * options' thickness as the width of the path, so the two line up when one is
+ * drawn over the other. The only difference is that the path doesn't leave the
+ * small gap after the start of the first line that the bitmap does.
+ *
+ * @param spiral The spiral which should be rendered.
+ * @param options The options to render the spiral with (see
+ * sxbp_render_options_t).
+ * @param[out] buffer Buffer to write out the SVG image data to. This is text,
+ * but is not null-terminated.
+ * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_MALLOC_REFUSED on memory allocation failure.
+ * @return SXBP_SIZE_OVERFLOW if the image would be too big to write out.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That buffer->bytes is NULL
+ */
+sxbp_status_t sxbp_render_spiral_to_svg(
+    sxbp_spiral_t spiral, sxbp_render_options_t options, sxbp_buffer_t* buffer
+);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+// end of header file
+#endif
@@ -57,6 +57,13 @@ bool sxbp_version_equal_to(sxbp_version_t a, sxbp_version_t b) {
     );
 }
 
+// flag for whether wide mode has been compiled in, based on macro
+#ifdef LIBSXBP_WIDE_MODE
+const bool SXBP_WIDE_MODE = true;
+#else
+const bool SXBP_WIDE_MODE = false;
+#endif
+
 // vector direction constants
 const sxbp_vector_t SXBP_VECTOR_DIRECTIONS[4] = {
     // UP       RIGHT       DOWN        LEFT
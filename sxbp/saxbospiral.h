@@ -28,6 +28,8 @@
 #include <stdint.h>
 #include <time.h>
 
+#include "sxbp_config.h"
+
 
 #ifdef __cplusplus
 extern "C"{
@@ -91,8 +93,25 @@ typedef enum sxbp_status_t {
     SXBP_MALLOC_REFUSED, /**< memory allocation or re-allocation was refused */
     SXBP_IMPOSSIBLE_CONDITION, /**< condition thought to be impossible detected */
     SXBP_NOT_IMPLEMENTED, /**< function is not implemented / enabled */
+    SXBP_SIZE_OVERFLOW, /**< a count, size or co-ord is too big for its type */
 } sxbp_status_t;
 
+/**
+ * @brief Flag for whether wide mode has been enabled.
+ * @details This is compiled into the library, based on a macro set at build
+ * time. In wide mode, counts of lines (sxbp_line_count_t) and the items of
+ * co-ords (sxbp_tuple_item_t) are 64 bits wide instead of 32, so that spirals
+ * can be made from inputs of many gigabytes.
+ * @note These types are used in the library's structs, so whether wide mode is
+ * enabled is also recorded in the generated header sxbp_config.h, which defines
+ * LIBSXBP_WIDE_MODE if it is. This header is installed with the library and
+ * included by this one, so programs using the library always see the same types
+ * that it was built with. They can check this constant to make sure that they
+ * are linked against the same build of the library that they were compiled
+ * against.
+ */
+extern const bool SXBP_WIDE_MODE;
+
 /**
  * @brief Type for representing one of the cartesian directions.
  * @details This can be one of SXBP_UP, SXBP_RIGHT, SXBP_DOWN or SXBP_LEFT.
@@ -136,8 +155,32 @@ typedef struct sxbp_line_t {
     sxbp_length_t length : 30;
 } sxbp_line_t;
 
+/** @brief The largest length a line of a spiral can have (30 bits). */
+#define SXBP_LENGTH_MAX 0x3fffffffU
+
+#ifdef LIBSXBP_WIDE_MODE
+/** @brief Type for counting, and indexing, the lines of a spiral. */
+typedef uint64_t sxbp_line_count_t;
+/** @brief The largest number of lines a spiral can have. */
+#define SXBP_LINE_COUNT_MAX UINT64_MAX
+/** @brief Type for storing one of the items of a tuple. */
+typedef int64_t sxbp_tuple_item_t;
+/** @brief The smallest value an item of a tuple can have. */
+#define SXBP_TUPLE_ITEM_MIN INT64_MIN
+/** @brief The largest value an item of a tuple can have. */
+#define SXBP_TUPLE_ITEM_MAX INT64_MAX
+#else
+/** @brief Type for counting, and indexing, the lines of a spiral. */
+typedef uint32_t sxbp_line_count_t;
+/** @brief The largest number of lines a spiral can have. */
+#define SXBP_LINE_COUNT_MAX UINT32_MAX
 /** @brief Type for storing one of the items of a tuple. */
 typedef int32_t sxbp_tuple_item_t;
+/** @brief The smallest value an item of a tuple can have. */
+#define SXBP_TUPLE_ITEM_MIN INT32_MIN
+/** @brief The largest value an item of a tuple can have. */
+#define SXBP_TUPLE_ITEM_MAX INT32_MAX
+#endif
 
 /**
  * @brief A generic Tuple type for storing a vector-based quantity.
@@ -176,6 +219,16 @@ typedef struct sxbp_co_ord_cache_t {
     /** @brief the index of the spiral line for which this set of cached co-ords
      * is valid up to */
     size_t validity;
+    /**
+     * @brief the smallest (first item) and largest (second item) x and y of
+     * the co-ords of the first bounds_validity lines
+     * @details These are kept up to date by sxbp_cache_spiral_points() as
+     * lines are cached, so that the size of the spiral can be found without
+     * going over all of its lines again.
+     */
+    sxbp_co_ord_t bounds[2];
+    /** @brief the number of lines which bounds is valid for */
+    size_t bounds_validity;
 } sxbp_co_ord_cache_t;
 
 /**
@@ -188,7 +241,7 @@ typedef struct sxbp_co_ord_cache_t {
  */
 typedef struct sxbp_spiral_t {
     /** @brief count of lines in the spiral */
-    uint32_t size;
+    sxbp_line_count_t size;
     /** @brief dynamic array of lines in the spiral */
     sxbp_line_t* lines;
     /**
@@ -202,9 +255,9 @@ typedef struct sxbp_spiral_t {
      * @brief the index of the line causing collision, if any
      * @private
      */
-    uint32_t collider;
+    sxbp_line_count_t collider;
     /** @brief the count of lines solved so far (index of next line to solve) */
-    uint32_t solved_count;
+    sxbp_line_count_t solved_count;
     /**
      * @brief the count of seconds spent solving the spiral
      * @details This measures CPU compute-time, not wall-clock time. It is
@@ -9,12 +9,17 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "saxbospiral.h"
+#include "allocator.h"
+#include "checksum.h"
+#include "parallel.h"
+#include "plot.h"
 #include "serialise.h"
 
 
@@ -31,8 +36,70 @@ const size_t SXBP_FILE_HEADER_SIZE = (
     4 + // number of seconds spent solving, 32 bit uint
     4 // number of seconds accuracy of solve time, 32 bit uint
 );
+const size_t SXBP_EXTENDED_FILE_HEADER_SIZE = (
+    4 + // 'sxbx' file magic number
+    6 + // file version, 3x 16-bit uints
+    4 + // total number of lines, 32 bit uint
+    4 + // number of lines solved, 32 bit uint
+    4 + // number of seconds spent solving, 32 bit uint
+    4 + // number of seconds accuracy of solve time, 32 bit uint
+    4 // format flags, 32 bit uint (only FILE_FLAG_WIDE is defined)
+);
+const size_t SXBP_WIDE_FILE_HEADER_SIZE = (
+    4 + // 'sxbx' file magic number
+    6 + // file version, 3x 16-bit uints
+    4 + // total number of lines, 32 bit uint (always UINT32_MAX)
+    4 + // number of lines solved, 32 bit uint (always UINT32_MAX)
+    4 + // number of seconds spent solving, 32 bit uint
+    4 + // number of seconds accuracy of solve time, 32 bit uint
+    4 + // format flags, 32 bit uint (with FILE_FLAG_WIDE set)
+    8 + // total number of lines, 64 bit uint
+    8 // number of lines solved, 64 bit uint
+);
 const size_t SXBP_LINE_T_PACK_SIZE = 4;
 
+/*
+ * private constants for optional sections, which are stored after the lines in
+ * 'sxbx' files only. Each one is a 4-character tag followed by the size of the
+ * section's payload as a 32 bit uint, followed by the payload itself.
+ */
+static const size_t SECTION_HEADER_SIZE = 4 + 4;
+/*
+ * format flag of 'sxbx' files with too many lines to count in 32 bits, which
+ * have a larger header with 64 bit line counts after the flags
+ */
+static const uint32_t FILE_FLAG_WIDE = 0x00000001U;
+// tag of the section storing the co-ord cache
+static const char* CO_ORD_CACHE_SECTION_TAG = "cach";
+/*
+ * size of the co-ord cache payload, excluding the co-ords themselves:
+ * validity (32 bit uint) + co-ord count (32 bit uint) + CRC-32 (32 bit uint)
+ */
+static const size_t CO_ORD_CACHE_SECTION_BASE_SIZE = 4 + 4 + 4;
+// size of one cached co-ord - x and y as 32-bit signed ints
+static const size_t CO_ORD_PACK_SIZE = 8;
+// tag of the section storing the chunk index
+static const char* CHUNK_INDEX_SECTION_TAG = "indx";
+/*
+ * size of the chunk index payload, excluding the entries themselves:
+ * lines per chunk (32 bit uint) + chunk count (32 bit uint) + CRC-32 (32 bit
+ * uint)
+ */
+static const size_t CHUNK_INDEX_SECTION_BASE_SIZE = 4 + 4 + 4;
+/*
+ * size of one chunk index entry: byte offset of the chunk's first line in the
+ * file (64 bit uint) + co-ord the chunk starts at (2x 32 bit signed int) + sum
+ * of the lengths of all lines before the chunk (64 bit uint) + CRC-32 of the
+ * chunk's packed lines (32 bit uint)
+ */
+static const size_t CHUNK_INDEX_ENTRY_SIZE = 8 + 8 + 8 + 4;
+
+/*
+ * size of the fixed buffer used for staging data written to or read from
+ * streams - everything written or read in one go must fit within this
+ */
+#define STREAM_BUFFER_SIZE 4096
+
 /*
  * NOTE: The following load_x and dump_x functions all use big-endian
  * representation in their serialised forms.
@@ -79,7 +146,7 @@ static uint32_t load_uint32_t(sxbp_buffer_t* buffer, size_t start_index) {
     assert(buffer->bytes != NULL);
     uint32_t value = 0;
     for(uint8_t i = 0; i < 4; i++) {
-        value |= (buffer->bytes[start_index + i]) << (8 * (3 - i));
+        value |= (uint32_t)(buffer->bytes[start_index + i]) << (8 * (3 - i));
     }
     return value;
 }
@@ -103,30 +170,579 @@ static void dump_uint32_t(
     }
 }
 
-sxbp_serialise_result_t sxbp_load_spiral(
-    sxbp_buffer_t buffer, sxbp_spiral_t* spiral
+/*
+ * loads a 32-bit signed integer from buffer starting at given index, which is
+ * stored in two's complement representation
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static int32_t load_int32_t(sxbp_buffer_t* buffer, size_t start_index) {
+    uint32_t value = load_uint32_t(buffer, start_index);
+    // convert without relying on implementation-defined unsigned -> signed casts
+    if(value <= INT32_MAX) {
+        return (int32_t)value;
+    } else {
+        return -(int32_t)(~value) - 1;
+    }
+}
+
+/*
+ * dumps a 32-bit signed integer of value to buffer at given index, in two's
+ * complement representation
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static void dump_int32_t(
+    int32_t value, sxbp_buffer_t* buffer, size_t start_index
+) {
+    dump_uint32_t((uint32_t)value, buffer, start_index);
+}
+
+/*
+ * loads a 64-bit unsigned integer from buffer starting at given index
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static uint64_t load_uint64_t(sxbp_buffer_t* buffer, size_t start_index) {
+    return (
+        ((uint64_t)load_uint32_t(buffer, start_index) << 32) |
+        load_uint32_t(buffer, start_index + 4)
+    );
+}
+
+/*
+ * dumps a 64-bit unsigned integer of value to buffer at given index
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static void dump_uint64_t(
+    uint64_t value, sxbp_buffer_t* buffer, size_t start_index
 ) {
+    dump_uint32_t((uint32_t)(value >> 32), buffer, start_index);
+    dump_uint32_t((uint32_t)value, buffer, start_index + 4);
+}
+
+/*
+ * loads one line of a spiral from the 4 bytes of buffer starting at given index
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static sxbp_line_t load_line(sxbp_buffer_t* buffer, size_t start_index) {
     // preconditional assertions
-    assert(buffer.bytes != NULL);
-    assert(spiral->lines == NULL);
-    sxbp_serialise_result_t result; // build struct for returning success / failure
-    // first, if header is too small for header + 1 line, then return early
-    if(buffer.size < SXBP_FILE_HEADER_SIZE + SXBP_LINE_T_PACK_SIZE) {
-        result.status = SXBP_OPERATION_FAIL; // flag failure
-        result.diagnostic = SXBP_DESERIALISE_BAD_HEADER_SIZE; // failure reason
-        return result;
+    assert(buffer->bytes != NULL);
+    sxbp_line_t line;
+    // direction is stored in 2 most significant bits of each 32-bit sequence
+    line.direction = buffer->bytes[start_index] >> 6;
+    /*
+     * length is stored as 30 least significant bits, so we have to unpack
+     * it handle first byte on it's own as we only need least 6 bits of it
+     * bit mask and shift 3 bytes to left
+     */
+    line.length = (sxbp_length_t)(
+        buffer->bytes[start_index] & 0x3f // <= binary value is 0b00111111
+    ) << 24;
+    // handle remaining 3 bytes in loop
+    for(uint8_t j = 0; j < 3; j++) {
+        line.length |= (buffer->bytes[start_index + 1 + j]) << (8 * (2 - j));
+    }
+    return line;
+}
+
+/*
+ * dumps one line of a spiral to the 4 bytes of buffer starting at given index
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static void dump_line(
+    sxbp_line_t line, sxbp_buffer_t* buffer, size_t start_index
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    /*
+     * serialise each line in the spiral to 4 bytes, handle first byte first
+     * map direction to 2 most significant bits
+     */
+    buffer->bytes[start_index] = (line.direction << 6);
+    // handle first 6 bits of the length
+    buffer->bytes[start_index] |= (line.length >> 24);
+    // handle remaining 3 bytes in a loop
+    for(uint8_t j = 0; j < 3; j++) {
+        buffer->bytes[start_index + 1 + j] = (uint8_t)(
+            line.length >> (8 * (2 - j))
+        );
+    }
+}
+
+/*
+ * returns the number of co-ords of the spiral's co-ord cache which are known to
+ * be valid and so can be stored in a file - this is 0 if there are none
+ */
+static size_t storable_co_ord_count(sxbp_spiral_t spiral) {
+    if(spiral.co_ord_cache.co_ords.items == NULL) {
+        return 0;
+    }
+    if(spiral.co_ord_cache.validity > spiral.size) {
+        return 0;
+    }
+    size_t count = sxbp_sum_lines(
+        spiral, 0, spiral.co_ord_cache.validity
+    ) + 1;
+    // the cache must actually contain all these co-ords and fit in 32 bits
+    if(
+        (count > spiral.co_ord_cache.co_ords.size) ||
+        (count > (UINT32_MAX - CO_ORD_CACHE_SECTION_BASE_SIZE) / CO_ORD_PACK_SIZE)
+    ) {
+        return 0;
+    }
+    return count;
+}
+
+/*
+ * private type representing one entry of the chunk index - an anchor from
+ * which the lines of one chunk can be decoded and plotted independently of the
+ * lines before it
+ */
+typedef struct chunk_anchor_t {
+    // byte offset of the chunk's first line from the start of the file
+    uint64_t offset;
+    // the co-ord at which the chunk's first line starts
+    sxbp_co_ord_t start;
+    // the sum of the lengths of all the lines before the chunk
+    uint64_t cumulative_length;
+    // CRC-32 of the chunk's lines, as packed in the file
+    uint32_t crc;
+} chunk_anchor_t;
+
+// returns the number of chunks of the given size needed for the given lines
+static size_t count_chunks(size_t line_count, size_t chunk_size) {
+    return (line_count + chunk_size - 1) / chunk_size;
+}
+
+/*
+ * returns whether the sum of the lengths of all the spiral's lines is more
+ * than limit - unlike sxbp_sum_lines(), this stops as soon as it is, so it
+ * can't wrap around no matter how many lines there are
+ */
+static bool lines_longer_than(sxbp_spiral_t spiral, uint64_t limit) {
+    uint64_t length = 0;
+    for(size_t i = 0; i < spiral.size; i++) {
+        length += spiral.lines[i].length;
+        if(length > limit) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * moves the co-ord to where the given line ends if it starts at it, returning
+ * false and leaving the co-ord as it was if that is out of the range of
+ * sxbp_tuple_item_t - lines loaded from a file can't be trusted to stay in it
+ */
+static bool follow_line(sxbp_co_ord_t* co_ord, sxbp_line_t line) {
+    sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[line.direction];
+    sxbp_tuple_item_t length = (sxbp_tuple_item_t)line.length;
+    if(
+        ((direction.x > 0) && (co_ord->x > SXBP_TUPLE_ITEM_MAX - length)) ||
+        ((direction.x < 0) && (co_ord->x < SXBP_TUPLE_ITEM_MIN + length)) ||
+        ((direction.y > 0) && (co_ord->y > SXBP_TUPLE_ITEM_MAX - length)) ||
+        ((direction.y < 0) && (co_ord->y < SXBP_TUPLE_ITEM_MIN + length))
+    ) {
+        return false;
+    }
+    co_ord->x += direction.x * length;
+    co_ord->y += direction.y * length;
+    return true;
+}
+
+/*
+ * returns the size of the header of a file of the spiral serialised with the
+ * given options - any optional sections need the extended file format, and
+ * spirals with too many lines to count in 32 bits need the wide one
+ */
+static size_t dumped_header_size(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options
+) {
+    if(
+        ((uint32_t)spiral.size != spiral.size) ||
+        ((uint32_t)spiral.solved_count != spiral.solved_count)
+    ) {
+        return SXBP_WIDE_FILE_HEADER_SIZE;
+    } else if(options.include_co_ord_cache || (options.chunk_size > 0)) {
+        return SXBP_EXTENDED_FILE_HEADER_SIZE;
+    } else {
+        return SXBP_FILE_HEADER_SIZE;
+    }
+}
+
+/*
+ * returns the total size in bytes of a spiral serialised with the given
+ * options, and stores the count of co-ords which will be stored from the co-ord
+ * cache (if any) in co_ord_count
+ */
+static size_t dumped_size(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, size_t* co_ord_count
+) {
+    size_t size = dumped_header_size(spiral, options) + (
+        SXBP_LINE_T_PACK_SIZE * spiral.size
+    );
+    *co_ord_count = 0;
+    if(options.include_co_ord_cache) {
+        *co_ord_count = storable_co_ord_count(spiral);
+        // the section is omitted entirely if there's nothing valid in it
+        if(*co_ord_count > 0) {
+            size += (
+                SECTION_HEADER_SIZE + CO_ORD_CACHE_SECTION_BASE_SIZE +
+                (CO_ORD_PACK_SIZE * *co_ord_count)
+            );
+        }
+    }
+    if(options.chunk_size > 0) {
+        size += (
+            SECTION_HEADER_SIZE + CHUNK_INDEX_SECTION_BASE_SIZE +
+            CHUNK_INDEX_ENTRY_SIZE * count_chunks(
+                spiral.size, options.chunk_size
+            )
+        );
+    }
+    return size;
+}
+
+/*
+ * private type used for writing data out to a stream in chunks, via a fixed
+ * size buffer which is flushed to the stream's write callback when full
+ */
+typedef struct stream_writer_t {
+    // the staging buffer
+    uint8_t bytes[STREAM_BUFFER_SIZE];
+    // buffer struct wrapping the staging buffer, for use with dump_x functions
+    sxbp_buffer_t buffer;
+    // how many bytes of the staging buffer are currently used
+    size_t used;
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data);
+    void* user_data;
+    // set if the stream ever refuses to take all of the data written to it
+    bool failed;
+} stream_writer_t;
+
+/*
+ * writes out all data currently staged in the stream writer to its stream
+ */
+static void flush_stream_writer(stream_writer_t* writer) {
+    if((writer->used > 0) && !writer->failed) {
+        size_t written = writer->write_callback(
+            writer->bytes, writer->used, writer->user_data
+        );
+        if(written != writer->used) {
+            writer->failed = true;
+        }
+    }
+    writer->used = 0;
+}
+
+/*
+ * reserves the given number of bytes in the stream writer's staging buffer,
+ * flushing it first if there isn't enough room left. Returns the index in the
+ * writer's buffer at which the reserved bytes start.
+ *
+ * Asserts:
+ * - That size is not larger than the staging buffer
+ */
+static size_t reserve_stream_bytes(stream_writer_t* writer, size_t size) {
+    // preconditional assertions
+    assert(size <= STREAM_BUFFER_SIZE);
+    if(STREAM_BUFFER_SIZE - writer->used < size) {
+        flush_stream_writer(writer);
+    }
+    size_t index = writer->used;
+    writer->used += size;
+    return index;
+}
+
+/*
+ * serialises the spiral with the given options to the stream writer, given the
+ * count of co-ords to store from the co-ord cache (see dumped_size()). This
+ * writes everything in the same format as sxbp_dump_spiral_with_options() does.
+ * Returns SXBP_MALLOC_REFUSED if memory couldn't be allocated for the chunk
+ * index, SXBP_SIZE_OVERFLOW if the chunk index can't be stored in 32 bits,
+ * otherwise SXBP_OPERATION_OK (stream failures are flagged in writer).
+ */
+static sxbp_status_t dump_to_stream(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, size_t co_ord_count,
+    stream_writer_t* writer
+) {
+    // any optional sections require the extended file format
+    size_t header_size = dumped_header_size(spiral, options);
+    bool extended = header_size != SXBP_FILE_HEADER_SIZE;
+    bool wide = header_size == SXBP_WIDE_FILE_HEADER_SIZE;
+    // the chunk index is built up as the lines are written
+    size_t chunk_count = 0;
+    chunk_anchor_t* anchors = NULL;
+    if(options.chunk_size > 0) {
+        chunk_count = count_chunks(spiral.size, options.chunk_size);
+        /*
+         * its co-ords and size are stored in 32 bits, so must fit - no co-ord
+         * can be further from the origin than the sum of the line lengths, so
+         * this also means they can be worked out below without overflowing
+         */
+        if(
+            lines_longer_than(spiral, INT32_MAX) ||
+            (chunk_count > (
+                UINT32_MAX - CHUNK_INDEX_SECTION_BASE_SIZE
+            ) / CHUNK_INDEX_ENTRY_SIZE)
+        ) {
+            return SXBP_SIZE_OVERFLOW;
+        }
+        anchors = sxbp_calloc(sizeof(chunk_anchor_t), chunk_count);
+        if((anchors == NULL) && (chunk_count > 0)) {
+            return SXBP_MALLOC_REFUSED;
+        }
+    }
+    size_t index = reserve_stream_bytes(writer, header_size);
+    // write magic number to buffer
+    memcpy(writer->bytes + index, extended ? "sxbx" : "sxbp", 4);
+    // write out version info to buffer
+    dump_uint16_t(LIB_SXBP_VERSION.major, &writer->buffer, index + 4);
+    dump_uint16_t(LIB_SXBP_VERSION.minor, &writer->buffer, index + 6);
+    dump_uint16_t(LIB_SXBP_VERSION.patch, &writer->buffer, index + 8);
+    // write second part of data header
+    dump_uint32_t(
+        wide ? UINT32_MAX : (uint32_t)spiral.size, &writer->buffer, index + 10
+    );
+    dump_uint32_t(
+        wide ? UINT32_MAX : (uint32_t)spiral.solved_count, &writer->buffer,
+        index + 14
+    );
+    dump_uint32_t(spiral.seconds_spent, &writer->buffer, index + 18);
+    dump_uint32_t(spiral.seconds_accuracy, &writer->buffer, index + 22);
+    // extended files have a flags field, the only flag being for wide files
+    if(extended) {
+        dump_uint32_t(wide ? FILE_FLAG_WIDE : 0, &writer->buffer, index + 26);
+    }
+    // which have the full line counts after it
+    if(wide) {
+        dump_uint64_t(spiral.size, &writer->buffer, index + 30);
+        dump_uint64_t(spiral.solved_count, &writer->buffer, index + 38);
+    }
+    // now write the data section
+    sxbp_co_ord_t current = { 0, 0, };
+    uint64_t cumulative_length = 0;
+    for(size_t i = 0; i < spiral.size; i++) {
+        index = reserve_stream_bytes(writer, SXBP_LINE_T_PACK_SIZE);
+        dump_line(spiral.lines[i], &writer->buffer, index);
+        if(anchors != NULL) {
+            chunk_anchor_t* anchor = &anchors[i / options.chunk_size];
+            // record where each chunk starts when we get to its first line
+            if(i % options.chunk_size == 0) {
+                anchor->offset = header_size + (i * SXBP_LINE_T_PACK_SIZE);
+                anchor->start = current;
+                anchor->cumulative_length = cumulative_length;
+                anchor->crc = 0;
+            }
+            anchor->crc = sxbp_crc32(
+                anchor->crc, writer->bytes + index, SXBP_LINE_T_PACK_SIZE
+            );
+            // keep track of where the next line starts
+            sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[
+                spiral.lines[i].direction
+            ];
+            current.x += direction.x * (sxbp_tuple_item_t)spiral.lines[i].length;
+            current.y += direction.y * (sxbp_tuple_item_t)spiral.lines[i].length;
+            cumulative_length += spiral.lines[i].length;
+        }
+    }
+    // write the co-ord cache section, if there is one
+    if(co_ord_count > 0) {
+        size_t payload_size = (
+            CO_ORD_CACHE_SECTION_BASE_SIZE + (CO_ORD_PACK_SIZE * co_ord_count)
+        );
+        // section header
+        index = reserve_stream_bytes(writer, SECTION_HEADER_SIZE);
+        memcpy(writer->bytes + index, CO_ORD_CACHE_SECTION_TAG, 4);
+        dump_uint32_t((uint32_t)payload_size, &writer->buffer, index + 4);
+        // payload - validity and count, followed by the co-ords themselves
+        index = reserve_stream_bytes(writer, 8);
+        dump_uint32_t(
+            (uint32_t)spiral.co_ord_cache.validity, &writer->buffer, index
+        );
+        dump_uint32_t((uint32_t)co_ord_count, &writer->buffer, index + 4);
+        // keep a running checksum of the payload as it is written
+        uint32_t crc = sxbp_crc32(0, writer->bytes + index, 8);
+        for(size_t i = 0; i < co_ord_count; i++) {
+            sxbp_co_ord_t co_ord = spiral.co_ord_cache.co_ords.items[i];
+            index = reserve_stream_bytes(writer, CO_ORD_PACK_SIZE);
+            dump_int32_t(co_ord.x, &writer->buffer, index);
+            dump_int32_t(co_ord.y, &writer->buffer, index + 4);
+            crc = sxbp_crc32(crc, writer->bytes + index, CO_ORD_PACK_SIZE);
+        }
+        // finally, the checksum of all of the payload before it
+        index = reserve_stream_bytes(writer, 4);
+        dump_uint32_t(crc, &writer->buffer, index);
+    }
+    // write the chunk index section, if there is one
+    if(options.chunk_size > 0) {
+        size_t payload_size = (
+            CHUNK_INDEX_SECTION_BASE_SIZE +
+            (CHUNK_INDEX_ENTRY_SIZE * chunk_count)
+        );
+        // section header
+        index = reserve_stream_bytes(writer, SECTION_HEADER_SIZE);
+        memcpy(writer->bytes + index, CHUNK_INDEX_SECTION_TAG, 4);
+        dump_uint32_t((uint32_t)payload_size, &writer->buffer, index + 4);
+        // payload - chunk size and count, followed by the entries themselves
+        index = reserve_stream_bytes(writer, 8);
+        dump_uint32_t(options.chunk_size, &writer->buffer, index);
+        dump_uint32_t((uint32_t)chunk_count, &writer->buffer, index + 4);
+        uint32_t crc = sxbp_crc32(0, writer->bytes + index, 8);
+        for(size_t i = 0; i < chunk_count; i++) {
+            index = reserve_stream_bytes(writer, CHUNK_INDEX_ENTRY_SIZE);
+            dump_uint64_t(anchors[i].offset, &writer->buffer, index);
+            dump_int32_t(anchors[i].start.x, &writer->buffer, index + 8);
+            dump_int32_t(anchors[i].start.y, &writer->buffer, index + 12);
+            dump_uint64_t(
+                anchors[i].cumulative_length, &writer->buffer, index + 16
+            );
+            dump_uint32_t(anchors[i].crc, &writer->buffer, index + 24);
+            crc = sxbp_crc32(
+                crc, writer->bytes + index, CHUNK_INDEX_ENTRY_SIZE
+            );
+        }
+        // finally, the checksum of all of the payload before it
+        index = reserve_stream_bytes(writer, 4);
+        dump_uint32_t(crc, &writer->buffer, index);
+    }
+    sxbp_free(anchors);
+    flush_stream_writer(writer);
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * private type and write callback used for dumping via a stream writer to a
+ * buffer which has already been allocated big enough for all the data
+ */
+typedef struct buffer_stream_t {
+    sxbp_buffer_t* buffer;
+    size_t index;
+} buffer_stream_t;
+
+static size_t write_to_buffer_stream(
+    const uint8_t* data, size_t size, void* user_data
+) {
+    buffer_stream_t* stream = (buffer_stream_t*)user_data;
+    assert(stream->index + size <= stream->buffer->size);
+    memcpy(stream->buffer->bytes + stream->index, data, size);
+    stream->index += size;
+    return size;
+}
+
+// write callback used for dumping to a file
+static size_t write_to_file(const uint8_t* data, size_t size, void* user_data) {
+    return fwrite(data, 1, size, (FILE*)user_data);
+}
+
+// read callback used for loading from a file
+static size_t read_from_file(uint8_t* data, size_t size, void* user_data) {
+    return fread(data, 1, size, (FILE*)user_data);
+}
+
+/*
+ * private type used for reading data in from a stream
+ */
+typedef struct stream_reader_t {
+    size_t(* read_callback)(uint8_t* data, size_t size, void* user_data);
+    void* user_data;
+} stream_reader_t;
+
+/*
+ * reads up to size bytes from the stream into data, retrying short reads until
+ * the read callback returns 0. Returns the number of bytes actually read, which
+ * is less than size only if the stream ended.
+ */
+static size_t read_stream_bytes(
+    stream_reader_t* reader, uint8_t* data, size_t size
+) {
+    size_t total = 0;
+    while(total < size) {
+        size_t count = reader->read_callback(
+            data + total, size - total, reader->user_data
+        );
+        if(count == 0) {
+            break;
+        }
+        total += count;
+    }
+    return total;
+}
+
+/*
+ * makes sure that the array of items of the given size, which currently has
+ * room for capacity items, has room for at least needed items. The capacity is
+ * doubled each time it has to grow, up to limit, so that the memory allocated
+ * for arrays of which the size was read from a stream (and so can't be
+ * trusted) only grows as fast as the data for them actually arrives. Returns
+ * false if the memory couldn't be allocated, leaving the array as it was.
+ */
+static bool grow_loaded_array(
+    void** items, size_t item_size, size_t* capacity, size_t needed,
+    size_t limit
+) {
+    if(needed <= *capacity) {
+        return true;
+    }
+    size_t new_capacity = (*capacity > 0) ? *capacity : needed;
+    while(new_capacity < needed) {
+        new_capacity = (new_capacity > limit / 2) ? limit : new_capacity * 2;
+    }
+    if(new_capacity > SIZE_MAX / item_size) {
+        return false;
     }
+    void* grown = sxbp_realloc(*items, new_capacity * item_size);
+    if(grown == NULL) {
+        return false;
+    }
+    *items = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+/*
+ * checks the magic number and the version at the start of a file header stored
+ * in buffer, which must be at least SXBP_FILE_HEADER_SIZE bytes long. Stores
+ * whether the file is in the extended format (with optional sections) or not
+ * in extended.
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static sxbp_serialise_result_t check_file_header(
+    sxbp_buffer_t* buffer, bool* extended
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_FAIL, SXBP_DESERIALISE_OK,
+    };
     // check for magic number and return early if not right
-    if(strncmp((char*)buffer.bytes, "sxbp", 4) != 0) {
-        result.status = SXBP_OPERATION_FAIL; // flag failure
+    if(strncmp((char*)buffer->bytes, "sxbx", 4) == 0) {
+        // this file may contain optional sections, and has a larger header
+        *extended = true;
+    } else if(strncmp((char*)buffer->bytes, "sxbp", 4) == 0) {
+        *extended = false;
+    } else {
         result.diagnostic = SXBP_DESERIALISE_BAD_MAGIC_NUMBER; // failure reason
         return result;
     }
     // grab file version from header
     sxbp_version_t buffer_version = {
-        .major = load_uint16_t(&buffer, 4),
-        .minor = load_uint16_t(&buffer, 6),
-        .patch = load_uint16_t(&buffer, 8),
+        .major = load_uint16_t(buffer, 4),
+        .minor = load_uint16_t(buffer, 6),
+        .patch = load_uint16_t(buffer, 8),
     };
     // we don't accept anything less than v0.26.0, so the min is v0.26.0
     // TODO: Add this as a library constant - to add in next minor release
@@ -134,111 +750,1225 @@ sxbp_serialise_result_t sxbp_load_spiral(
     // check for version compatibility
     if(sxbp_version_less_than(buffer_version, min_version)) {
         // check failed
-        result.status = SXBP_OPERATION_FAIL; // flag failure
         result.diagnostic = SXBP_DESERIALISE_BAD_VERSION; // failure reason
         return result;
     }
-    // get size of spiral object contained in buffer
-    uint32_t spiral_size = load_uint32_t(&buffer, 10);
-    // Check that the file data section is large enough for the spiral size
-    if((buffer.size - SXBP_FILE_HEADER_SIZE) != (SXBP_LINE_T_PACK_SIZE * spiral_size)) {
-        // this check failed
-        result.status = SXBP_OPERATION_FAIL; // flag failure
-        result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE; // failure reason
-        return result;
-    }
-    // good to go
-    // populate spiral struct, loading some more values
-    spiral->size = spiral_size;
-    spiral->solved_count = load_uint32_t(&buffer, 14);
-    spiral->seconds_spent = load_uint32_t(&buffer, 18);
-    spiral->seconds_accuracy = load_uint32_t(&buffer, 22);
-    // allocate memory
-    spiral->lines = calloc(sizeof(sxbp_line_t), spiral->size);
-    // catch allocation error
-    if(spiral->lines == NULL) {
-        result.status = SXBP_MALLOC_REFUSED; // flag failure
-        return result;
-    }
-    // convert each serialised line segment in buffer into a line_t struct
-    for(size_t i = 0; i < spiral_size; i++) {
-        // direction is stored in 2 most significant bits of each 32-bit sequence
-        spiral->lines[i].direction = (
-            buffer.bytes[SXBP_FILE_HEADER_SIZE + (i * SXBP_LINE_T_PACK_SIZE)] >> 6
-        );
-        /*
-         * length is stored as 30 least significant bits, so we have to unpack
-         * it handle first byte on it's own as we only need least 6 bits of it
-         * bit mask and shift 3 bytes to left
-         */
-        spiral->lines[i].length = (
-            buffer.bytes[SXBP_FILE_HEADER_SIZE + (i * SXBP_LINE_T_PACK_SIZE)]
-            & 0x3f // <= binary value is 0b00111111
-        ) << 24;
-        // handle remaining 3 bytes in loop
-        for(uint8_t j = 0; j < 3; j++) {
-            spiral->lines[i].length |= (
-                buffer.bytes[SXBP_FILE_HEADER_SIZE + (i * SXBP_LINE_T_PACK_SIZE) + 1 + j]
-            ) << (8 * (2 - j));
-        }
-    }
-    // return ok status
     result.status = SXBP_OPERATION_OK;
     return result;
 }
 
-sxbp_serialise_result_t sxbp_dump_spiral(
-    sxbp_spiral_t spiral, sxbp_buffer_t* buffer
+/*
+ * checks the format flags of the extended file header stored in buffer, which
+ * must be at least SXBP_EXTENDED_FILE_HEADER_SIZE bytes long. Stores the size
+ * of the whole header, which is bigger for wide files, in header_size.
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static sxbp_serialise_result_t check_file_flags(
+    sxbp_buffer_t* buffer, size_t* header_size
 ) {
     // preconditional assertions
-    assert(buffer->bytes == NULL);
-    assert(spiral.lines != NULL);
-    sxbp_serialise_result_t result; // build struct for returning success / failure
-    // populate buffer struct, base size on header + spiral size
-    buffer->size = (SXBP_FILE_HEADER_SIZE + (SXBP_LINE_T_PACK_SIZE * spiral.size));
-    // allocate memory for buffer
-    buffer->bytes = calloc(1, buffer->size);
-    // catch memory allocation failure
-    if(buffer->bytes == NULL) {
-        result.status = SXBP_MALLOC_REFUSED;
-        return result;
+    assert(buffer->bytes != NULL);
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_OK, SXBP_DESERIALISE_OK,
+    };
+    uint32_t flags = load_uint32_t(buffer, 26);
+    // any flags we don't know of must be from a newer version of the format
+    if((flags & ~FILE_FLAG_WIDE) != 0) {
+        result.status = SXBP_OPERATION_FAIL; // flag failure
+        result.diagnostic = SXBP_DESERIALISE_BAD_VERSION;
     }
-    // write magic number to buffer
-    sprintf((char*)buffer->bytes, "sxbp");
-    // write out version info to buffer
-    dump_uint16_t(LIB_SXBP_VERSION.major, buffer, 4);
-    dump_uint16_t(LIB_SXBP_VERSION.minor, buffer, 6);
-    dump_uint16_t(LIB_SXBP_VERSION.patch, buffer, 8);
-    // write second part of data header
-    dump_uint32_t(spiral.size, buffer, 10);
-    dump_uint32_t(spiral.solved_count, buffer, 14);
-    dump_uint32_t(spiral.seconds_spent, buffer, 18);
-    dump_uint32_t(spiral.seconds_accuracy, buffer, 22);
-    // now write the data section
-    for(size_t i = 0; i < spiral.size; i++) {
-        /*
-         * serialise each line in the spiral to 4 bytes, handle first byte first
-         * map direction to 2 most significant bits
-         */
-        buffer->bytes[
-            SXBP_FILE_HEADER_SIZE + (i * SXBP_LINE_T_PACK_SIZE)
-        ] = (spiral.lines[i].direction << 6);
-        // handle first 6 bits of the length
-        buffer->bytes[
-            SXBP_FILE_HEADER_SIZE + (i * SXBP_LINE_T_PACK_SIZE)
-        ] |= (spiral.lines[i].length >> 24);
-        // handle remaining 3 bytes in a loop
-        for(uint8_t j = 0; j < 3; j++) {
-            buffer->bytes[
-                SXBP_FILE_HEADER_SIZE + (i * SXBP_LINE_T_PACK_SIZE) + 1 + j
-            ] = (uint8_t)(spiral.lines[i].length >> (8 * (2 - j)));
+    *header_size = (flags & FILE_FLAG_WIDE) ? (
+        SXBP_WIDE_FILE_HEADER_SIZE
+    ) : SXBP_EXTENDED_FILE_HEADER_SIZE;
+    return result;
+}
+
+/*
+ * loads the total number of lines from the file header stored in buffer, which
+ * is of the given size - wide headers store it in 64 bits after the flags
+ */
+static uint64_t load_spiral_size(sxbp_buffer_t* buffer, size_t header_size) {
+    if(header_size == SXBP_WIDE_FILE_HEADER_SIZE) {
+        return load_uint64_t(buffer, 30);
+    } else {
+        return load_uint32_t(buffer, 10);
+    }
+}
+
+/*
+ * loads the number of lines solved from the file header stored in buffer,
+ * which is of the given size, in the same way as load_spiral_size()
+ */
+static uint64_t load_solved_count(sxbp_buffer_t* buffer, size_t header_size) {
+    if(header_size == SXBP_WIDE_FILE_HEADER_SIZE) {
+        return load_uint64_t(buffer, 38);
+    } else {
+        return load_uint32_t(buffer, 14);
+    }
+}
+
+/*
+ * checks that the line counts of the file header stored in buffer, which is of
+ * the given size, fit in sxbp_line_count_t. Returns SXBP_SIZE_OVERFLOW as the
+ * status if they don't, as this build can't hold that many lines.
+ */
+static sxbp_serialise_result_t check_line_counts(
+    sxbp_buffer_t* buffer, size_t header_size
+) {
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_OK, SXBP_DESERIALISE_OK,
+    };
+    uint64_t size = load_spiral_size(buffer, header_size);
+    uint64_t solved_count = load_solved_count(buffer, header_size);
+    if(
+        ((sxbp_line_count_t)size != size) ||
+        ((sxbp_line_count_t)solved_count != solved_count)
+    ) {
+        result.status = SXBP_SIZE_OVERFLOW; // flag failure
+        result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE;
+    }
+    return result;
+}
+
+/*
+ * loads the fields of the file header stored in buffer, which is of the given
+ * size (and has already been validated) into the spiral
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static void load_header_fields(
+    sxbp_buffer_t* buffer, size_t header_size, sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    spiral->size = (sxbp_line_count_t)load_spiral_size(buffer, header_size);
+    spiral->solved_count = (sxbp_line_count_t)load_solved_count(
+        buffer, header_size
+    );
+    spiral->seconds_spent = load_uint32_t(buffer, 18);
+    spiral->seconds_accuracy = load_uint32_t(buffer, 22);
+}
+
+/*
+ * frees any memory allocated for a spiral that was being loaded when the load
+ * failed, so as not to leave a half-loaded spiral behind
+ */
+static void discard_loaded_spiral(sxbp_spiral_t* spiral) {
+    sxbp_free(spiral->lines);
+    spiral->lines = NULL;
+    sxbp_free(spiral->co_ord_cache.co_ords.items);
+    spiral->co_ord_cache = (sxbp_co_ord_cache_t){
+        {NULL, 0}, 0, {{0, 0}, {0, 0}}, 0,
+    };
+}
+
+/*
+ * loads the co-ord cache section of which the payload is found in buffer at
+ * given index, with given size, storing the co-ords in the spiral's cache.
+ * The lines of the spiral must already have been loaded.
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ * - That spiral->lines is not NULL
+ */
+static sxbp_serialise_result_t load_co_ord_cache_section(
+    sxbp_buffer_t* buffer, size_t start_index, size_t payload_size,
+    sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    assert(spiral->lines != NULL);
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_FAIL, SXBP_DESERIALISE_BAD_DATA_SIZE,
+    };
+    if(payload_size < CO_ORD_CACHE_SECTION_BASE_SIZE) {
+        return result;
+    }
+    uint32_t validity = load_uint32_t(buffer, start_index);
+    uint32_t co_ord_count = load_uint32_t(buffer, start_index + 4);
+    // the section's size must match the count of co-ords it says it has
+    if(
+        (payload_size - CO_ORD_CACHE_SECTION_BASE_SIZE)
+        != (CO_ORD_PACK_SIZE * (size_t)co_ord_count)
+    ) {
+        return result;
+    }
+    // verify the checksum before trusting any more of the data
+    size_t checksum_index = start_index + payload_size - 4;
+    if(
+        sxbp_crc32(0, buffer->bytes + start_index, payload_size - 4)
+        != load_uint32_t(buffer, checksum_index)
+    ) {
+        result.diagnostic = SXBP_DESERIALISE_BAD_CHECKSUM;
+        return result;
+    }
+    // the co-ords must be those of the lines they claim to be valid for
+    if(
+        (validity > spiral->size) ||
+        (sxbp_sum_lines(*spiral, 0, validity) + 1 != co_ord_count)
+    ) {
+        return result;
+    }
+    spiral->co_ord_cache.co_ords.items = sxbp_calloc(
+        sizeof(sxbp_co_ord_t), co_ord_count
+    );
+    if(spiral->co_ord_cache.co_ords.items == NULL) {
+        result.status = SXBP_MALLOC_REFUSED;
+        return result;
+    }
+    size_t index = start_index + 8;
+    for(size_t i = 0; i < co_ord_count; i++) {
+        spiral->co_ord_cache.co_ords.items[i].x = load_int32_t(buffer, index);
+        spiral->co_ord_cache.co_ords.items[i].y = load_int32_t(
+            buffer, index + 4
+        );
+        index += CO_ORD_PACK_SIZE;
+    }
+    spiral->co_ord_cache.co_ords.size = co_ord_count;
+    spiral->co_ord_cache.validity = validity;
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+/*
+ * loads all the optional sections found in buffer from given index until the
+ * end of the buffer into the spiral, of which the lines must already have been
+ * loaded. Sections with unrecognised tags are skipped.
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ * - That spiral->lines is not NULL
+ */
+static sxbp_serialise_result_t load_sections(
+    sxbp_buffer_t* buffer, size_t start_index, sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    assert(spiral->lines != NULL);
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_OK, SXBP_DESERIALISE_OK,
+    };
+    size_t index = start_index;
+    while(index < buffer->size) {
+        // there must be room for a section header and all of the payload
+        if((buffer->size - index) < SECTION_HEADER_SIZE) {
+            result.status = SXBP_OPERATION_FAIL;
+            result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE;
+            return result;
+        }
+        size_t payload_size = load_uint32_t(buffer, index + 4);
+        size_t payload_index = index + SECTION_HEADER_SIZE;
+        if((buffer->size - payload_index) < payload_size) {
+            result.status = SXBP_OPERATION_FAIL;
+            result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE;
+            return result;
+        }
+        if(
+            (memcmp(buffer->bytes + index, CO_ORD_CACHE_SECTION_TAG, 4) == 0) &&
+            (spiral->co_ord_cache.co_ords.items == NULL)
+        ) {
+            result = load_co_ord_cache_section(
+                buffer, payload_index, payload_size, spiral
+            );
+            if(result.status != SXBP_OPERATION_OK) {
+                return result;
+            }
+        }
+        index = payload_index + payload_size;
+    }
+    return result;
+}
+
+/*
+ * streaming equivalent of load_co_ord_cache_section(), which reads the payload
+ * in from the stream in chunks using the given staging buffer (which must be
+ * STREAM_BUFFER_SIZE bytes long)
+ *
+ * Asserts:
+ * - That staging->bytes is not NULL
+ * - That spiral->lines is not NULL
+ */
+static sxbp_serialise_result_t read_co_ord_cache_section(
+    stream_reader_t* reader, sxbp_buffer_t* staging, size_t payload_size,
+    sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(staging->bytes != NULL);
+    assert(spiral->lines != NULL);
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_FAIL, SXBP_DESERIALISE_BAD_DATA_SIZE,
+    };
+    if(
+        (payload_size < CO_ORD_CACHE_SECTION_BASE_SIZE) ||
+        (read_stream_bytes(reader, staging->bytes, 8) != 8)
+    ) {
+        return result;
+    }
+    uint32_t validity = load_uint32_t(staging, 0);
+    uint32_t co_ord_count = load_uint32_t(staging, 4);
+    uint32_t crc = sxbp_crc32(0, staging->bytes, 8);
+    // the section's size must match what it contains, and the spiral's lines
+    if(
+        ((payload_size - CO_ORD_CACHE_SECTION_BASE_SIZE)
+        != (CO_ORD_PACK_SIZE * (size_t)co_ord_count)) ||
+        (validity > spiral->size) ||
+        (sxbp_sum_lines(*spiral, 0, validity) + 1 != co_ord_count)
+    ) {
+        return result;
+    }
+    /*
+     * read in the co-ords in chunks which fit in the staging buffer, only
+     * allocating memory for them as they arrive
+     */
+    size_t chunk_co_ords = STREAM_BUFFER_SIZE / CO_ORD_PACK_SIZE;
+    size_t capacity = 0;
+    for(size_t i = 0; i < co_ord_count; i += chunk_co_ords) {
+        size_t count = (
+            (co_ord_count - i) < chunk_co_ords
+        ) ? (co_ord_count - i) : chunk_co_ords;
+        size_t bytes = count * CO_ORD_PACK_SIZE;
+        if(read_stream_bytes(reader, staging->bytes, bytes) != bytes) {
+            return result;
+        }
+        if(
+            !grow_loaded_array(
+                (void**)&spiral->co_ord_cache.co_ords.items,
+                sizeof(sxbp_co_ord_t), &capacity, i + count, co_ord_count
+            )
+        ) {
+            result.status = SXBP_MALLOC_REFUSED;
+            return result;
+        }
+        crc = sxbp_crc32(crc, staging->bytes, bytes);
+        for(size_t j = 0; j < count; j++) {
+            spiral->co_ord_cache.co_ords.items[i + j].x = load_int32_t(
+                staging, j * CO_ORD_PACK_SIZE
+            );
+            spiral->co_ord_cache.co_ords.items[i + j].y = load_int32_t(
+                staging, (j * CO_ORD_PACK_SIZE) + 4
+            );
+        }
+    }
+    // lastly the checksum, which must match that of everything before it
+    if(read_stream_bytes(reader, staging->bytes, 4) != 4) {
+        return result;
+    }
+    if(load_uint32_t(staging, 0) != crc) {
+        result.diagnostic = SXBP_DESERIALISE_BAD_CHECKSUM;
+        return result;
+    }
+    spiral->co_ord_cache.co_ords.size = co_ord_count;
+    spiral->co_ord_cache.validity = validity;
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+/*
+ * streaming equivalent of load_sections(), which reads sections in from the
+ * stream until it ends, using the given staging buffer (which must be
+ * STREAM_BUFFER_SIZE bytes long)
+ *
+ * Asserts:
+ * - That staging->bytes is not NULL
+ * - That spiral->lines is not NULL
+ */
+static sxbp_serialise_result_t read_sections(
+    stream_reader_t* reader, sxbp_buffer_t* staging, sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(staging->bytes != NULL);
+    assert(spiral->lines != NULL);
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_FAIL, SXBP_DESERIALISE_BAD_DATA_SIZE,
+    };
+    while(true) {
+        size_t count = read_stream_bytes(
+            reader, staging->bytes, SECTION_HEADER_SIZE
+        );
+        if(count == 0) {
+            // the stream ended cleanly between sections, so we're done
+            break;
+        } else if(count != SECTION_HEADER_SIZE) {
+            return result;
+        }
+        size_t payload_size = load_uint32_t(staging, 4);
+        if(
+            (memcmp(staging->bytes, CO_ORD_CACHE_SECTION_TAG, 4) == 0) &&
+            (spiral->co_ord_cache.co_ords.items == NULL)
+        ) {
+            sxbp_serialise_result_t section_result = read_co_ord_cache_section(
+                reader, staging, payload_size, spiral
+            );
+            if(section_result.status != SXBP_OPERATION_OK) {
+                return section_result;
+            }
+        } else {
+            // skip over the payload of sections we don't know how to load
+            while(payload_size > 0) {
+                size_t skip = (
+                    payload_size < STREAM_BUFFER_SIZE
+                ) ? payload_size : STREAM_BUFFER_SIZE;
+                if(read_stream_bytes(reader, staging->bytes, skip) != skip) {
+                    return result;
+                }
+                payload_size -= skip;
+            }
+        }
+    }
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+/*
+ * checks the header of the serialised spiral in buffer, and that the buffer is
+ * big enough to hold all the lines that the header says it has. Stores the size
+ * of the header in header_size and whether the file is in the extended format
+ * or not in extended.
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static sxbp_serialise_result_t check_buffer_layout(
+    sxbp_buffer_t* buffer, size_t* header_size, bool* extended
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    sxbp_serialise_result_t result; // build struct for returning success / failure
+    // first, if header is too small for header + 1 line, then return early
+    if(buffer->size < SXBP_FILE_HEADER_SIZE + SXBP_LINE_T_PACK_SIZE) {
+        result.status = SXBP_OPERATION_FAIL; // flag failure
+        result.diagnostic = SXBP_DESERIALISE_BAD_HEADER_SIZE; // failure reason
+        return result;
+    }
+    // check the magic number and version, and return early if not right
+    result = check_file_header(buffer, extended);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // extended files must be big enough for their header, with no unknown flags
+    *header_size = SXBP_FILE_HEADER_SIZE;
+    if(*extended) {
+        size_t minimum_size = (
+            SXBP_EXTENDED_FILE_HEADER_SIZE + SXBP_LINE_T_PACK_SIZE
+        );
+        if(buffer->size < minimum_size) {
+            result.status = SXBP_OPERATION_FAIL; // flag failure
+            result.diagnostic = SXBP_DESERIALISE_BAD_HEADER_SIZE;
+            return result;
+        }
+        result = check_file_flags(buffer, header_size);
+        if(result.status != SXBP_OPERATION_OK) {
+            return result;
+        }
+        // wide files have a bigger header still
+        if(buffer->size < *header_size + SXBP_LINE_T_PACK_SIZE) {
+            result.status = SXBP_OPERATION_FAIL; // flag failure
+            result.diagnostic = SXBP_DESERIALISE_BAD_HEADER_SIZE;
+            return result;
+        }
+    }
+    // the spiral must not have more lines than we can count
+    result = check_line_counts(buffer, *header_size);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // get size of spiral object contained in buffer
+    uint64_t spiral_size = load_spiral_size(buffer, *header_size);
+    /*
+     * Check that the file data section is large enough for the spiral size.
+     * Only extended files may have data left over after the lines.
+     */
+    size_t data_size = buffer->size - *header_size;
+    if(
+        (spiral_size > data_size / SXBP_LINE_T_PACK_SIZE) || (
+            !*extended && (data_size != SXBP_LINE_T_PACK_SIZE * spiral_size)
+        )
+    ) {
+        // this check failed
+        result.status = SXBP_OPERATION_FAIL; // flag failure
+        result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE; // failure reason
+        return result;
+    }
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+/*
+ * searches the optional sections found in buffer from given index until the
+ * end of the buffer for the first one with the given tag, storing the index and
+ * size of its payload in payload_index and payload_size if it is found.
+ * Returns SXBP_DESERIALISE_MISSING_SECTION if there is no such section.
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static sxbp_serialise_result_t find_section(
+    sxbp_buffer_t* buffer, size_t start_index, const char* tag,
+    size_t* payload_index, size_t* payload_size
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_FAIL, SXBP_DESERIALISE_BAD_DATA_SIZE,
+    };
+    size_t index = start_index;
+    while(index < buffer->size) {
+        // there must be room for a section header and all of the payload
+        if((buffer->size - index) < SECTION_HEADER_SIZE) {
+            return result;
+        }
+        *payload_size = load_uint32_t(buffer, index + 4);
+        *payload_index = index + SECTION_HEADER_SIZE;
+        if((buffer->size - *payload_index) < *payload_size) {
+            return result;
+        }
+        if(memcmp(buffer->bytes + index, tag, 4) == 0) {
+            result.status = SXBP_OPERATION_OK;
+            result.diagnostic = SXBP_DESERIALISE_OK;
+            return result;
+        }
+        index = *payload_index + *payload_size;
+    }
+    result.diagnostic = SXBP_DESERIALISE_MISSING_SECTION;
+    return result;
+}
+
+/*
+ * private type for the chunk index of a serialised spiral once it has been
+ * checked and loaded
+ */
+typedef struct chunk_index_t {
+    // how many lines there are in each chunk (the last one may have fewer)
+    size_t chunk_size;
+    // how many chunks there are
+    size_t count;
+    // one anchor for each chunk, or NULL if not loaded
+    chunk_anchor_t* anchors;
+} chunk_index_t;
+
+/*
+ * loads the chunk index entry stored in buffer at given index
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static chunk_anchor_t load_chunk_anchor(
+    sxbp_buffer_t* buffer, size_t start_index
+) {
+    chunk_anchor_t anchor = {
+        .offset = load_uint64_t(buffer, start_index),
+        .start = {
+            load_int32_t(buffer, start_index + 8),
+            load_int32_t(buffer, start_index + 12),
+        },
+        .cumulative_length = load_uint64_t(buffer, start_index + 16),
+        .crc = load_uint32_t(buffer, start_index + 24),
+    };
+    return anchor;
+}
+
+/*
+ * finds and checks the chunk index of the serialised spiral in buffer, of
+ * which the layout must already have been checked with check_buffer_layout().
+ * The chunk size and count are stored in index, and if load_anchors is true
+ * then all of the anchors are loaded too, in which case index->anchors must be
+ * freed by the caller.
+ *
+ * Asserts:
+ * - That buffer->bytes is not NULL
+ */
+static sxbp_serialise_result_t load_chunk_index(
+    sxbp_buffer_t* buffer, size_t header_size, bool load_anchors,
+    chunk_index_t* index
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    index->anchors = NULL;
+    size_t spiral_size = (size_t)load_spiral_size(buffer, header_size);
+    size_t payload_index = 0;
+    size_t payload_size = 0;
+    sxbp_serialise_result_t result = find_section(
+        buffer, header_size + (SXBP_LINE_T_PACK_SIZE * spiral_size),
+        CHUNK_INDEX_SECTION_TAG, &payload_index, &payload_size
+    );
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    result.status = SXBP_OPERATION_FAIL;
+    result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE;
+    if(payload_size < CHUNK_INDEX_SECTION_BASE_SIZE) {
+        return result;
+    }
+    index->chunk_size = load_uint32_t(buffer, payload_index);
+    index->count = load_uint32_t(buffer, payload_index + 4);
+    // the section's size must match the count of entries it says it has
+    if(
+        (payload_size - CHUNK_INDEX_SECTION_BASE_SIZE)
+        != (CHUNK_INDEX_ENTRY_SIZE * index->count)
+    ) {
+        return result;
+    }
+    // verify the checksum before trusting any more of the data
+    if(
+        sxbp_crc32(0, buffer->bytes + payload_index, payload_size - 4)
+        != load_uint32_t(buffer, payload_index + payload_size - 4)
+    ) {
+        result.diagnostic = SXBP_DESERIALISE_BAD_CHECKSUM;
+        return result;
+    }
+    // there must be exactly as many chunks as are needed for all the lines
+    result.diagnostic = SXBP_DESERIALISE_BAD_CHUNK_INDEX;
+    if(
+        (index->chunk_size == 0) ||
+        (index->count != count_chunks(spiral_size, index->chunk_size))
+    ) {
+        return result;
+    }
+    if(load_anchors) {
+        index->anchors = sxbp_calloc(sizeof(chunk_anchor_t), index->count);
+        if((index->anchors == NULL) && (index->count > 0)) {
+            result.status = SXBP_MALLOC_REFUSED;
+            return result;
+        }
+        for(size_t i = 0; i < index->count; i++) {
+            index->anchors[i] = load_chunk_anchor(
+                buffer, payload_index + 8 + (CHUNK_INDEX_ENTRY_SIZE * i)
+            );
+            // each chunk must start where the index says its lines start
+            if(
+                index->anchors[i].offset != header_size + (
+                    SXBP_LINE_T_PACK_SIZE * index->chunk_size * i
+                )
+            ) {
+                sxbp_free(index->anchors);
+                index->anchors = NULL;
+                return result;
+            }
+        }
+    }
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+/*
+ * private type for the state shared between the jobs of a parallel load
+ */
+typedef struct parallel_load_t {
+    sxbp_buffer_t* buffer;
+    chunk_index_t* index;
+    sxbp_spiral_t* spiral;
+    // the co-ord each chunk ends at, as found by decoding its lines
+    sxbp_co_ord_t* ends;
+    // the sum of the lengths of each chunk's lines
+    uint64_t* lengths;
+} parallel_load_t;
+
+// returns the index one past the last line of the given chunk
+static size_t chunk_end(chunk_index_t* index, size_t chunk, size_t size) {
+    size_t end = (chunk + 1) * index->chunk_size;
+    return (end < size) ? end : size;
+}
+
+/*
+ * job which decodes the lines of one chunk of a parallel load, checking them
+ * against the chunk's checksum and finding the co-ord the chunk ends at
+ */
+static sxbp_status_t decode_chunk(size_t chunk, void* user_data) {
+    parallel_load_t* load = (parallel_load_t*)user_data;
+    chunk_anchor_t anchor = load->index->anchors[chunk];
+    size_t start = chunk * load->index->chunk_size;
+    size_t end = chunk_end(load->index, chunk, load->spiral->size);
+    if(
+        sxbp_crc32(
+            0, load->buffer->bytes + anchor.offset,
+            SXBP_LINE_T_PACK_SIZE * (end - start)
+        ) != anchor.crc
+    ) {
+        return SXBP_OPERATION_FAIL;
+    }
+    sxbp_co_ord_t current = anchor.start;
+    uint64_t length = 0;
+    for(size_t i = start; i < end; i++) {
+        sxbp_line_t line = load_line(
+            load->buffer, anchor.offset + ((i - start) * SXBP_LINE_T_PACK_SIZE)
+        );
+        load->spiral->lines[i] = line;
+        // lines which go out of range can't be from a correct chunk index
+        if(!follow_line(&current, line)) {
+            return SXBP_SIZE_OVERFLOW;
+        }
+        length += line.length;
+    }
+    load->ends[chunk] = current;
+    load->lengths[chunk] = length;
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * job which plots the co-ords of the lines of one chunk of a parallel load into
+ * the spiral's co-ord cache, starting from the chunk's anchor
+ */
+static sxbp_status_t plot_chunk(size_t chunk, void* user_data) {
+    parallel_load_t* load = (parallel_load_t*)user_data;
+    chunk_anchor_t anchor = load->index->anchors[chunk];
+    size_t end = chunk_end(load->index, chunk, load->spiral->size);
+    sxbp_co_ord_t* co_ords = load->spiral->co_ord_cache.co_ords.items;
+    sxbp_co_ord_t current = anchor.start;
+    // the anchor's co-ord belongs to the chunk before, except for the origin
+    size_t co_ord_index = (size_t)anchor.cumulative_length;
+    if(chunk == 0) {
+        co_ords[0] = current;
+    }
+    for(size_t i = chunk * load->index->chunk_size; i < end; i++) {
+        sxbp_line_t line = load->spiral->lines[i];
+        sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[line.direction];
+        for(sxbp_length_t j = 0; j < line.length; j++) {
+            current.x += direction.x;
+            current.y += direction.y;
+            co_ords[++co_ord_index] = current;
         }
     }
+    return SXBP_OPERATION_OK;
+}
+
+/*
+ * decodes the lines and plots the co-ords of all the chunks of a parallel load,
+ * using up to thread_count threads to work on different chunks at once. The
+ * spiral's lines must already have been allocated.
+ *
+ * Asserts:
+ * - That load->spiral->lines is not NULL
+ */
+static sxbp_serialise_result_t load_chunks(
+    parallel_load_t* load, size_t thread_count
+) {
+    // preconditional assertions
+    assert(load->spiral->lines != NULL);
+    sxbp_serialise_result_t result = {
+        SXBP_OPERATION_FAIL, SXBP_DESERIALISE_BAD_CHECKSUM,
+    };
+    // first pass: decode and check all of the chunks' lines at once
+    sxbp_status_t status = sxbp_run_parallel_jobs(
+        load->index->count, thread_count, decode_chunk, (void*)load
+    );
+    if(status == SXBP_SIZE_OVERFLOW) {
+        result.diagnostic = SXBP_DESERIALISE_BAD_CHUNK_INDEX;
+        return result;
+    } else if(status == SXBP_OPERATION_FAIL) {
+        // a chunk's lines didn't match its checksum
+        return result;
+    } else if(status != SXBP_OPERATION_OK) {
+        // the jobs couldn't be run, such as if memory for them was refused
+        result.status = status;
+        result.diagnostic = SXBP_DESERIALISE_OK;
+        return result;
+    }
+    // check that every chunk starts where the one before it ends
+    result.diagnostic = SXBP_DESERIALISE_BAD_CHUNK_INDEX;
+    sxbp_co_ord_t start = { 0, 0, };
+    uint64_t total_length = 0;
+    for(size_t i = 0; i < load->index->count; i++) {
+        chunk_anchor_t anchor = load->index->anchors[i];
+        if(
+            (anchor.start.x != start.x) || (anchor.start.y != start.y) ||
+            (anchor.cumulative_length != total_length)
+        ) {
+            return result;
+        }
+        start = load->ends[i];
+        if(load->lengths[i] > UINT64_MAX - total_length) {
+            return result;
+        }
+        total_length += load->lengths[i];
+    }
+    // second pass: plot all of the chunks' co-ords at once
+    sxbp_co_ord_array_t* co_ords = &load->spiral->co_ord_cache.co_ords;
+    co_ords->items = sxbp_calloc(sizeof(sxbp_co_ord_t), (size_t)total_length + 1);
+    if(co_ords->items == NULL) {
+        result.status = SXBP_MALLOC_REFUSED;
+        result.diagnostic = SXBP_DESERIALISE_OK;
+        return result;
+    }
+    co_ords->size = (size_t)total_length + 1;
+    load->spiral->co_ord_cache.validity = load->spiral->size;
+    result.status = sxbp_run_parallel_jobs(
+        load->index->count, thread_count, plot_chunk, (void*)load
+    );
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+sxbp_serialise_result_t sxbp_load_spiral(
+    sxbp_buffer_t buffer, sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(buffer.bytes != NULL);
+    assert(spiral->lines == NULL);
+    assert(spiral->co_ord_cache.co_ords.items == NULL);
+    sxbp_serialise_result_t result; // build struct for returning success / failure
+    // check the header and that the buffer is big enough for what it says
+    size_t header_size = 0;
+    bool extended = false;
+    result = check_buffer_layout(&buffer, &header_size, &extended);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    size_t spiral_size = (size_t)load_spiral_size(&buffer, header_size);
+    size_t lines_size = SXBP_LINE_T_PACK_SIZE * spiral_size;
+    // good to go
+    // populate spiral struct, loading some more values
+    load_header_fields(&buffer, header_size, spiral);
+    // allocate memory
+    spiral->lines = sxbp_calloc(sizeof(sxbp_line_t), spiral->size);
+    // catch allocation error
+    if(spiral->lines == NULL) {
+        result.status = SXBP_MALLOC_REFUSED; // flag failure
+        return result;
+    }
+    // convert each serialised line segment in buffer into a line_t struct
+    for(size_t i = 0; i < spiral_size; i++) {
+        spiral->lines[i] = load_line(
+            &buffer, header_size + (i * SXBP_LINE_T_PACK_SIZE)
+        );
+    }
+    // load any optional sections following the lines
+    if(extended) {
+        result = load_sections(&buffer, header_size + lines_size, spiral);
+        if(result.status != SXBP_OPERATION_OK) {
+            discard_loaded_spiral(spiral);
+            return result;
+        }
+    }
+    // return ok status
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+sxbp_serialise_result_t sxbp_load_spiral_from_stream(
+    size_t(* read_callback)(uint8_t* data, size_t size, void* user_data),
+    void* user_data, sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(read_callback != NULL);
+    assert(spiral->lines == NULL);
+    assert(spiral->co_ord_cache.co_ords.items == NULL);
+    sxbp_serialise_result_t result; // build struct for returning success / failure
+    stream_reader_t reader = { read_callback, user_data, };
+    // all reads go through one small fixed-size staging buffer
+    uint8_t staging_bytes[STREAM_BUFFER_SIZE];
+    sxbp_buffer_t staging = { staging_bytes, STREAM_BUFFER_SIZE, };
+    // read in the plain header first, a stream that ends before it is too small
+    if(
+        read_stream_bytes(&reader, staging.bytes, SXBP_FILE_HEADER_SIZE)
+        != SXBP_FILE_HEADER_SIZE
+    ) {
+        result.status = SXBP_OPERATION_FAIL; // flag failure
+        result.diagnostic = SXBP_DESERIALISE_BAD_HEADER_SIZE; // failure reason
+        return result;
+    }
+    // check the magic number and version, and return early if not right
+    bool extended = false;
+    result = check_file_header(&staging, &extended);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    /*
+     * extended files have a flags field too, and wide ones have 64 bit line
+     * counts after it - these are read in after the plain header so that the
+     * whole header is laid out in the staging buffer as it is in the file
+     */
+    size_t header_size = SXBP_FILE_HEADER_SIZE;
+    if(extended) {
+        size_t flags_size = SXBP_EXTENDED_FILE_HEADER_SIZE - header_size;
+        if(
+            read_stream_bytes(
+                &reader, staging.bytes + header_size, flags_size
+            ) != flags_size
+        ) {
+            result.status = SXBP_OPERATION_FAIL; // flag failure
+            result.diagnostic = SXBP_DESERIALISE_BAD_HEADER_SIZE;
+            return result;
+        }
+        result = check_file_flags(&staging, &header_size);
+        if(result.status != SXBP_OPERATION_OK) {
+            return result;
+        }
+    }
+    if(header_size == SXBP_WIDE_FILE_HEADER_SIZE) {
+        size_t counts_size = header_size - SXBP_EXTENDED_FILE_HEADER_SIZE;
+        if(
+            read_stream_bytes(
+                &reader, staging.bytes + SXBP_EXTENDED_FILE_HEADER_SIZE,
+                counts_size
+            ) != counts_size
+        ) {
+            result.status = SXBP_OPERATION_FAIL; // flag failure
+            result.diagnostic = SXBP_DESERIALISE_BAD_HEADER_SIZE;
+            return result;
+        }
+    }
+    // the spiral must not have more lines than we can count
+    result = check_line_counts(&staging, header_size);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    load_header_fields(&staging, header_size, spiral);
+    /*
+     * the size in the header can't be trusted until the lines have actually
+     * been read, so memory is only allocated for the first chunk of them here,
+     * and the rest as they arrive
+     */
+    size_t chunk_lines = STREAM_BUFFER_SIZE / SXBP_LINE_T_PACK_SIZE;
+    size_t capacity = (
+        spiral->size < chunk_lines
+    ) ? spiral->size : chunk_lines;
+    spiral->lines = sxbp_calloc(sizeof(sxbp_line_t), capacity);
+    // catch allocation error
+    if(spiral->lines == NULL) {
+        result.status = SXBP_MALLOC_REFUSED; // flag failure
+        return result;
+    }
+    // read in the lines in chunks which fit in the staging buffer
+    for(size_t i = 0; i < spiral->size; i += chunk_lines) {
+        size_t count = (
+            (spiral->size - i) < chunk_lines
+        ) ? (spiral->size - i) : chunk_lines;
+        size_t bytes = count * SXBP_LINE_T_PACK_SIZE;
+        if(read_stream_bytes(&reader, staging.bytes, bytes) != bytes) {
+            // the stream ended before all the lines could be read
+            discard_loaded_spiral(spiral);
+            result.status = SXBP_OPERATION_FAIL; // flag failure
+            result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE;
+            return result;
+        }
+        if(
+            !grow_loaded_array(
+                (void**)&spiral->lines, sizeof(sxbp_line_t), &capacity,
+                i + count, spiral->size
+            )
+        ) {
+            discard_loaded_spiral(spiral);
+            result.status = SXBP_MALLOC_REFUSED; // flag failure
+            return result;
+        }
+        for(size_t j = 0; j < count; j++) {
+            spiral->lines[i + j] = load_line(
+                &staging, j * SXBP_LINE_T_PACK_SIZE
+            );
+        }
+    }
+    // load any optional sections following the lines
+    if(extended) {
+        result = read_sections(&reader, &staging, spiral);
+        if(result.status != SXBP_OPERATION_OK) {
+            discard_loaded_spiral(spiral);
+            return result;
+        }
+    } else if(read_stream_bytes(&reader, staging.bytes, 1) != 0) {
+        // as with sxbp_load_spiral(), plain files must end after their lines
+        discard_loaded_spiral(spiral);
+        result.status = SXBP_OPERATION_FAIL; // flag failure
+        result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE;
+        return result;
+    }
     // return ok status
     result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
     return result;
 }
 
+sxbp_serialise_result_t sxbp_load_spiral_from_file(
+    FILE* file, sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(file != NULL);
+    return sxbp_load_spiral_from_stream(read_from_file, (void*)file, spiral);
+}
+
+sxbp_serialise_result_t sxbp_load_spiral_in_parallel(
+    sxbp_buffer_t buffer, size_t thread_count, sxbp_spiral_t* spiral
+) {
+    // preconditional assertions
+    assert(buffer.bytes != NULL);
+    assert(spiral->lines == NULL);
+    assert(spiral->co_ord_cache.co_ords.items == NULL);
+    sxbp_serialise_result_t result; // build struct for returning success / failure
+    size_t header_size = 0;
+    bool extended = false;
+    result = check_buffer_layout(&buffer, &header_size, &extended);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    chunk_index_t index = { 0, 0, NULL, };
+    if(extended) {
+        result = load_chunk_index(&buffer, header_size, true, &index);
+    }
+    if(!extended || (result.diagnostic == SXBP_DESERIALISE_MISSING_SECTION)) {
+        // without a chunk index, fall back to loading and plotting serially
+        result = sxbp_load_spiral(buffer, spiral);
+        if(result.status != SXBP_OPERATION_OK) {
+            return result;
+        }
+        result.status = sxbp_cache_spiral_points(spiral, spiral->size);
+        if(result.status != SXBP_OPERATION_OK) {
+            discard_loaded_spiral(spiral);
+        }
+        return result;
+    } else if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    load_header_fields(&buffer, header_size, spiral);
+    parallel_load_t load = {
+        .buffer = &buffer,
+        .index = &index,
+        .spiral = spiral,
+        .ends = sxbp_calloc(sizeof(sxbp_co_ord_t), index.count),
+        .lengths = sxbp_calloc(sizeof(uint64_t), index.count),
+    };
+    spiral->lines = sxbp_calloc(sizeof(sxbp_line_t), spiral->size);
+    if((load.ends == NULL) || (load.lengths == NULL) || (spiral->lines == NULL)) {
+        result.status = SXBP_MALLOC_REFUSED;
+    } else {
+        result = load_chunks(&load, thread_count);
+    }
+    if(result.status != SXBP_OPERATION_OK) {
+        discard_loaded_spiral(spiral);
+    }
+    sxbp_free(load.ends);
+    sxbp_free(load.lengths);
+    sxbp_free(index.anchors);
+    return result;
+}
+
+sxbp_serialise_result_t sxbp_load_spiral_line(
+    sxbp_buffer_t buffer, sxbp_line_count_t index, sxbp_line_t* line,
+    sxbp_co_ord_t* start_co_ord
+) {
+    // preconditional assertions
+    assert(buffer.bytes != NULL);
+    assert(line != NULL);
+    assert(start_co_ord != NULL);
+    sxbp_serialise_result_t result; // build struct for returning success / failure
+    size_t header_size = 0;
+    bool extended = false;
+    result = check_buffer_layout(&buffer, &header_size, &extended);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    } else if(!extended) {
+        // files in the plain format have no optional sections at all
+        result.status = SXBP_OPERATION_FAIL;
+        result.diagnostic = SXBP_DESERIALISE_MISSING_SECTION;
+        return result;
+    }
+    // load and check the chunk index, but not all of its entries
+    chunk_index_t chunks = { 0, 0, NULL, };
+    result = load_chunk_index(&buffer, header_size, false, &chunks);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    size_t spiral_size = (size_t)load_spiral_size(&buffer, header_size);
+    if(index >= spiral_size) {
+        result.status = SXBP_OPERATION_FAIL;
+        result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE;
+        return result;
+    }
+    // the index section is known to be there and intact, so find the entry
+    size_t payload_index = 0;
+    size_t payload_size = 0;
+    find_section(
+        &buffer, header_size + (SXBP_LINE_T_PACK_SIZE * spiral_size),
+        CHUNK_INDEX_SECTION_TAG, &payload_index, &payload_size
+    );
+    size_t chunk = index / chunks.chunk_size;
+    chunk_anchor_t anchor = load_chunk_anchor(
+        &buffer, payload_index + 8 + (CHUNK_INDEX_ENTRY_SIZE * chunk)
+    );
+    result.status = SXBP_OPERATION_FAIL;
+    result.diagnostic = SXBP_DESERIALISE_BAD_CHUNK_INDEX;
+    if(
+        anchor.offset != header_size + (
+            SXBP_LINE_T_PACK_SIZE * chunks.chunk_size * chunk
+        )
+    ) {
+        return result;
+    }
+    // only this chunk's lines need to be checked and decoded
+    size_t start = chunk * chunks.chunk_size;
+    size_t end = chunk_end(&chunks, chunk, spiral_size);
+    if(
+        sxbp_crc32(
+            0, buffer.bytes + anchor.offset,
+            SXBP_LINE_T_PACK_SIZE * (end - start)
+        ) != anchor.crc
+    ) {
+        result.diagnostic = SXBP_DESERIALISE_BAD_CHECKSUM;
+        return result;
+    }
+    sxbp_co_ord_t current = anchor.start;
+    for(size_t i = start; i < index; i++) {
+        sxbp_line_t previous = load_line(
+            &buffer, header_size + (i * SXBP_LINE_T_PACK_SIZE)
+        );
+        // lines which go out of range can't be from a correct chunk index
+        if(!follow_line(&current, previous)) {
+            return result;
+        }
+    }
+    *line = load_line(&buffer, header_size + (index * SXBP_LINE_T_PACK_SIZE));
+    *start_co_ord = current;
+    // return ok status
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+sxbp_serialise_result_t sxbp_dump_spiral(
+    sxbp_spiral_t spiral, sxbp_buffer_t* buffer
+) {
+    // no optional sections
+    sxbp_dump_options_t options = {
+        .include_co_ord_cache = false, .chunk_size = 0,
+    };
+    return sxbp_dump_spiral_with_options(spiral, options, buffer);
+}
+
+/*
+ * private function, serialises the spiral with the given options to the start
+ * of the buffer, which must have room for all of it, given the count of
+ * co-ords to store from the co-ord cache (see dumped_size())
+ */
+static sxbp_status_t dump_to_buffer(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, size_t co_ord_count,
+    sxbp_buffer_t* buffer
+) {
+    // stream the data into the buffer, which is already big enough for it
+    buffer_stream_t stream = { buffer, 0, };
+    stream_writer_t writer = {
+        .buffer = { NULL, STREAM_BUFFER_SIZE, },
+        .used = 0,
+        .write_callback = write_to_buffer_stream,
+        .user_data = (void*)&stream,
+        .failed = false,
+    };
+    writer.buffer.bytes = writer.bytes;
+    return dump_to_stream(spiral, options, co_ord_count, &writer);
+}
+
+sxbp_serialise_result_t sxbp_dump_spiral_with_options(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, sxbp_buffer_t* buffer
+) {
+    // preconditional assertions
+    assert(buffer->bytes == NULL);
+    assert(spiral.lines != NULL);
+    sxbp_serialise_result_t result; // build struct for returning success / failure
+    // populate buffer struct, base size on header + spiral size + sections
+    size_t co_ord_count = 0;
+    buffer->size = dumped_size(spiral, options, &co_ord_count);
+    // allocate memory for buffer
+    buffer->bytes = sxbp_calloc(1, buffer->size);
+    // catch memory allocation failure
+    if(buffer->bytes == NULL) {
+        result.status = SXBP_MALLOC_REFUSED;
+        return result;
+    }
+    result.status = dump_to_buffer(spiral, options, co_ord_count, buffer);
+    if(result.status != SXBP_OPERATION_OK) {
+        sxbp_free(buffer->bytes);
+        buffer->bytes = NULL;
+        return result;
+    }
+    // return ok status
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+size_t sxbp_get_dump_size(sxbp_spiral_t spiral, sxbp_dump_options_t options) {
+    size_t co_ord_count = 0;
+    return dumped_size(spiral, options, &co_ord_count);
+}
+
+sxbp_serialise_result_t sxbp_dump_spiral_into(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, sxbp_buffer_t* buffer
+) {
+    // preconditional assertions
+    assert(buffer->bytes != NULL);
+    assert(spiral.lines != NULL);
+    sxbp_serialise_result_t result; // build struct for returning success / failure
+    size_t co_ord_count = 0;
+    size_t size = dumped_size(spiral, options, &co_ord_count);
+    // check that the spiral will fit in the buffer
+    if(buffer->size < size) {
+        result.status = SXBP_OPERATION_FAIL;
+        result.diagnostic = SXBP_DESERIALISE_BAD_DATA_SIZE;
+        return result;
+    }
+    buffer->size = size;
+    result.status = dump_to_buffer(spiral, options, co_ord_count, buffer);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // return ok status
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+sxbp_serialise_result_t sxbp_dump_spiral_to_stream(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options,
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data),
+    void* user_data
+) {
+    // preconditional assertions
+    assert(spiral.lines != NULL);
+    assert(write_callback != NULL);
+    sxbp_serialise_result_t result; // build struct for returning success / failure
+    size_t co_ord_count = 0;
+    dumped_size(spiral, options, &co_ord_count);
+    // set up the stream writer and its fixed-size staging buffer
+    stream_writer_t writer = {
+        .buffer = { NULL, STREAM_BUFFER_SIZE, },
+        .used = 0,
+        .write_callback = write_callback,
+        .user_data = user_data,
+        .failed = false,
+    };
+    writer.buffer.bytes = writer.bytes;
+    result.status = dump_to_stream(spiral, options, co_ord_count, &writer);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // report if the stream didn't accept all of the data
+    if(writer.failed) {
+        result.status = SXBP_OPERATION_FAIL;
+        result.diagnostic = SXBP_DESERIALISE_STREAM_ERROR;
+        return result;
+    }
+    // return ok status
+    result.status = SXBP_OPERATION_OK;
+    result.diagnostic = SXBP_DESERIALISE_OK;
+    return result;
+}
+
+sxbp_serialise_result_t sxbp_dump_spiral_to_file(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, FILE* file
+) {
+    // preconditional assertions
+    assert(file != NULL);
+    return sxbp_dump_spiral_to_stream(
+        spiral, options, write_to_file, (void*)file
+    );
+}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -22,7 +22,10 @@
 #ifndef SAXBOPHONE_SAXBOSPIRAL_SERIALISE_H
 #define SAXBOPHONE_SAXBOSPIRAL_SERIALISE_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 
 #include "saxbospiral.h"
 
@@ -45,6 +48,14 @@ typedef enum sxbp_deserialise_diagnostic_t {
     SXBP_DESERIALISE_BAD_VERSION,
     /** @brief data section too small to be valid */
     SXBP_DESERIALISE_BAD_DATA_SIZE,
+    /** @brief checksum of an optional section doesn't match its contents */
+    SXBP_DESERIALISE_BAD_CHECKSUM,
+    /** @brief a stream refused to accept all of the data written to it */
+    SXBP_DESERIALISE_STREAM_ERROR,
+    /** @brief an optional section needed for the operation isn't present */
+    SXBP_DESERIALISE_MISSING_SECTION,
+    /** @brief the chunk index doesn't agree with the lines it indexes */
+    SXBP_DESERIALISE_BAD_CHUNK_INDEX,
 } sxbp_deserialise_diagnostic_t;
 
 /**
@@ -57,8 +68,47 @@ typedef struct sxbp_serialise_result_t {
     sxbp_deserialise_diagnostic_t diagnostic;
 } sxbp_serialise_result_t;
 
+/**
+ * @brief Options controlling which optional sections are written to a file.
+ * @details A default-initialised struct of this type (all fields 0 or false)
+ * produces exactly the same output as sxbp_dump_spiral().
+ */
+typedef struct sxbp_dump_options_t {
+    /**
+     * @brief whether to store the spiral's co-ord cache alongside the lines
+     * @details Storing the cache makes the file considerably larger, but means
+     * that when it is loaded again, solving can resume without first having to
+     * re-plot all of the co-ords of the lines solved so far.
+     */
+    bool include_co_ord_cache;
+    /**
+     * @brief how many lines to group into each chunk of the chunk index, or 0
+     * to not write a chunk index
+     * @details The chunk index records, for every chunk of this many lines,
+     * where its lines are in the file, the co-ord its first line starts at, the
+     * sum of the lengths of all the lines before it and a checksum of its
+     * lines. This allows the chunks to be loaded independently of each other,
+     * see sxbp_load_spiral_in_parallel() and sxbp_load_spiral_line().
+     */
+    uint32_t chunk_size;
+} sxbp_dump_options_t;
+
 /** @brief The size of the file header in bytes */
 extern const size_t SXBP_FILE_HEADER_SIZE;
+/**
+ * @brief The size of the file header in bytes, for files which contain
+ * optional sections
+ */
+extern const size_t SXBP_EXTENDED_FILE_HEADER_SIZE;
+/**
+ * @brief The size of the file header in bytes, for files of spirals with too
+ * many lines to count in 32 bits
+ * @details These files are only written by builds with wide mode enabled (see
+ * SXBP_WIDE_MODE). They are marked by a flag in the extended header, which is
+ * followed by the line counts in 64 bits. Builds without wide mode can read
+ * them, as long as the spiral's line counts fit in 32 bits.
+ */
+extern const size_t SXBP_WIDE_FILE_HEADER_SIZE;
 /** @brief The size in bytes of one line when stored in the file */
 extern const size_t SXBP_LINE_T_PACK_SIZE;
 
@@ -66,15 +116,20 @@ extern const size_t SXBP_LINE_T_PACK_SIZE;
  * @brief De-serialises a spiral from a buffer.
  * @details Reads in a binary representation of a spiral and populates a given
  * spiral with the data which represents this spiral (if input data is valid).
+ * If the data contains a stored co-ord cache (see sxbp_dump_options_t), then
+ * the spiral's co-ord cache is populated from it too, once its checksum has
+ * been verified. Any optional sections which are not recognised are skipped.
  *
  * @param buffer The data buffer to load the spiral from.
  * @param[out] spiral The spiral to write the spiral data to.
  * @return For information on return values, see the documentation of the return
- * types.
+ * types. SXBP_SIZE_OVERFLOW is given as the status if the spiral has more lines
+ * than this build of the library can count (see SXBP_WIDE_MODE).
  *
  * @note Asserts:
  * - That buffer.bytes is not NULL
  * - That spiral->lines is NULL
+ * - That spiral->co_ord_cache.co_ords.items is NULL
  *
  * @see sxbp_status_t for generic error return codes and
  * sxbp_deserialise_diagnostic_t for file-specific error return codes.
@@ -83,6 +138,120 @@ sxbp_serialise_result_t sxbp_load_spiral(
     sxbp_buffer_t buffer, sxbp_spiral_t* spiral
 );
 
+/**
+ * @brief De-serialises a spiral from a stream of data.
+ * @details Behaves like sxbp_load_spiral(), except that the data is pulled in
+ * via a read callback in small chunks, rather than having to be held in memory
+ * all at once. Only the memory needed for the spiral itself is allocated, and
+ * only as its data arrives, so a stream which ends early never causes more
+ * memory to be allocated than is needed for the data it did contain. The whole
+ * stream is read, until the read callback signals the end of it. As with
+ * sxbp_load_spiral(), plain files must end straight after their lines, whereas
+ * files containing optional sections are read section by section.
+ *
+ * @param read_callback A function pointer with the following signature:
+ * @code
+ * size_t callback_name(uint8_t* data, size_t size, void* user_data)
+ * @endcode
+ * The callback should read up to size bytes into data, returning the number of
+ * bytes actually read. Fewer bytes than requested may be returned at any time,
+ * but returning 0 signals the end of the stream (or an error).
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the read callback every time it is called (such as a file handle).
+ * @param[out] spiral The spiral to write the spiral data to.
+ * @return For information on return values, see the documentation of the return
+ * types. If the stream ends unexpectedly, this is reported with the same
+ * diagnostics that a buffer which is too small would cause.
+ *
+ * @note Asserts:
+ * - That read_callback is not NULL
+ * - That spiral->lines is NULL
+ * - That spiral->co_ord_cache.co_ords.items is NULL
+ */
+sxbp_serialise_result_t sxbp_load_spiral_from_stream(
+    size_t(* read_callback)(uint8_t* data, size_t size, void* user_data),
+    void* user_data, sxbp_spiral_t* spiral
+);
+
+/**
+ * @brief De-serialises a spiral from a file.
+ * @details Convenience wrapper for sxbp_load_spiral_from_stream() which reads
+ * from a file opened for reading in binary mode.
+ *
+ * @param file The file to read the spiral data from.
+ * @param[out] spiral The spiral to write the spiral data to.
+ * @return For information on return values, see the documentation of the return
+ * types.
+ *
+ * @note Asserts:
+ * - That file is not NULL
+ * - That spiral->lines is NULL
+ * - That spiral->co_ord_cache.co_ords.items is NULL
+ */
+sxbp_serialise_result_t sxbp_load_spiral_from_file(
+    FILE* file, sxbp_spiral_t* spiral
+);
+
+/**
+ * @brief De-serialises a spiral from a buffer using multiple threads, plotting
+ * all of its co-ords too.
+ * @details Loads the spiral like sxbp_load_spiral() does, but uses the file's
+ * chunk index (see sxbp_dump_options_t) to decode the lines of different chunks
+ * and re-build their co-ords on up to thread_count threads at once. The
+ * spiral's co-ord cache is populated for all of its lines. Any stored co-ord
+ * cache in the file is not needed and is ignored.
+ *
+ * If the file has no chunk index, then this falls back to calling
+ * sxbp_load_spiral() followed by sxbp_cache_spiral_points() for all lines.
+ *
+ * @param buffer The data buffer to load the spiral from.
+ * @param thread_count The maximum number of threads to use. 0 or 1 means do
+ * all of the work on the calling thread. This is ignored if the library was
+ * built without thread support (see SXBP_THREAD_SUPPORT).
+ * @param[out] spiral The spiral to write the spiral data to.
+ * @return For information on return values, see the documentation of the return
+ * types. SXBP_DESERIALISE_BAD_CHECKSUM is given if the lines of any chunk don't
+ * match the checksum stored for them, and SXBP_DESERIALISE_BAD_CHUNK_INDEX if
+ * the co-ords or lengths stored for any chunk don't match the lines, or its
+ * lines would take the co-ords out of the range of sxbp_tuple_item_t.
+ *
+ * @note Asserts:
+ * - That buffer.bytes is not NULL
+ * - That spiral->lines is NULL
+ * - That spiral->co_ord_cache.co_ords.items is NULL
+ */
+sxbp_serialise_result_t sxbp_load_spiral_in_parallel(
+    sxbp_buffer_t buffer, size_t thread_count, sxbp_spiral_t* spiral
+);
+
+/**
+ * @brief Loads just one line of a spiral from a buffer, along with the co-ord
+ * at which it starts.
+ * @details Uses the file's chunk index (see sxbp_dump_options_t) to find the
+ * chunk containing the line, so that only the lines of that one chunk need to
+ * be checked and decoded, rather than all of the lines before it.
+ *
+ * @param buffer The data buffer to load the line from.
+ * @param index The index of the line to load.
+ * @param[out] line The line to write the loaded line to.
+ * @param[out] start_co_ord The co-ord to write the line's start co-ord to.
+ * @return For information on return values, see the documentation of the return
+ * types. SXBP_DESERIALISE_MISSING_SECTION is given if the file has no chunk
+ * index, SXBP_DESERIALISE_BAD_DATA_SIZE if index is not less than the
+ * number of lines in the spiral, and SXBP_DESERIALISE_BAD_CHUNK_INDEX if the
+ * entry for the line's chunk doesn't match its lines, or they would take the
+ * co-ord out of the range of sxbp_tuple_item_t.
+ *
+ * @note Asserts:
+ * - That buffer.bytes is not NULL
+ * - That line is not NULL
+ * - That start_co_ord is not NULL
+ */
+sxbp_serialise_result_t sxbp_load_spiral_line(
+    sxbp_buffer_t buffer, sxbp_line_count_t index, sxbp_line_t* line,
+    sxbp_co_ord_t* start_co_ord
+);
+
 /**
  * @brief Serialises a spiral to a buffer.
  * @details Writes out a binary representation of a given spiral to a buffer,
@@ -107,6 +276,118 @@ sxbp_serialise_result_t sxbp_dump_spiral(
     sxbp_spiral_t spiral, sxbp_buffer_t* buffer
 );
 
+/**
+ * @brief Serialises a spiral to a buffer, including any optional sections
+ * requested.
+ * @details Behaves like sxbp_dump_spiral(), except that additional sections
+ * may be written after the lines of the spiral as selected by the options
+ * given. If no optional sections are selected, the output is identical to that
+ * of sxbp_dump_spiral(). Spirals with too many lines to count in 32 bits are
+ * always written with the wide header (see SXBP_WIDE_FILE_HEADER_SIZE).
+ *
+ * @param spiral The spiral which should be serialised to buffer.
+ * @param options Which optional sections should be written.
+ * @param[out] buffer The data buffer to write out the spiral data to.
+ * @return For information on return values, see the documentation of the return
+ * types. SXBP_SIZE_OVERFLOW is given as the status if a chunk index is asked
+ * for but the spiral's co-ords or number of chunks don't fit in it.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That buffer->bytes is NULL
+ */
+sxbp_serialise_result_t sxbp_dump_spiral_with_options(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, sxbp_buffer_t* buffer
+);
+
+/**
+ * @brief Gets the exact size of a spiral once serialised.
+ * @details This is the number of bytes that sxbp_dump_spiral_with_options()
+ * would write, and so how big a buffer sxbp_dump_spiral_into() needs.
+ *
+ * @param spiral The spiral which would be serialised.
+ * @param options Which optional sections would be written.
+ * @return The size of the serialised spiral in bytes.
+ */
+size_t sxbp_get_dump_size(sxbp_spiral_t spiral, sxbp_dump_options_t options);
+
+/**
+ * @brief Serialises a spiral to a buffer provided by the caller.
+ * @details Writes out exactly the same data as sxbp_dump_spiral_with_options()
+ * would, but into memory the caller already has (such as a slab of a pool, or a
+ * file mapped into memory) rather than a newly allocated buffer. Use
+ * sxbp_get_dump_size() to find out how big the buffer needs to be.
+ *
+ * @param spiral The spiral which should be serialised.
+ * @param options Which optional sections should be written.
+ * @param[in, out] buffer The buffer to write the spiral data to. Its size
+ * should be the number of bytes available at buffer->bytes. On success, this
+ * is set to the number of bytes written, which start at buffer->bytes.
+ * @return SXBP_OPERATION_OK as the status on success.
+ * @return SXBP_OPERATION_FAIL as the status with SXBP_DESERIALISE_BAD_DATA_SIZE
+ * as the diagnostic if the buffer is too small, in which case nothing is
+ * written.
+ * @return SXBP_MALLOC_REFUSED as the status on memory allocation failure.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That buffer->bytes is not NULL
+ */
+sxbp_serialise_result_t sxbp_dump_spiral_into(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, sxbp_buffer_t* buffer
+);
+
+/**
+ * @brief Serialises a spiral to a stream of data.
+ * @details Writes out exactly the same data as sxbp_dump_spiral_with_options()
+ * would, but in small chunks via a write callback, using only a small fixed
+ * size buffer. This means that the whole of the serialised data never has to
+ * be held in memory at once.
+ *
+ * @param spiral The spiral which should be serialised.
+ * @param options Which optional sections should be written.
+ * @param write_callback A function pointer with the following signature:
+ * @code
+ * size_t callback_name(const uint8_t* data, size_t size, void* user_data)
+ * @endcode
+ * The callback should write out all size bytes of data, returning the number
+ * of bytes actually written. Returning anything less than size is treated as
+ * an error, after which the callback will not be called again.
+ * @param user_data An optional void pointer to a user-defined type, which is
+ * passed to the write callback every time it is called (such as a file handle).
+ * @return SXBP_OPERATION_OK as the status on success.
+ * @return SXBP_OPERATION_FAIL as the status with SXBP_DESERIALISE_STREAM_ERROR
+ * as the diagnostic if the write callback didn't write all of the data.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That write_callback is not NULL
+ */
+sxbp_serialise_result_t sxbp_dump_spiral_to_stream(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options,
+    size_t(* write_callback)(const uint8_t* data, size_t size, void* user_data),
+    void* user_data
+);
+
+/**
+ * @brief Serialises a spiral to a file.
+ * @details Convenience wrapper for sxbp_dump_spiral_to_stream() which writes
+ * to a file opened for writing in binary mode.
+ *
+ * @param spiral The spiral which should be serialised.
+ * @param options Which optional sections should be written.
+ * @param file The file to write the spiral data to.
+ * @return For information on return values, see the documentation of the return
+ * types.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That file is not NULL
+ */
+sxbp_serialise_result_t sxbp_dump_spiral_to_file(
+    sxbp_spiral_t spiral, sxbp_dump_options_t options, FILE* file
+);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
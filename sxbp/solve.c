@@ -15,6 +15,7 @@
 #include <time.h>
 
 #include "saxbospiral.h"
+#include "allocator.h"
 #include "plot.h"
 #include "solve.h"
 
@@ -60,11 +61,202 @@ static void synchronise_spiral_timing(sxbp_spiral_t* spiral) {
     }
 }
 
+/*
+ * private types for compact copies of a spiral's co-ord cache, which the solver
+ * checks for collisions instead of the cache itself for as long as all of the
+ * spiral's co-ords fit in them. These take up half as much memory as the
+ * cache (or a quarter, for 16 bit co-ords in wide mode), so many more of them
+ * fit in the CPU's caches while the solver is scanning them.
+ */
+typedef struct co_ord16_t {
+    int16_t x;
+    int16_t y;
+} co_ord16_t;
+
+#ifdef LIBSXBP_WIDE_MODE
+typedef struct co_ord32_t {
+    int32_t x;
+    int32_t y;
+} co_ord32_t;
+#endif
+
+// private type for which type of co-ords a compact_cache_t holds
+typedef enum compact_width_t {
+    // no compact copy, the spiral's co-ord cache is used directly
+    COMPACT_NONE,
+    COMPACT_16,
+#ifdef LIBSXBP_WIDE_MODE
+    COMPACT_32,
+#endif
+} compact_width_t;
+
+// private type for a compact copy of a spiral's co-ord cache
+typedef struct compact_cache_t {
+    compact_width_t width;
+    // the co-ords, of the type given by width
+    void* items;
+    // how many co-ords there is room for in items
+    size_t capacity;
+    // how many co-ords at the start of items match the spiral's co-ord cache
+    size_t validity;
+} compact_cache_t;
+
+/*
+ * defines a private function called find_collision_<suffix>(), which checks
+ * the given co-ords of the spiral (items, holding co-ords of co_ord_type) for
+ * collisions in the way described by spiral_collides(). The same kernel is
+ * defined for each type of co-ord that the co-ords may be stored in.
+ */
+#define DEFINE_COLLISION_KERNEL(suffix, co_ord_type) \
+static bool find_collision_##suffix( \
+    sxbp_spiral_t* spiral, const co_ord_type* items, size_t index \
+) { \
+    /* initialise a counter to keep track of what line we're on */ \
+    sxbp_line_count_t line_count = 0; \
+    uint32_t ttl = spiral->lines[line_count].length + 1; /* ttl of line */ \
+    size_t last_co_ord = spiral->co_ord_cache.co_ords.size; \
+    sxbp_line_t last_line = spiral->lines[index]; \
+    size_t start_of_last_line = (last_co_ord - last_line.length) - 1; \
+    /* check the co-ords of the last line segment against all the others */ \
+    for(size_t i = 0; i < start_of_last_line; i++) { \
+        for(size_t j = start_of_last_line; j < last_co_ord; j++) { \
+            if((items[i].x == items[j].x) && (items[i].y == items[j].y)) { \
+                spiral->collider = line_count; \
+                return true; \
+            } \
+        } \
+        /* update ttl (and counter if needed) */ \
+        ttl--; \
+        if(ttl == 0) { \
+            line_count++; \
+            ttl = spiral->lines[line_count].length; \
+        } \
+        /* \
+         * terminate the loop if the next line would be the line 2 lines \
+         * before the last one (these two lines can never collide with the \
+         * last and can be safely ignored, for a small performance increase) \
+         */ \
+        if(line_count == (spiral->size - 2 - 1)) { /* -1 for zero-index */ \
+            break; \
+        } \
+    } \
+    return false; \
+}
+
+/*
+ * defines a private function called copy_co_ords_<suffix>(), which copies the
+ * co-ords from start up to end of the spiral's co-ord cache into items, which
+ * holds co-ords of co_ord_type with x and y of item_type. The co-ords must all
+ * fit in item_type.
+ */
+#define DEFINE_COPY_KERNEL(suffix, co_ord_type, item_type) \
+static void copy_co_ords_##suffix( \
+    const sxbp_spiral_t* spiral, void* items, size_t start, size_t end \
+) { \
+    const sxbp_co_ord_t* source = spiral->co_ord_cache.co_ords.items; \
+    co_ord_type* target = (co_ord_type*)items; \
+    for(size_t i = start; i < end; i++) { \
+        target[i].x = (item_type)source[i].x; \
+        target[i].y = (item_type)source[i].y; \
+    } \
+}
+
+DEFINE_COLLISION_KERNEL(full, sxbp_co_ord_t)
+DEFINE_COLLISION_KERNEL(16, co_ord16_t)
+DEFINE_COPY_KERNEL(16, co_ord16_t, int16_t)
+#ifdef LIBSXBP_WIDE_MODE
+DEFINE_COLLISION_KERNEL(32, co_ord32_t)
+DEFINE_COPY_KERNEL(32, co_ord32_t, int32_t)
+#endif
+
+/*
+ * private function, returns the narrowest type of compact co-ords that all of
+ * the co-ords within the given bounds fit in
+ */
+static compact_width_t get_compact_width(const sxbp_co_ord_t bounds[2]) {
+    if(
+        (bounds[0].x >= INT16_MIN) && (bounds[0].y >= INT16_MIN) &&
+        (bounds[1].x <= INT16_MAX) && (bounds[1].y <= INT16_MAX)
+    ) {
+        return COMPACT_16;
+    }
+#ifdef LIBSXBP_WIDE_MODE
+    if(
+        (bounds[0].x >= INT32_MIN) && (bounds[0].y >= INT32_MIN) &&
+        (bounds[1].x <= INT32_MAX) && (bounds[1].y <= INT32_MAX)
+    ) {
+        return COMPACT_32;
+    }
+#endif
+    return COMPACT_NONE;
+}
+
+// private function, frees the co-ords of a compact cache and stops using it
+static void free_compact_cache(compact_cache_t* compact) {
+    sxbp_free(compact->items);
+    compact->width = COMPACT_NONE;
+    compact->items = NULL;
+    compact->capacity = 0;
+    compact->validity = 0;
+}
+
+/*
+ * private function, brings the compact copy of the spiral's co-ord cache up to
+ * date with the cache, which must have just been updated. The narrowest type
+ * of co-ords that the cache's co-ords all fit in is used, going by its bounds,
+ * and once they don't fit in any, the compact copy is freed so that the cache
+ * is used directly. Running out of memory is not an error here - the cache is
+ * just used directly instead.
+ */
+static void update_compact_cache(
+    const sxbp_spiral_t* spiral, compact_cache_t* compact
+) {
+    compact_width_t width = get_compact_width(spiral->co_ord_cache.bounds);
+    if(width == COMPACT_NONE) {
+        free_compact_cache(compact);
+        return;
+    } else if(width != compact->width) {
+        // none of the co-ords in the old type can be used, nor its capacity
+        compact->width = width;
+        compact->capacity = 0;
+        compact->validity = 0;
+    }
+    size_t item_size = sizeof(co_ord16_t);
+#ifdef LIBSXBP_WIDE_MODE
+    if(width == COMPACT_32) {
+        item_size = sizeof(co_ord32_t);
+    }
+#endif
+    size_t size = spiral->co_ord_cache.co_ords.size;
+    if(size > compact->capacity) {
+        // grow ahead of the cache, as it grows by one line at a time
+        size_t capacity = size * 2;
+        void* items = sxbp_realloc(compact->items, capacity * item_size);
+        if(items == NULL) {
+            free_compact_cache(compact);
+            return;
+        }
+        compact->items = items;
+        compact->capacity = capacity;
+    }
+    if(compact->validity < size) {
+        if(width == COMPACT_16) {
+            copy_co_ords_16(spiral, compact->items, compact->validity, size);
+        }
+#ifdef LIBSXBP_WIDE_MODE
+        if(width == COMPACT_32) {
+            copy_co_ords_32(spiral, compact->items, compact->validity, size);
+        }
+#endif
+    }
+    compact->validity = size;
+}
+
 /*
  * private function, given a pointer to a spiral struct and the index of the
  * highest line to use, check if the latest line would collide with any of the
  * others, given their current directions and jump sizes (using co-ords stored
- * in cache).
+ * in cache, or the compact copy of it, if one is given and in use).
  * NOTE: This assumes that all lines except the most recent are valid and
  * don't collide.
  * Returns boolean on whether or not the spiral collides or not. Also, sets the
@@ -76,7 +268,9 @@ static void synchronise_spiral_timing(sxbp_spiral_t* spiral) {
  * - That spiral->co_ord_cache.co_ords.items is not NULL
  * - That index is less than spiral->size
  */
-static bool spiral_collides(sxbp_spiral_t* spiral, size_t index) {
+static bool spiral_collides(
+    sxbp_spiral_t* spiral, size_t index, const compact_cache_t* compact
+) {
     // preconditional assertions
     assert(spiral->lines != NULL);
     assert(spiral->co_ord_cache.co_ords.items != NULL);
@@ -87,47 +281,23 @@ static bool spiral_collides(sxbp_spiral_t* spiral, size_t index) {
      */
     if(spiral->size < 4) {
         return false;
-    } else {
-        // initialise a counter to keep track of what line we're on
-        uint32_t line_count = 0;
-        uint32_t ttl = spiral->lines[line_count].length + 1; // ttl of line
-        size_t last_co_ord = spiral->co_ord_cache.co_ords.size;
-        sxbp_line_t last_line = spiral->lines[index];
-        uint32_t start_of_last_line = (last_co_ord - last_line.length) - 1;
-        // check the co-ords of the last line segment against all the others
-        for(uint32_t i = 0; i < start_of_last_line; i++) {
-            for(size_t j = start_of_last_line; j < last_co_ord; j++) {
-                if(
-                    (
-                        spiral->co_ord_cache.co_ords.items[i].x ==
-                        spiral->co_ord_cache.co_ords.items[j].x
-                    )
-                    &&
-                    (
-                        spiral->co_ord_cache.co_ords.items[i].y ==
-                        spiral->co_ord_cache.co_ords.items[j].y
-                    )
-                ) {
-                    spiral->collider = line_count;
-                    return true;
-                }
-            }
-            // update ttl (and counter if needed)
-            ttl--;
-            if(ttl == 0) {
-                line_count++;
-                ttl = spiral->lines[line_count].length;
-            }
-            /*
-             * terminate the loop if the next line would be the line 2 lines
-             * before the last one (these two lines can never collide with the
-             * last and can be safely ignored, for a small performance increase)
-             */
-            if(line_count == (spiral->size - 2 - 1)) { // -1 for zero-index
-                break;
-            }
-        }
-        return false;
+    }
+    // use the narrowest copy of the co-ords there is
+    switch(compact->width) {
+        case COMPACT_16:
+            return find_collision_16(
+                spiral, (const co_ord16_t*)compact->items, index
+            );
+#ifdef LIBSXBP_WIDE_MODE
+        case COMPACT_32:
+            return find_collision_32(
+                spiral, (const co_ord32_t*)compact->items, index
+            );
+#endif
+        default:
+            return find_collision_full(
+                spiral, spiral->co_ord_cache.co_ords.items, index
+            );
     }
 }
 
@@ -136,7 +306,8 @@ static bool spiral_collides(sxbp_spiral_t* spiral, size_t index) {
  * segment in the spiral (i.e. the one that was found to be colliding) and a
  * perfection threshold (0 for no perfection, or otherwise the maximmum line
  * length at which to allow aggressive optimisation), return a suggested length
- * to set the segment before this line to.
+ * to set the segment before this line to. The suggestion may be too long for a
+ * line to hold (more than SXBP_LENGTH_MAX), which the caller has to check.
  *
  * NOTE: This function is not guaranteed to make suggestions that will not
  * collide. Every suggestion that is followed should then have the spiral
@@ -154,7 +325,7 @@ static bool spiral_collides(sxbp_spiral_t* spiral, size_t index) {
  * - That spiral.co_ord_cache.co_ords.items is not NULL
  * - That index is less than spiral.size
  */
-static sxbp_length_t suggest_resize(
+static uint64_t suggest_resize(
     sxbp_spiral_t spiral, size_t index, sxbp_length_t perfection_threshold
 ) {
     // preconditional assertions
@@ -176,14 +347,14 @@ static sxbp_length_t suggest_resize(
             (perfection_threshold > 0) &&
             (spiral.lines[index].length > perfection_threshold)
         ) {
-            return spiral.lines[index - 1].length + 1;
+            return (uint64_t)spiral.lines[index - 1].length + 1;
         }
         // store the 'previous' and 'rigid' lines.
         sxbp_line_t p = spiral.lines[index - 1];
         sxbp_line_t r = spiral.lines[spiral.collider];
         // if pr and r are not parallel, we can return early
         if((p.direction % 2) != (r.direction % 2)) {
-            return spiral.lines[index - 1].length + 1;
+            return (uint64_t)spiral.lines[index - 1].length + 1;
         }
         // create variables to store the start and end co-ords of these lines
         sxbp_co_ord_t pa, ra, rb;
@@ -201,24 +372,24 @@ static sxbp_length_t suggest_resize(
          * calculate the correct length to set the previous line and return it.
          */
         if((p.direction == SXBP_UP) && (r.direction == SXBP_UP)) {
-            return (ra.y - pa.y) + r.length + 1;
+            return (uint64_t)((int64_t)ra.y - pa.y) + r.length + 1;
         } else if((p.direction == SXBP_UP) && (r.direction == SXBP_DOWN)) {
-            return (rb.y - pa.y) + r.length + 1;
+            return (uint64_t)((int64_t)rb.y - pa.y) + r.length + 1;
         } else if((p.direction == SXBP_RIGHT) && (r.direction == SXBP_RIGHT)) {
-            return (ra.x - pa.x) + r.length + 1;
+            return (uint64_t)((int64_t)ra.x - pa.x) + r.length + 1;
         } else if((p.direction == SXBP_RIGHT) && (r.direction == SXBP_LEFT)) {
-            return (rb.x - pa.x) + r.length + 1;
+            return (uint64_t)((int64_t)rb.x - pa.x) + r.length + 1;
         } else if((p.direction == SXBP_DOWN) && (r.direction == SXBP_UP)) {
-            return (pa.y - rb.y) + r.length + 1;
+            return (uint64_t)((int64_t)pa.y - rb.y) + r.length + 1;
         } else if((p.direction == SXBP_DOWN) && (r.direction == SXBP_DOWN)) {
-            return (pa.y - ra.y) + r.length + 1;
+            return (uint64_t)((int64_t)pa.y - ra.y) + r.length + 1;
         } else if((p.direction == SXBP_LEFT) && (r.direction == SXBP_RIGHT)) {
-            return (pa.x - rb.x) + r.length + 1;
+            return (uint64_t)((int64_t)pa.x - rb.x) + r.length + 1;
         } else if((p.direction == SXBP_LEFT) && (r.direction == SXBP_LEFT)) {
-            return (pa.x - ra.x) + r.length + 1;
+            return (uint64_t)((int64_t)pa.x - ra.x) + r.length + 1;
         } else {
             // this is the catch-all case, where no way to optimise was found
-            return spiral.lines[index - 1].length + 1;
+            return (uint64_t)spiral.lines[index - 1].length + 1;
         }
     } else {
         /*
@@ -229,9 +400,18 @@ static sxbp_length_t suggest_resize(
     }
 }
 
-sxbp_status_t sxbp_resize_spiral(
-    sxbp_spiral_t* spiral, uint32_t index, sxbp_length_t length,
-    sxbp_length_t perfection_threshold
+/*
+ * private function, does the work of sxbp_resize_spiral(), keeping the given
+ * compact copy of the spiral's co-ord cache up to date as it goes and using it
+ * to check for collisions
+ *
+ * Asserts:
+ * - That spiral->lines is not NULL
+ * - That index is less than spiral->size
+ */
+static sxbp_status_t resize_spiral(
+    sxbp_spiral_t* spiral, sxbp_line_count_t index, sxbp_length_t length,
+    sxbp_length_t perfection_threshold, compact_cache_t* compact
 ) {
     // preconditional assertions
     assert(spiral->lines != NULL);
@@ -254,22 +434,37 @@ sxbp_status_t sxbp_resize_spiral(
         spiral->co_ord_cache.validity = (
             current_index < spiral->co_ord_cache.validity
         ) ? current_index : spiral->co_ord_cache.validity;
+        // only the co-ords before the first invalid line are still valid
+        if(compact->width != COMPACT_NONE) {
+            size_t valid_co_ords = sxbp_sum_lines(
+                *spiral, 0, spiral->co_ord_cache.validity
+            ) + 1;
+            compact->validity = (
+                valid_co_ords < compact->validity
+            ) ? valid_co_ords : compact->validity;
+        }
         // update the spiral's co-ord cache, and catch any errors
         result = sxbp_cache_spiral_points(spiral, current_index + 1);
         // return if errors
         if(result != SXBP_OPERATION_OK) {
             return result;
         }
-        spiral->collides = spiral_collides(spiral, current_index);
+        update_compact_cache(spiral, compact);
+        spiral->collides = spiral_collides(spiral, current_index, compact);
         if(spiral->collides) {
             /*
              * if we've caused a collision, we need to call the suggest_resize()
              * function to get the suggested length to resize the previous
              * segment to
              */
-            current_length = suggest_resize(
+            uint64_t suggestion = suggest_resize(
                 *spiral, current_index, perfection_threshold
             );
+            // a line can't be made any longer than its length can hold
+            if(suggestion > SXBP_LENGTH_MAX) {
+                return SXBP_SIZE_OVERFLOW;
+            }
+            current_length = (sxbp_length_t)suggestion;
             current_index--;
         } else if(current_index != index) {
             /*
@@ -294,10 +489,27 @@ sxbp_status_t sxbp_resize_spiral(
     }
 }
 
+sxbp_status_t sxbp_resize_spiral(
+    sxbp_spiral_t* spiral, sxbp_line_count_t index, sxbp_length_t length,
+    sxbp_length_t perfection_threshold
+) {
+    // preconditional assertions
+    assert(spiral->lines != NULL);
+    assert(index < spiral->size);
+    compact_cache_t compact = { COMPACT_NONE, NULL, 0, 0, };
+    sxbp_status_t result = resize_spiral(
+        spiral, index, length, perfection_threshold, &compact
+    );
+    free_compact_cache(&compact);
+    return result;
+}
+
 sxbp_status_t sxbp_plot_spiral(
-    sxbp_spiral_t* spiral, sxbp_length_t perfection_threshold, uint32_t max_line,
+    sxbp_spiral_t* spiral, sxbp_length_t perfection_threshold,
+    sxbp_line_count_t max_line,
     void(* progress_callback)(
-        sxbp_spiral_t* spiral, uint32_t latest_line, uint32_t target_line,
+        sxbp_spiral_t* spiral, sxbp_line_count_t latest_line,
+        sxbp_line_count_t target_line,
         void* progress_callback_user_data
     ),
     void* progress_callback_user_data
@@ -314,12 +526,20 @@ sxbp_status_t sxbp_plot_spiral(
     // set up result status
     sxbp_status_t result;
     // get index of highest line to plot
-    uint32_t max_index = (max_line > spiral->size) ? spiral->size : max_line;
+    sxbp_line_count_t max_index = (
+        max_line > spiral->size
+    ) ? spiral->size : max_line;
+    /*
+     * the compact copy of the co-ord cache is kept for all of the lines, so
+     * that it only has to be built up once
+     */
+    compact_cache_t compact = { COMPACT_NONE, NULL, 0, 0, };
     // calculate the length of each line within range solved_count -> max_index
-    for(size_t i = spiral->solved_count; i < max_index; i++) {
-        result = sxbp_resize_spiral(spiral, i, 1, perfection_threshold);
+    for(sxbp_line_count_t i = spiral->solved_count; i < max_index; i++) {
+        result = resize_spiral(spiral, i, 1, perfection_threshold, &compact);
         // catch and return error if any
         if(result != SXBP_OPERATION_OK) {
+            free_compact_cache(&compact);
             return result;
         }
         // update time spent solving
@@ -329,6 +549,7 @@ sxbp_status_t sxbp_plot_spiral(
             progress_callback(spiral, i, max_index, progress_callback_user_data);
         }
     }
+    free_compact_cache(&compact);
     // update time spent solving
     synchronise_spiral_timing(spiral);
     // all ok
@@ -45,6 +45,8 @@ extern "C"{
  * which aggressive optimisations are allowed (or 0 to disable these
  * optimisations completely).
  * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_SIZE_OVERFLOW if a line would have to be made longer than
+ * SXBP_LENGTH_MAX.
  * @return Any other failure code on failure.
  *
  * @note Asserts:
@@ -55,7 +57,7 @@ extern "C"{
  * removed from the public interface in a future version (v1.0 at the latest).
  */
 sxbp_status_t sxbp_resize_spiral(
-    sxbp_spiral_t* spiral, uint32_t index, sxbp_length_t length,
+    sxbp_spiral_t* spiral, sxbp_line_count_t index, sxbp_length_t length,
     sxbp_length_t perfection_threshold
 );
 
@@ -73,6 +75,12 @@ sxbp_status_t sxbp_resize_spiral(
  * another line. Once this function has finished, it may be possible to render
  * the spiral.
  *
+ * While the spiral's co-ords all fit in 16 bits (or 32 bits in wide mode),
+ * collisions are checked for in a compact copy of its co-ord cache made with
+ * co-ords of that size, which takes up less of the CPU's caches. The narrowest
+ * size is picked afresh as the spiral grows, so the lines found are the same
+ * whichever is used.
+ *
  * @param[in,out] spiral The spiral to solve. Function operates on the spiral
  * in-place (mutating operation).
  * @param perfection_threshold The maximum line length of colliding lines at
@@ -84,8 +92,8 @@ sxbp_status_t sxbp_resize_spiral(
  * signature of the callback should be like so:
  * @code
  * void callback_name(
- *     sxbp_spiral_t* spiral, uint32_t latest_line, uint32_t target_line,
- *     void* progress_callback_user_data
+ *     sxbp_spiral_t* spiral, sxbp_line_count_t latest_line,
+ *     sxbp_line_count_t target_line, void* progress_callback_user_data
  * )
  * @endcode
  * If a callback is not required, this argument should be NULL.
@@ -103,6 +111,9 @@ sxbp_status_t sxbp_resize_spiral(
  * progress_callback_user_data points to (if any). Hence, responsibility for
  * type-safety is placed on the user.
  * @return SXBP_OPERATION_OK on success.
+ * @return SXBP_SIZE_OVERFLOW if a line would have to be made longer than
+ * SXBP_LENGTH_MAX, or the spiral's co-ords would get too big for
+ * sxbp_tuple_item_t.
  * @return Any other failure code on failure.
  *
  * @warning This function may take a **VERY VERY LONG TIME** to run. This means
@@ -114,10 +125,11 @@ sxbp_status_t sxbp_resize_spiral(
  * @todo Improve the efficiency of this function so that it runs much faster.
  */
 sxbp_status_t sxbp_plot_spiral(
-    sxbp_spiral_t* spiral, sxbp_length_t perfection_threshold, uint32_t max_line,
+    sxbp_spiral_t* spiral, sxbp_length_t perfection_threshold,
+    sxbp_line_count_t max_line,
     void(* progress_callback)(
-        sxbp_spiral_t* spiral, uint32_t latest_line, uint32_t target_line,
-        void* progress_callback_user_data
+        sxbp_spiral_t* spiral, sxbp_line_count_t latest_line,
+        sxbp_line_count_t target_line, void* progress_callback_user_data
     ),
     void* progress_callback_user_data
 );
@@ -0,0 +1,419 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ *
+ * Copyright (C) 2016, 2017, Joshua Saxby joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "saxbospiral.h"
+#include "allocator.h"
+#include "parallel.h"
+#include "verify.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/*
+ * private type representing a line as an axis-aligned segment. Co-ords are
+ * held in 64 bits so that nothing can overflow while building them.
+ */
+typedef struct segment_t {
+    // the y co-ord of horizontal segments, or the x co-ord of vertical ones
+    int64_t position;
+    // the lowest and highest co-ord covered along the segment's axis
+    int64_t start;
+    int64_t end;
+    // index of the line this segment is of
+    sxbp_line_count_t line;
+} segment_t;
+
+/*
+ * private type representing one event of the sweep over x co-ords used to find
+ * horizontal and vertical segments that cross. Horizontal segments are
+ * inserted at their start and removed at their end, and vertical segments
+ * query how many horizontal segments are active between their ends.
+ */
+typedef enum event_kind_t {
+    // these are ordered so that events at the same x are handled in this order
+    EVENT_INSERT = 0,
+    EVENT_QUERY,
+    EVENT_REMOVE,
+} event_kind_t;
+
+typedef struct event_t {
+    int64_t x;
+    event_kind_t kind;
+    // the y co-ord range covered (low == high for horizontal segments)
+    int64_t low;
+    int64_t high;
+    sxbp_line_count_t line;
+} event_t;
+
+// private type for the outcome of one of the collision checks
+typedef struct check_result_t {
+    bool collides;
+    // the line a collision was found at, if any
+    sxbp_line_count_t line;
+} check_result_t;
+
+// private type for the state shared between the jobs of a verification
+typedef struct verification_t {
+    // the number of lines being verified
+    size_t line_count;
+    segment_t* horizontals;
+    size_t horizontal_count;
+    segment_t* verticals;
+    size_t vertical_count;
+    event_t* events;
+    size_t event_count;
+    // one result for each of the checks
+    check_result_t results[3];
+} verification_t;
+
+// private function, compares two int64_t values for sorting
+static int compare_int64_t(int64_t a, int64_t b) {
+    return (a > b) - (a < b);
+}
+
+// private function, qsort() comparison for sorting segments by position
+static int compare_segments(const void* a, const void* b) {
+    const segment_t* x = (const segment_t*)a;
+    const segment_t* y = (const segment_t*)b;
+    int result = compare_int64_t(x->position, y->position);
+    if(result == 0) {
+        result = compare_int64_t(x->start, y->start);
+    }
+    if(result == 0) {
+        result = compare_int64_t(x->line, y->line);
+    }
+    return result;
+}
+
+// private function, qsort() comparison for sorting events by x co-ord
+static int compare_events(const void* a, const void* b) {
+    const event_t* x = (const event_t*)a;
+    const event_t* y = (const event_t*)b;
+    int result = compare_int64_t(x->x, y->x);
+    if(result == 0) {
+        result = compare_int64_t(x->kind, y->kind);
+    }
+    if(result == 0) {
+        result = compare_int64_t(x->line, y->line);
+    }
+    return result;
+}
+
+// private function, qsort() comparison for sorting int64_t values
+static int compare_positions(const void* a, const void* b) {
+    return compare_int64_t(*(const int64_t*)a, *(const int64_t*)b);
+}
+
+// records a collision found at the given line, keeping the lowest one found
+static void record_collision(check_result_t* result, sxbp_line_count_t line) {
+    if(!result->collides || (line < result->line)) {
+        result->collides = true;
+        result->line = line;
+    }
+}
+
+/*
+ * private function, checks if any of the given parallel segments touch. The
+ * segments are sorted by position and then start, so any overlapping ones on
+ * the same row (or column) are found by keeping track of how far along that
+ * row the segments seen so far reach. Parallel lines are never adjacent, so any
+ * touching is a collision.
+ */
+static check_result_t find_parallel_collisions(
+    segment_t* segments, size_t count
+) {
+    check_result_t result = { false, 0, };
+    qsort(segments, count, sizeof(segment_t), compare_segments);
+    for(size_t i = 1, reach = 0; i < count; i++) {
+        if(segments[i].position != segments[i - 1].position) {
+            // new row, so nothing seen so far can touch this segment
+            reach = i;
+        } else if(segments[i].start <= segments[reach].end) {
+            sxbp_line_count_t a = segments[i].line;
+            sxbp_line_count_t b = segments[reach].line;
+            record_collision(&result, (a > b) ? a : b);
+        }
+        // keep track of whichever segment on this row reaches the furthest
+        if(segments[i].end > segments[reach].end) {
+            reach = i;
+        }
+    }
+    return result;
+}
+
+// private function, returns the index of the first position not below value
+static size_t lower_bound(int64_t* positions, size_t count, int64_t value) {
+    size_t low = 0;
+    size_t high = count;
+    while(low < high) {
+        size_t middle = low + (high - low) / 2;
+        if(positions[middle] < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// private function, adds delta to the count at index of a Fenwick tree
+static void fenwick_add(
+    size_t* tree, size_t size, size_t index, ptrdiff_t delta
+) {
+    for(size_t i = index + 1; i <= size; i += i & (~i + 1)) {
+        tree[i - 1] += (size_t)delta;
+    }
+}
+
+// private function, returns the sum of the counts below index of a Fenwick tree
+static size_t fenwick_sum(size_t* tree, size_t index) {
+    size_t sum = 0;
+    for(size_t i = index; i > 0; i -= i & (~i + 1)) {
+        sum += tree[i - 1];
+    }
+    return sum;
+}
+
+/*
+ * private function, checks if any horizontal and vertical segments cross other
+ * than adjacent lines meeting at their ends. The events are swept over in order
+ * of x co-ord, keeping a count of the active horizontal segments at each y
+ * co-ord in a Fenwick tree. Each vertical segment should only find the lines
+ * either side of it (which it meets at its ends) in its range.
+ */
+static sxbp_status_t find_crossing_collisions(
+    verification_t* verification, check_result_t* result
+) {
+    // get all of the unique y co-ords of horizontal segments
+    size_t count = verification->horizontal_count;
+    int64_t* positions = sxbp_calloc(sizeof(int64_t), count + 1);
+    size_t* tree = sxbp_calloc(sizeof(size_t), count + 1);
+    if((positions == NULL) || (tree == NULL)) {
+        sxbp_free(positions);
+        sxbp_free(tree);
+        return SXBP_MALLOC_REFUSED;
+    }
+    /*
+     * NOTE: these are taken from the events rather than the segments, as the
+     * segments may be being sorted by another check at the same time
+     */
+    event_t* events = verification->events;
+    for(size_t i = 0, j = 0; i < verification->event_count; i++) {
+        if(events[i].kind == EVENT_INSERT) {
+            positions[j++] = events[i].low;
+        }
+    }
+    qsort(positions, count, sizeof(int64_t), compare_positions);
+    size_t unique = 0;
+    for(size_t i = 0; i < count; i++) {
+        if((unique == 0) || (positions[i] != positions[unique - 1])) {
+            positions[unique++] = positions[i];
+        }
+    }
+    // sweep over all the events
+    qsort(
+        events, verification->event_count, sizeof(event_t), compare_events
+    );
+    for(size_t i = 0; i < verification->event_count; i++) {
+        event_t event = events[i];
+        size_t low = lower_bound(positions, unique, event.low);
+        if(event.kind == EVENT_INSERT) {
+            fenwick_add(tree, unique, low, 1);
+        } else if(event.kind == EVENT_REMOVE) {
+            fenwick_add(tree, unique, low, -1);
+        } else {
+            size_t high = lower_bound(positions, unique, event.high + 1);
+            size_t found = fenwick_sum(tree, high) - fenwick_sum(tree, low);
+            // the lines either side of this one, if verified, meet it
+            size_t expected = (
+                (event.line > 0) +
+                ((size_t)event.line + 1 < verification->line_count)
+            );
+            if(found > expected) {
+                record_collision(result, event.line);
+            }
+        }
+    }
+    sxbp_free(positions);
+    sxbp_free(tree);
+    return SXBP_OPERATION_OK;
+}
+
+// job which runs one of the collision checks of a verification
+static sxbp_status_t run_check(size_t check, void* user_data) {
+    verification_t* verification = (verification_t*)user_data;
+    check_result_t* result = &verification->results[check];
+    switch(check) {
+        case 0:
+            *result = find_parallel_collisions(
+                verification->horizontals, verification->horizontal_count
+            );
+            return SXBP_OPERATION_OK;
+        case 1:
+            *result = find_parallel_collisions(
+                verification->verticals, verification->vertical_count
+            );
+            return SXBP_OPERATION_OK;
+        default:
+            return find_crossing_collisions(verification, result);
+    }
+}
+
+/*
+ * private function, checks that the directions and lengths of the first count
+ * lines of the spiral are valid, storing any problem found in result
+ */
+static void check_lines(
+    sxbp_spiral_t spiral, size_t count, sxbp_verify_result_t* result
+) {
+    for(size_t i = 0; i < count; i++) {
+        sxbp_line_t line = spiral.lines[i];
+        // the first line points up, the rest turn one way or the other
+        sxbp_direction_t expected = SXBP_UP;
+        if(i > 0) {
+            expected = (spiral.lines[i - 1].direction + 1) % 4;
+        }
+        if(
+            (line.direction != expected) &&
+            ((i == 0) || (line.direction != (expected + 2) % 4))
+        ) {
+            result->status = SXBP_OPERATION_FAIL;
+            result->diagnostic = SXBP_VERIFY_BAD_DIRECTION;
+            result->line = (sxbp_line_count_t)i;
+            return;
+        } else if(line.length == 0) {
+            result->status = SXBP_OPERATION_FAIL;
+            result->diagnostic = SXBP_VERIFY_BAD_LENGTH;
+            result->line = (sxbp_line_count_t)i;
+            return;
+        }
+    }
+}
+
+/*
+ * private function, builds the segments and sweep events for the first count
+ * lines of the spiral (which must already have been checked), in memory which
+ * must be freed with free_verification()
+ */
+static sxbp_status_t build_verification(
+    sxbp_spiral_t spiral, size_t count, verification_t* verification
+) {
+    verification->line_count = count;
+    verification->horizontals = sxbp_calloc(sizeof(segment_t), count);
+    verification->verticals = sxbp_calloc(sizeof(segment_t), count);
+    // each horizontal line has two events, each vertical one has one
+    verification->events = sxbp_calloc(sizeof(event_t), count * 2);
+    if(
+        (verification->horizontals == NULL) ||
+        (verification->verticals == NULL) || (verification->events == NULL)
+    ) {
+        return SXBP_MALLOC_REFUSED;
+    }
+    int64_t x = 0;
+    int64_t y = 0;
+    for(size_t i = 0; i < count; i++) {
+        sxbp_line_t line = spiral.lines[i];
+        sxbp_vector_t direction = SXBP_VECTOR_DIRECTIONS[line.direction];
+        int64_t end_x = x + (direction.x * (int64_t)line.length);
+        int64_t end_y = y + (direction.y * (int64_t)line.length);
+        segment_t segment = { .line = (sxbp_line_count_t)i, };
+        if(direction.x != 0) {
+            segment.position = y;
+            segment.start = (x < end_x) ? x : end_x;
+            segment.end = (x < end_x) ? end_x : x;
+            verification->horizontals[verification->horizontal_count++] = (
+                segment
+            );
+            event_t insert = {
+                segment.start, EVENT_INSERT, y, y, segment.line,
+            };
+            event_t remove = {
+                segment.end, EVENT_REMOVE, y, y, segment.line,
+            };
+            verification->events[verification->event_count++] = insert;
+            verification->events[verification->event_count++] = remove;
+        } else {
+            segment.position = x;
+            segment.start = (y < end_y) ? y : end_y;
+            segment.end = (y < end_y) ? end_y : y;
+            verification->verticals[verification->vertical_count++] = segment;
+            event_t query = {
+                x, EVENT_QUERY, segment.start, segment.end, segment.line,
+            };
+            verification->events[verification->event_count++] = query;
+        }
+        x = end_x;
+        y = end_y;
+    }
+    return SXBP_OPERATION_OK;
+}
+
+// private function, frees the memory allocated by build_verification()
+static void free_verification(verification_t* verification) {
+    sxbp_free(verification->horizontals);
+    sxbp_free(verification->verticals);
+    sxbp_free(verification->events);
+}
+
+sxbp_verify_result_t sxbp_verify_spiral(
+    sxbp_spiral_t spiral, size_t thread_count
+) {
+    // preconditional assertions
+    assert(spiral.lines != NULL);
+    assert(spiral.solved_count <= spiral.size);
+    sxbp_verify_result_t result = { SXBP_OPERATION_OK, SXBP_VERIFY_OK, 0, };
+    size_t count = spiral.solved_count;
+    // check the directions and lengths first, the collision checks need these
+    check_lines(spiral, count, &result);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    verification_t verification = {
+        0, NULL, 0, NULL, 0, NULL, 0, { { false, 0, }, },
+    };
+    result.status = build_verification(spiral, count, &verification);
+    if(result.status == SXBP_OPERATION_OK) {
+        // run the three collision checks alongside each other
+        result.status = sxbp_run_parallel_jobs(
+            3, thread_count, run_check, (void*)&verification
+        );
+    }
+    free_verification(&verification);
+    if(result.status != SXBP_OPERATION_OK) {
+        return result;
+    }
+    // report the earliest collision found by any of the checks
+    for(size_t i = 0; i < 3; i++) {
+        check_result_t check = verification.results[i];
+        if(
+            check.collides && (
+                (result.diagnostic != SXBP_VERIFY_COLLIDES) ||
+                (check.line < result.line)
+            )
+        ) {
+            result.status = SXBP_OPERATION_FAIL;
+            result.diagnostic = SXBP_VERIFY_COLLIDES;
+            result.line = check.line;
+        }
+    }
+    return result;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,104 @@
+/*
+ * This source file forms part of libsxbp, a library which generates
+ * experimental 2D spiral-like shapes based on input binary data.
+ */
+
+/**
+ * @file
+ *
+ * @brief This compilation unit provides a function for checking that a spiral
+ * obtained from elsewhere (such as one loaded from a file) is really solved,
+ * without having to trust whatever produced it.
+ *
+ * @author Joshua Saxby <joshua.a.saxby+TNOPLuc8vM==@gmail.com
+ * @date 2016, 2017
+ *
+ * @copyright Copyright (C) Joshua Saxby 2016, 2017
+ *
+ * @copyright
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef SAXBOPHONE_SAXBOSPIRAL_VERIFY_H
+#define SAXBOPHONE_SAXBOSPIRAL_VERIFY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "saxbospiral.h"
+
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Provides further information on why a spiral failed verification
+ */
+typedef enum sxbp_verify_diagnostic_t {
+    /** @brief no problem */
+    SXBP_VERIFY_OK,
+    /**
+     * @brief a line's direction isn't a quarter turn from the line before it
+     * (or the first line doesn't point up)
+     */
+    SXBP_VERIFY_BAD_DIRECTION,
+    /** @brief a line which should have been solved has a length of 0 */
+    SXBP_VERIFY_BAD_LENGTH,
+    /** @brief a line touches or crosses a line which isn't next to it */
+    SXBP_VERIFY_COLLIDES,
+} sxbp_verify_diagnostic_t;
+
+/**
+ * @brief Stores both generic and verification-specific error information.
+ */
+typedef struct sxbp_verify_result_t {
+    /** @brief generic error information applicable to all functions */
+    sxbp_status_t status;
+    /** @brief additional specific error information */
+    sxbp_verify_diagnostic_t diagnostic;
+    /**
+     * @brief the index of the line at which the problem was found, if any.
+     * @details For collisions, this is the index of one of the lines involved.
+     */
+    sxbp_line_count_t line;
+} sxbp_verify_result_t;
+
+/**
+ * @brief Checks that all of the solved lines of a spiral are valid.
+ * @details Checks the first spiral.solved_count lines of the spiral, to make
+ * sure that each one turns a quarter turn from the line before it (with the
+ * first line pointing up), that each one has a length of at least 1 and that
+ * none of them touch or cross any others, except for adjacent lines meeting at
+ * their ends.
+ *
+ * Unlike the check used while solving, this runs in O(n log n) time in the
+ * number of lines, not the number of co-ords plotted, by sorting and sweeping
+ * over the lines as horizontal and vertical segments. The spiral's co-ord
+ * cache is not used.
+ *
+ * @param spiral The spiral to verify.
+ * @param thread_count The maximum number of threads to use. 0 or 1 means do
+ * all of the work on the calling thread. This is ignored if the library was
+ * built without thread support (see SXBP_THREAD_SUPPORT).
+ * @return SXBP_OPERATION_OK as the status if the spiral is valid.
+ * @return SXBP_OPERATION_FAIL as the status if the spiral is not valid, with
+ * the reason given by the diagnostic and the line given by line.
+ * @return SXBP_MALLOC_REFUSED as the status if memory couldn't be allocated
+ * for the check, in which case it is not known whether the spiral is valid.
+ *
+ * @note Asserts:
+ * - That spiral.lines is not NULL
+ * - That spiral.solved_count is not more than spiral.size
+ */
+sxbp_verify_result_t sxbp_verify_spiral(
+    sxbp_spiral_t spiral, size_t thread_count
+);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+// end of header file
+#endif
@@ -19,17 +19,108 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sxbp/saxbospiral.h"
+#include "sxbp/allocator.h"
+#include "sxbp/checksum.h"
 #include "sxbp/initialise.h"
+#include "sxbp/parallel.h"
 #include "sxbp/plot.h"
+#include "sxbp/render.h"
+#include "sxbp/render_backends/backend_pbm.h"
+#include "sxbp/render_backends/backend_png.h"
+#include "sxbp/render_backends/backend_svg.h"
 #include "sxbp/solve.h"
 #include "sxbp/serialise.h"
+#include "sxbp/verify.h"
 
 
 static const size_t EXPECTED_FILE_HEADER_SIZE = 26;
 
 
+// private type used as the context of the test allocator below
+typedef struct test_allocator_t {
+    size_t allocations;
+    size_t frees;
+    size_t largest;
+    // if not 0, the number of blocks to allocate before refusing any more
+    size_t limit;
+} test_allocator_t;
+
+/*
+ * test allocator functions, which count how many blocks are allocated / freed
+ * and keep track of the largest block asked for
+ */
+static void* test_allocate(size_t size, void* context) {
+    test_allocator_t* counts = (test_allocator_t*)context;
+    if((counts->limit != 0) && (counts->allocations >= counts->limit)) {
+        return NULL;
+    }
+    counts->allocations++;
+    counts->largest = (size > counts->largest) ? size : counts->largest;
+    return malloc(size);
+}
+
+static void* test_reallocate(void* pointer, size_t size, void* context) {
+    test_allocator_t* counts = (test_allocator_t*)context;
+    if((counts->limit != 0) && (counts->allocations >= counts->limit)) {
+        return NULL;
+    }
+    counts->allocations++;
+    counts->frees++;
+    counts->largest = (size > counts->largest) ? size : counts->largest;
+    return realloc(pointer, size);
+}
+
+static void test_deallocate(void* pointer, void* context) {
+    ((test_allocator_t*)context)->frees++;
+    free(pointer);
+}
+
+static bool test_sxbp_set_thread_allocator(void) {
+    // success / failure variable
+    bool result = true;
+    test_allocator_t counts = { 0, 0, 0, 0, };
+    sxbp_allocator_t allocator = {
+        test_allocate, test_reallocate, test_deallocate, (void*)&counts,
+    };
+    if(sxbp_set_thread_allocator(&allocator) != NULL) {
+        result = false;
+    }
+    // build, solve and render a spiral, which should all use the allocator
+    uint8_t data[4] = { 0x6d, 0x33, 0xc2, 0x0f, };
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 4, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_bitmap_t image = { .width = 0, .height = 0, .pixels = NULL, };
+    sxbp_buffer_t buffer = { .bytes = NULL, .size = 0, };
+    if(
+        (sxbp_init_spiral(data_buffer, &spiral) != SXBP_OPERATION_OK) ||
+        (
+            sxbp_plot_spiral(
+                &spiral, 1, spiral.size, NULL, NULL
+            ) != SXBP_OPERATION_OK
+        ) ||
+        (sxbp_render_spiral_raw(spiral, &image) != SXBP_OPERATION_OK) ||
+        (sxbp_render_backend_pbm(image, &buffer) != SXBP_OPERATION_OK)
+    ) {
+        result = false;
+    }
+    sxbp_free(buffer.bytes);
+    sxbp_free(image.pixels);
+    sxbp_free(spiral.lines);
+    sxbp_free(spiral.co_ord_cache.co_ords.items);
+    // every block allocated should have been freed, by the same allocator
+    if(
+        (counts.allocations == 0) || (counts.allocations != counts.frees) ||
+        (sxbp_set_thread_allocator(NULL) != &allocator)
+    ) {
+        result = false;
+    }
+
+    return result;
+}
+
 static bool test_sxbp_change_direction(void) {
     if(sxbp_change_direction(SXBP_UP, SXBP_CLOCKWISE) != SXBP_RIGHT) {
         return false;
@@ -94,6 +185,175 @@ static bool test_sxbp_init_spiral(void) {
     return result;
 }
 
+static bool test_sxbp_init_spiral_in_parallel(void) {
+    // success / failure variable
+    bool result = true;
+    // enough data to be split between threads, with a chunk left over
+    sxbp_buffer_t buffer = { .size = 2 * 1024 * 1024 + 3, };
+    buffer.bytes = malloc(buffer.size);
+    if(buffer.bytes == NULL) {
+        return false;
+    }
+    for(size_t i = 0; i < buffer.size; i++) {
+        buffer.bytes[i] = (uint8_t)((i * 181) ^ (i >> 9));
+    }
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    if(sxbp_init_spiral_in_parallel(buffer, 4, &output) != SXBP_OPERATION_OK) {
+        result = false;
+    } else if(
+        (output.size != buffer.size * 8 + 1) ||
+        (output.lines[0].direction != SXBP_UP)
+    ) {
+        result = false;
+    } else {
+        // each line should be a turn from the last, as the bit says
+        sxbp_direction_t current = SXBP_UP;
+        for(size_t i = 1; i < output.size; i++) {
+            uint8_t bit = (buffer.bytes[(i - 1) / 8] >> (7 - (i - 1) % 8)) & 1;
+            current = sxbp_change_direction(
+                current, (bit == 0) ? SXBP_CLOCKWISE : SXBP_ANTI_CLOCKWISE
+            );
+            if(
+                (output.lines[i].direction != current) ||
+                (output.lines[i].length != 0)
+            ) {
+                result = false;
+                break;
+            }
+        }
+    }
+    free(output.lines);
+    /*
+     * allow the lines and the chunks' turns to be allocated, but not what the
+     * threads need, which should fail rather than leave the lines unwritten
+     */
+    test_allocator_t counts = { 0, 0, 0, 2, };
+    sxbp_allocator_t allocator = {
+        test_allocate, test_reallocate, test_deallocate, (void*)&counts,
+    };
+    sxbp_set_thread_allocator(&allocator);
+    output = sxbp_blank_spiral();
+    sxbp_status_t status = sxbp_init_spiral_in_parallel(buffer, 4, &output);
+    if(
+        (status != (
+            SXBP_THREAD_SUPPORT ? SXBP_MALLOC_REFUSED : SXBP_OPERATION_OK
+        )) || (SXBP_THREAD_SUPPORT && (output.lines != NULL))
+    ) {
+        result = false;
+    }
+    sxbp_free(output.lines);
+    sxbp_set_thread_allocator(NULL);
+    if(counts.allocations != counts.frees) {
+        result = false;
+    }
+
+    // free memory
+    free(buffer.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_spiral_append(void) {
+    // success / failure variable
+    bool result = true;
+    uint8_t data[6] = { 0x6d, 0xc7, 0x31, 0x0f, 0x5a, 0x93, };
+    sxbp_buffer_t first = { .bytes = data, .size = 3, };
+    sxbp_buffer_t rest = { .bytes = data + 3, .size = 3, };
+    sxbp_buffer_t whole = { .bytes = data, .size = 6, };
+    // solve a spiral built from the start of the data, then add the rest
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    sxbp_init_spiral(first, &output);
+    sxbp_plot_spiral(&output, 1, output.size, NULL, NULL);
+    uint32_t solved = output.solved_count;
+    if(
+        (sxbp_spiral_append(&output, rest) != SXBP_OPERATION_OK) ||
+        (output.solved_count != solved)
+    ) {
+        result = false;
+    }
+    sxbp_plot_spiral(&output, 1, output.size, NULL, NULL);
+    // it should be the same as the spiral solved from all of the data at once
+    sxbp_spiral_t expected = sxbp_blank_spiral();
+    sxbp_init_spiral(whole, &expected);
+    sxbp_plot_spiral(&expected, 1, expected.size, NULL, NULL);
+    if(
+        (output.size != expected.size) ||
+        (output.solved_count != expected.solved_count)
+    ) {
+        result = false;
+    } else {
+        for(size_t i = 0; i < expected.size; i++) {
+            if(
+                (output.lines[i].direction != expected.lines[i].direction) ||
+                (output.lines[i].length != expected.lines[i].length)
+            ) {
+                result = false;
+            }
+        }
+    }
+
+    // free memory
+    free(output.lines);
+    free(output.co_ord_cache.co_ords.items);
+    free(expected.lines);
+    free(expected.co_ord_cache.co_ords.items);
+
+    return result;
+}
+
+static bool test_sxbp_spiral_edit(void) {
+    // success / failure variable
+    bool result = true;
+    uint8_t data[6] = { 0x6d, 0xc7, 0x31, 0x0f, 0x5a, 0x93, };
+    sxbp_buffer_t buffer = { .bytes = data, .size = 6, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(buffer, &spiral);
+    sxbp_plot_spiral(&spiral, 1, spiral.size, NULL, NULL);
+    // writing the same bytes back again shouldn't change anything
+    sxbp_buffer_t same = { .bytes = data + 4, .size = 2, };
+    if(
+        (sxbp_spiral_edit(&spiral, 4, same) != SXBP_OPERATION_OK) ||
+        (spiral.solved_count != spiral.size)
+    ) {
+        result = false;
+    }
+    // neither should writing no bytes at all
+    sxbp_buffer_t empty = { .bytes = NULL, .size = 0, };
+    if(
+        (sxbp_spiral_edit(&spiral, 6, empty) != SXBP_OPERATION_OK) ||
+        (spiral.solved_count != spiral.size)
+    ) {
+        result = false;
+    }
+    // change the parity of a byte, which turns all the lines after it around
+    uint8_t edit[1] = { 0x8f, };
+    data[3] = edit[0];
+    sxbp_buffer_t edit_buffer = { .bytes = edit, .size = 1, };
+    if(
+        (sxbp_spiral_edit(&spiral, 3, edit_buffer) != SXBP_OPERATION_OK) ||
+        (spiral.solved_count != 3 * 8 + 1) || !spiral.collides
+    ) {
+        result = false;
+    }
+    // when solved again, it should be a valid spiral of the new data
+    sxbp_plot_spiral(&spiral, 1, spiral.size, NULL, NULL);
+    sxbp_buffer_t decoded = { .bytes = NULL, .size = 0, };
+    if(
+        (sxbp_verify_spiral(spiral, 1).status != SXBP_OPERATION_OK) ||
+        (sxbp_decode_spiral(spiral, &decoded) != SXBP_OPERATION_OK) ||
+        (decoded.size != 6) || (memcmp(decoded.bytes, data, 6) != 0)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(decoded.bytes);
+    free(spiral.lines);
+    free(spiral.co_ord_cache.co_ords.items);
+
+    return result;
+}
+
 static bool test_sxbp_spiral_points(void) {
     // success variable
     bool success = true;
@@ -202,6 +462,75 @@ static bool test_sxbp_cache_spiral_points_blank(void) {
     return success;
 }
 
+static bool test_sxbp_get_spiral_bounds(void) {
+    // success variable
+    bool success = true;
+    // prepare input spiral struct
+    sxbp_spiral_t input = {
+        .size = 16,
+        .lines = calloc(sizeof(sxbp_line_t), 16),
+    };
+    sxbp_direction_t directions[16] = {
+        SXBP_UP, SXBP_LEFT, SXBP_DOWN, SXBP_LEFT, SXBP_DOWN, SXBP_RIGHT, SXBP_DOWN, SXBP_RIGHT,
+        SXBP_UP, SXBP_LEFT, SXBP_UP, SXBP_RIGHT, SXBP_DOWN, SXBP_RIGHT, SXBP_UP, SXBP_LEFT,
+    };
+    sxbp_length_t lengths[16] = {
+        1, 1, 1, 1, 1, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 1,
+    };
+    for(size_t i = 0; i < 16; i++) {
+        input.lines[i].direction = directions[i];
+        input.lines[i].length = lengths[i];
+    }
+    sxbp_co_ord_t bounds[2];
+
+    // the bounds are kept as the cache grows
+    sxbp_cache_spiral_points(&input, 8);
+    if(
+        (input.co_ord_cache.bounds_validity != 8) ||
+        (input.co_ord_cache.bounds[0].x != -2) ||
+        (input.co_ord_cache.bounds[0].y != -2) ||
+        (input.co_ord_cache.bounds[1].x != 1) ||
+        (input.co_ord_cache.bounds[1].y != 1)
+    ) {
+        success = false;
+    }
+    sxbp_cache_spiral_points(&input, 16);
+    sxbp_get_spiral_bounds(&input, bounds);
+    if(
+        (input.co_ord_cache.bounds_validity != 16) ||
+        (bounds[0].x != -2) || (bounds[0].y != -2) ||
+        (bounds[1].x != 3) || (bounds[1].y != 4)
+    ) {
+        success = false;
+    }
+    // shortening a line and caching again should shrink them
+    input.lines[8].length = 1;
+    input.co_ord_cache.validity = 8;
+    sxbp_cache_spiral_points(&input, 16);
+    sxbp_get_spiral_bounds(&input, bounds);
+    if(
+        (bounds[0].x != -2) || (bounds[0].y != -2) ||
+        (bounds[1].x != 3) || (bounds[1].y != 1)
+    ) {
+        success = false;
+    }
+    // they should be the same without the cache
+    free(input.co_ord_cache.co_ords.items);
+    input.co_ord_cache = sxbp_blank_spiral().co_ord_cache;
+    sxbp_co_ord_t uncached[2];
+    sxbp_get_spiral_bounds(&input, uncached);
+    if(
+        (uncached[0].x != bounds[0].x) || (uncached[0].y != bounds[0].y) ||
+        (uncached[1].x != bounds[1].x) || (uncached[1].y != bounds[1].y)
+    ) {
+        success = false;
+    }
+
+    // clean up
+    free(input.lines);
+    return success;
+}
+
 static bool test_sxbp_plot_spiral(void) {
     // success / failure variable
     bool result = true;
@@ -290,6 +619,43 @@ static bool test_sxbp_plot_spiral_partial(void) {
     return result;
 }
 
+static bool test_sxbp_plot_spiral_large_co_ords(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral which starts with a line almost too long for 16 bits
+    uint8_t data[4] = { 0x93, 0x5e, 0x21, 0xb8, };
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 4, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &spiral);
+    spiral.lines[0].length = INT16_MAX - 2;
+    spiral.solved_count = 1;
+
+    // solve the rest of it, which takes its co-ords out past 16 bits
+    sxbp_co_ord_t bounds[2];
+    if(
+        sxbp_plot_spiral(&spiral, 1, spiral.size, NULL, NULL) !=
+        SXBP_OPERATION_OK
+    ) {
+        result = false;
+    } else {
+        sxbp_get_spiral_bounds(&spiral, bounds);
+        // none of the lines should have been made to collide in doing so
+        if(
+            (spiral.solved_count != spiral.size) ||
+            (bounds[1].y <= INT16_MAX) ||
+            (sxbp_verify_spiral(spiral, 1).status != SXBP_OPERATION_OK)
+        ) {
+            result = false;
+        }
+    }
+
+    // free memory
+    free(spiral.lines);
+    free(spiral.co_ord_cache.co_ords.items);
+
+    return result;
+}
+
 /*
  * disable GCC warning about the unused parameters as this function by necessity
  * requires these arguments in its signature, but it needn't use all of them.
@@ -298,8 +664,8 @@ static bool test_sxbp_plot_spiral_partial(void) {
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 // test callback for next test case
 static void test_progress_callback(
-    sxbp_spiral_t* spiral, uint32_t latest_line, uint32_t target_line,
-    void* progress_callback_user_data
+    sxbp_spiral_t* spiral, sxbp_line_count_t latest_line,
+    sxbp_line_count_t target_line, void* progress_callback_user_data
 ) {
     // cast user data from void pointer to uint16_t pointer, deref and multiply
     *(uint16_t*)progress_callback_user_data *= 13;
@@ -684,42 +1050,1652 @@ static bool test_sxbp_dump_spiral(void) {
     return result;
 }
 
-// this function takes a bool containing the test suite status,
-// a function pointer to a test case function, and a string containing the
-// test case's name. it will run the test case function and return the success
-// or failure status, which should be stored in the test suite status bool.
-static bool run_test_case(
-    bool test_suite_state, bool(* test_case_func)(), char* test_case_name
+static bool test_sxbp_dump_and_load_spiral_with_co_ord_cache(void) {
+    // success / failure variable
+    bool result = true;
+    // build input struct and solve it so that it has a co-ord cache
+    sxbp_spiral_t input = { .size = 16, };
+    input.lines = calloc(sizeof(sxbp_line_t), 16);
+    sxbp_direction_t directions[16] = {
+        SXBP_UP, SXBP_LEFT, SXBP_DOWN, SXBP_LEFT, SXBP_DOWN, SXBP_RIGHT,
+        SXBP_DOWN, SXBP_RIGHT, SXBP_UP, SXBP_LEFT, SXBP_UP, SXBP_RIGHT,
+        SXBP_DOWN, SXBP_RIGHT, SXBP_UP, SXBP_LEFT,
+    };
+    for(uint8_t i = 0; i < 16; i++) {
+        input.lines[i].direction = directions[i];
+    }
+    sxbp_plot_spiral(&input, 1, 16, NULL, NULL);
+
+    // dump with the co-ord cache section included
+    sxbp_buffer_t buffer = { .size = 0, .bytes = NULL, };
+    sxbp_dump_options_t options = { .include_co_ord_cache = true, };
+    sxbp_dump_spiral_with_options(input, options, &buffer);
+    // load it back in again
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    sxbp_serialise_result_t load_result = sxbp_load_spiral(buffer, &output);
+
+    if(load_result.status != SXBP_OPERATION_OK) {
+        result = false;
+    } else if(
+        (output.co_ord_cache.validity != input.co_ord_cache.validity) ||
+        (output.co_ord_cache.co_ords.size != 23)
+    ) {
+        result = false;
+    } else {
+        for(size_t i = 0; i < 23; i++) {
+            if(
+                (output.co_ord_cache.co_ords.items[i].x !=
+                 input.co_ord_cache.co_ords.items[i].x) ||
+                (output.co_ord_cache.co_ords.items[i].y !=
+                 input.co_ord_cache.co_ords.items[i].y)
+            ) {
+                result = false;
+            }
+        }
+    }
+    free(output.lines);
+    free(output.co_ord_cache.co_ords.items);
+
+    // corrupt one of the stored co-ords, the checksum should catch it
+    buffer.bytes[buffer.size - 8] ^= 0x01;
+    output = sxbp_blank_spiral();
+    load_result = sxbp_load_spiral(buffer, &output);
+    if(
+        (load_result.status != SXBP_OPERATION_FAIL) ||
+        (load_result.diagnostic != SXBP_DESERIALISE_BAD_CHECKSUM) ||
+        (output.lines != NULL)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(input.lines);
+    free(input.co_ord_cache.co_ords.items);
+    free(buffer.bytes);
+
+    return result;
+}
+
+// private type used as the user data for the test stream callbacks below
+typedef struct test_stream_t {
+    sxbp_buffer_t buffer;
+    size_t index;
+} test_stream_t;
+
+// test write callback which appends data to a growing buffer
+static size_t test_write_callback(
+    const uint8_t* data, size_t size, void* user_data
 ) {
-    printf("%s: ", test_case_name);
-    fflush(stdout);
-    bool test_result = (*test_case_func)();
-    printf("%s\n", (test_result ? "PASS" : "FAIL"));
-    return test_suite_state && test_result;
+    test_stream_t* stream = (test_stream_t*)user_data;
+    uint8_t* bytes = realloc(stream->buffer.bytes, stream->buffer.size + size);
+    if(bytes == NULL) {
+        return 0;
+    }
+    stream->buffer.bytes = bytes;
+    memcpy(stream->buffer.bytes + stream->buffer.size, data, size);
+    stream->buffer.size += size;
+    return size;
 }
 
-int main(void) {
-    // set up test suite status flag
+// test read callback which hands out at most 3 bytes at a time
+static size_t test_read_callback(uint8_t* data, size_t size, void* user_data) {
+    test_stream_t* stream = (test_stream_t*)user_data;
+    size_t remaining = stream->buffer.size - stream->index;
+    size_t count = size < 3 ? size : 3;
+    count = count < remaining ? count : remaining;
+    memcpy(data, stream->buffer.bytes + stream->index, count);
+    stream->index += count;
+    return count;
+}
+
+// test read callback which hands out a few bytes before failing
+static size_t test_failing_read_callback(
+    uint8_t* data, size_t size, void* user_data
+) {
+    test_stream_t* stream = (test_stream_t*)user_data;
+    if(stream->index > 0) {
+        return SXBP_READ_ERROR;
+    }
+    return test_read_callback(data, size, user_data);
+}
+
+static bool test_sxbp_init_spiral_from_stream(void) {
+    // success / failure variable
     bool result = true;
-    // call run_test_case() for each test case
-    result = run_test_case(
-        result, test_sxbp_change_direction, "test_sxbp_change_direction"
-    );
-    result = run_test_case(
-        result, test_sxbp_init_spiral, "test_sxbp_init_spiral"
-    );
-    result = run_test_case(
-        result, test_sxbp_spiral_points, "test_sxbp_spiral_points"
-    );
-    result = run_test_case(
-        result, test_sxbp_cache_spiral_points_blank,
-        "test_sxbp_cache_spiral_points_blank"
-    );
-    result = run_test_case(
-        result, test_sxbp_plot_spiral, "test_sxbp_plot_spiral"
-    );
-    result = run_test_case(
-        result, test_sxbp_plot_spiral_partial, "test_sxbp_plot_spiral_partial"
+    // build data which will outgrow the size hint given for it
+    uint8_t data[10000];
+    for(size_t i = 0; i < 10000; i++) {
+        data[i] = (uint8_t)((i * 13) ^ (i >> 3));
+    }
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 10000, };
+    sxbp_spiral_t expected = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &expected);
+    // build the same spiral a few bytes at a time from a stream
+    test_stream_t stream = { data_buffer, 0, };
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    if(
+        sxbp_init_spiral_from_stream(
+            test_read_callback, (void*)&stream, 100, &output
+        ) != SXBP_OPERATION_OK
+    ) {
+        result = false;
+    } else if(
+        (output.size != expected.size) ||
+        (
+            memcmp(
+                output.lines, expected.lines,
+                sizeof(sxbp_line_t) * expected.size
+            ) != 0
+        )
+    ) {
+        result = false;
+    }
+    // and from a file, which is seekable so its length is known up front
+    free(output.lines);
+    output = sxbp_blank_spiral();
+    FILE* file = tmpfile();
+    if(
+        (file == NULL) || (fwrite(data, 1, 10000, file) != 10000) ||
+        (fseek(file, 0, SEEK_SET) != 0) ||
+        (sxbp_init_spiral_from_file(file, &output) != SXBP_OPERATION_OK)
+    ) {
+        result = false;
+    } else if(
+        (output.size != expected.size) ||
+        (
+            memcmp(
+                output.lines, expected.lines,
+                sizeof(sxbp_line_t) * expected.size
+            ) != 0
+        )
+    ) {
+        result = false;
+    }
+    if(file != NULL) {
+        fclose(file);
+    }
+    // a stream which fails partway through shouldn't give a spiral
+    free(output.lines);
+    output = sxbp_blank_spiral();
+    stream.index = 0;
+    if(
+        (sxbp_init_spiral_from_stream(
+            test_failing_read_callback, (void*)&stream, 0, &output
+        ) != SXBP_OPERATION_FAIL) || (output.lines != NULL)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(output.lines);
+    free(expected.lines);
+
+    return result;
+}
+
+static bool test_sxbp_dump_and_load_spiral_stream(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral with more lines than fit in one chunk, and cache it
+    uint8_t data[300];
+    for(size_t i = 0; i < 300; i++) {
+        data[i] = (uint8_t)(i * 7);
+    }
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 300, };
+    sxbp_spiral_t input = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &input);
+    for(size_t i = 0; i < input.size; i++) {
+        input.lines[i].length = (i % 5) + 1;
+    }
+    input.solved_count = 1234;
+    sxbp_cache_spiral_points(&input, input.size);
+
+    // dump it with the co-ord cache to a stream, then load it back in again
+    test_stream_t stream = { { NULL, 0, }, 0, };
+    sxbp_dump_options_t options = { .include_co_ord_cache = true, };
+    sxbp_serialise_result_t serialise_result = sxbp_dump_spiral_to_stream(
+        input, options, test_write_callback, (void*)&stream
+    );
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    if(serialise_result.status == SXBP_OPERATION_OK) {
+        serialise_result = sxbp_load_spiral_from_stream(
+            test_read_callback, (void*)&stream, &output
+        );
+    }
+
+    // the streamed data should be identical to that dumped to a buffer
+    sxbp_buffer_t expected = { .size = 0, .bytes = NULL, };
+    sxbp_dump_spiral_with_options(input, options, &expected);
+    if(
+        (stream.buffer.size != expected.size) ||
+        (memcmp(stream.buffer.bytes, expected.bytes, expected.size) != 0)
+    ) {
+        result = false;
+    }
+    // and the loaded spiral should be identical to the original
+    if(serialise_result.status != SXBP_OPERATION_OK) {
+        result = false;
+    } else if(
+        (output.size != input.size) ||
+        (output.solved_count != input.solved_count) ||
+        (output.co_ord_cache.validity != input.co_ord_cache.validity) ||
+        (output.co_ord_cache.co_ords.size != input.co_ord_cache.co_ords.size)
+    ) {
+        result = false;
+    } else {
+        for(size_t i = 0; i < input.size; i++) {
+            if(
+                (output.lines[i].direction != input.lines[i].direction) ||
+                (output.lines[i].length != input.lines[i].length)
+            ) {
+                result = false;
+            }
+        }
+        for(size_t i = 0; i < input.co_ord_cache.co_ords.size; i++) {
+            if(
+                (output.co_ord_cache.co_ords.items[i].x !=
+                 input.co_ord_cache.co_ords.items[i].x) ||
+                (output.co_ord_cache.co_ords.items[i].y !=
+                 input.co_ord_cache.co_ords.items[i].y)
+            ) {
+                result = false;
+            }
+        }
+    }
+
+    // free memory
+    free(input.lines);
+    free(input.co_ord_cache.co_ords.items);
+    free(output.lines);
+    free(output.co_ord_cache.co_ords.items);
+    free(stream.buffer.bytes);
+    free(expected.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_load_spiral_from_stream_rejects_bad_size(void) {
+    // success / failure variable
+    bool result = true;
+    // dump a small spiral to a stream
+    uint8_t data[4] = { 0x6d, 0x33, 0xc2, 0x0f, };
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 4, };
+    sxbp_spiral_t input = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &input);
+    test_stream_t stream = { { NULL, 0, }, 0, };
+    sxbp_dump_options_t options = { .include_co_ord_cache = false, };
+    sxbp_dump_spiral_to_stream(
+        input, options, test_write_callback, (void*)&stream
+    );
+    // claim it has far more lines than it does
+    uint8_t size[4];
+    memcpy(size, stream.buffer.bytes + 10, 4);
+    memset(stream.buffer.bytes + 10, 0xff, 4);
+    /*
+     * the stream ends long before all those lines, which should be noticed
+     * without ever allocating memory for them all
+     */
+    test_allocator_t counts = { 0, 0, 0, 0, };
+    sxbp_allocator_t allocator = {
+        test_allocate, test_reallocate, test_deallocate, (void*)&counts,
+    };
+    sxbp_set_thread_allocator(&allocator);
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    sxbp_serialise_result_t serialise_result = sxbp_load_spiral_from_stream(
+        test_read_callback, (void*)&stream, &output
+    );
+    sxbp_set_thread_allocator(NULL);
+    if(
+        (serialise_result.status != SXBP_OPERATION_FAIL) ||
+        (serialise_result.diagnostic != SXBP_DESERIALISE_BAD_DATA_SIZE) ||
+        (output.lines != NULL) || (counts.largest > 65536) ||
+        (counts.allocations != counts.frees)
+    ) {
+        result = false;
+    }
+
+    // put the size back, but leave a byte after the lines
+    memcpy(stream.buffer.bytes + 10, size, 4);
+    uint8_t* bytes = realloc(stream.buffer.bytes, stream.buffer.size + 1);
+    if(bytes == NULL) {
+        result = false;
+    } else {
+        stream.buffer.bytes = bytes;
+        stream.buffer.bytes[stream.buffer.size++] = 0x00;
+        stream.index = 0;
+        // which plain files can't have, whether loaded from stream or buffer
+        serialise_result = sxbp_load_spiral_from_stream(
+            test_read_callback, (void*)&stream, &output
+        );
+        if(
+            (serialise_result.status != SXBP_OPERATION_FAIL) ||
+            (serialise_result.diagnostic != SXBP_DESERIALISE_BAD_DATA_SIZE) ||
+            (output.lines != NULL)
+        ) {
+            result = false;
+        }
+        serialise_result = sxbp_load_spiral(stream.buffer, &output);
+        if(
+            (serialise_result.status != SXBP_OPERATION_FAIL) ||
+            (serialise_result.diagnostic != SXBP_DESERIALISE_BAD_DATA_SIZE)
+        ) {
+            result = false;
+        }
+    }
+
+    // free memory
+    free(input.lines);
+    free(output.lines);
+    free(stream.buffer.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_dump_spiral_into(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral with lines of a few different lengths, and cache it
+    uint8_t data[100];
+    for(size_t i = 0; i < 100; i++) {
+        data[i] = (uint8_t)(i * 11);
+    }
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 100, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &spiral);
+    for(size_t i = 0; i < spiral.size; i++) {
+        spiral.lines[i].length = (i % 3) + 1;
+    }
+    sxbp_cache_spiral_points(&spiral, spiral.size);
+    sxbp_dump_options_t options = {
+        .include_co_ord_cache = true, .chunk_size = 64,
+    };
+    sxbp_buffer_t expected = { .size = 0, .bytes = NULL, };
+    sxbp_dump_spiral_with_options(spiral, options, &expected);
+    // the size query should be exact
+    size_t size = sxbp_get_dump_size(spiral, options);
+    // with some room to spare, filled with junk which should be overwritten
+    uint8_t* bytes = malloc(size + 16);
+    memset(bytes, 0xa5, size + 16);
+    sxbp_buffer_t buffer = { .bytes = bytes, .size = size - 1, };
+    // a buffer one byte too small should be refused
+    if(
+        (size != expected.size) ||
+        (sxbp_dump_spiral_into(spiral, options, &buffer).status !=
+         SXBP_OPERATION_FAIL) ||
+        (buffer.size != size - 1) || (bytes[0] != 0xa5)
+    ) {
+        result = false;
+    }
+    // a big enough one should get the same data as a newly allocated one
+    buffer.size = size + 16;
+    if(
+        (sxbp_dump_spiral_into(spiral, options, &buffer).status !=
+         SXBP_OPERATION_OK) ||
+        (buffer.bytes != bytes) || (buffer.size != expected.size) ||
+        (memcmp(buffer.bytes, expected.bytes, expected.size) != 0) ||
+        (bytes[size] != 0xa5)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(spiral.lines);
+    free(spiral.co_ord_cache.co_ords.items);
+    free(expected.bytes);
+    free(bytes);
+
+    return result;
+}
+
+static bool test_sxbp_load_spiral_wide_file(void) {
+    // success / failure variable
+    bool result = true;
+    // build a small spiral, with only part of it solved
+    uint8_t data[3] = { 0x4c, 0x91, 0xe7, };
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 3, };
+    sxbp_spiral_t input = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &input);
+    for(size_t i = 0; i < input.size; i++) {
+        input.lines[i].length = (i % 4) + 1;
+    }
+    input.solved_count = 7;
+    // dump it in the extended format, with nothing in the optional sections
+    sxbp_dump_options_t options = { .include_co_ord_cache = true, };
+    sxbp_buffer_t extended = { .size = 0, .bytes = NULL, };
+    sxbp_dump_spiral_with_options(input, options, &extended);
+    // and make a wide file from it, with the line counts moved to 64 bits
+    sxbp_buffer_t wide = {
+        .size = extended.size + 16, .bytes = calloc(1, extended.size + 16),
+    };
+    memcpy(wide.bytes, extended.bytes, 30);
+    memcpy(wide.bytes + 46, extended.bytes + 30, extended.size - 30);
+    memset(wide.bytes + 10, 0xff, 8);
+    wide.bytes[29] = 0x01;
+    wide.bytes[37] = (uint8_t)input.size;
+    wide.bytes[45] = (uint8_t)input.solved_count;
+    if(wide.size != SXBP_WIDE_FILE_HEADER_SIZE + input.size * 4) {
+        result = false;
+    }
+    // it should load, both from a buffer and from a stream
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    sxbp_serialise_result_t serialise_result = sxbp_load_spiral(wide, &output);
+    test_stream_t stream = { wide, 0, };
+    sxbp_spiral_t streamed = sxbp_blank_spiral();
+    sxbp_serialise_result_t stream_result = sxbp_load_spiral_from_stream(
+        test_read_callback, (void*)&stream, &streamed
+    );
+    if(
+        (serialise_result.status != SXBP_OPERATION_OK) ||
+        (stream_result.status != SXBP_OPERATION_OK)
+    ) {
+        result = false;
+    } else if(
+        (output.size != input.size) || (streamed.size != input.size) ||
+        (output.solved_count != 7) || (streamed.solved_count != 7) ||
+        (memcmp(output.lines, input.lines, input.size * sizeof(sxbp_line_t))
+         != 0) ||
+        (memcmp(streamed.lines, input.lines, input.size * sizeof(sxbp_line_t))
+         != 0)
+    ) {
+        result = false;
+    }
+    // one with more lines than 32 bits can count only fits in wide builds
+    wide.bytes[33] = 0x01;
+    sxbp_spiral_t too_big = sxbp_blank_spiral();
+    serialise_result = sxbp_load_spiral(wide, &too_big);
+    if(
+        (serialise_result.status != (
+            SXBP_WIDE_MODE ? SXBP_OPERATION_FAIL : SXBP_SIZE_OVERFLOW
+        )) || (too_big.lines != NULL)
+    ) {
+        result = false;
+    }
+    // and any other flag is from a newer version of the format
+    wide.bytes[33] = 0x00;
+    wide.bytes[29] = 0x03;
+    serialise_result = sxbp_load_spiral(wide, &too_big);
+    if(
+        (serialise_result.status != SXBP_OPERATION_FAIL) ||
+        (serialise_result.diagnostic != SXBP_DESERIALISE_BAD_VERSION)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(input.lines);
+    free(output.lines);
+    free(streamed.lines);
+    free(extended.bytes);
+    free(wide.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_size_overflow(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral whose lines are as long as they can be
+    sxbp_spiral_t spiral = { .size = 4, };
+    spiral.lines = calloc(sizeof(sxbp_line_t), 4);
+    sxbp_direction_t directions[4] = {
+        SXBP_UP, SXBP_LEFT, SXBP_DOWN, SXBP_RIGHT,
+    };
+    for(uint8_t i = 0; i < 4; i++) {
+        spiral.lines[i].direction = directions[i];
+        spiral.lines[i].length = SXBP_LENGTH_MAX;
+    }
+    spiral.solved_count = 4;
+    // its co-ords can't be plotted from right at the edge of the co-ord space
+    sxbp_co_ord_array_t points = { .items = NULL, .size = 0, };
+    sxbp_co_ord_t edge = { SXBP_TUPLE_ITEM_MAX, 0, };
+    if(
+        (sxbp_spiral_points(spiral, &points, edge, 0, 4) !=
+         SXBP_SIZE_OVERFLOW) || (points.items != NULL)
+    ) {
+        result = false;
+    }
+    // it's far too big to render as a bitmap
+    sxbp_render_options_t render_options = { .scale = 5, };
+    sxbp_bitmap_t image = { .width = 0, .height = 0, .pixels = NULL, };
+    if(
+        (sxbp_render_spiral_raw_with_options(spiral, render_options, &image) !=
+         SXBP_SIZE_OVERFLOW) || (image.pixels != NULL)
+    ) {
+        result = false;
+    }
+    // and its co-ords are too far out to be stored in a chunk index
+    sxbp_dump_options_t options = { .chunk_size = 2, };
+    sxbp_buffer_t buffer = { .size = 0, .bytes = NULL, };
+    if(
+        (sxbp_dump_spiral_with_options(spiral, options, &buffer).status !=
+         SXBP_SIZE_OVERFLOW) || (buffer.bytes != NULL)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(spiral.lines);
+
+    return result;
+}
+
+static bool test_sxbp_load_spiral_in_parallel(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral big enough to be split into many chunks, and cache it
+    uint8_t data[100];
+    for(size_t i = 0; i < 100; i++) {
+        data[i] = (uint8_t)(i * 13);
+    }
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 100, };
+    sxbp_spiral_t input = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &input);
+    for(size_t i = 0; i < input.size; i++) {
+        input.lines[i].length = (i % 3) + 1;
+    }
+    sxbp_cache_spiral_points(&input, input.size);
+
+    // dump it with a chunk index, then load it back on several threads
+    sxbp_dump_options_t options = { .chunk_size = 64, };
+    sxbp_buffer_t buffer = { .size = 0, .bytes = NULL, };
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    sxbp_serialise_result_t serialise_result = sxbp_dump_spiral_with_options(
+        input, options, &buffer
+    );
+    if(serialise_result.status == SXBP_OPERATION_OK) {
+        serialise_result = sxbp_load_spiral_in_parallel(buffer, 4, &output);
+    }
+    // the loaded spiral and all its co-ords should match the original's
+    if(
+        (serialise_result.status != SXBP_OPERATION_OK) ||
+        (output.size != input.size) ||
+        (output.co_ord_cache.validity != input.size) ||
+        (output.co_ord_cache.co_ords.size != input.co_ord_cache.co_ords.size)
+    ) {
+        result = false;
+    } else {
+        for(size_t i = 0; i < input.size; i++) {
+            if(
+                (output.lines[i].direction != input.lines[i].direction) ||
+                (output.lines[i].length != input.lines[i].length)
+            ) {
+                result = false;
+            }
+        }
+        for(size_t i = 0; i < input.co_ord_cache.co_ords.size; i++) {
+            if(
+                (output.co_ord_cache.co_ords.items[i].x !=
+                 input.co_ord_cache.co_ords.items[i].x) ||
+                (output.co_ord_cache.co_ords.items[i].y !=
+                 input.co_ord_cache.co_ords.items[i].y)
+            ) {
+                result = false;
+            }
+        }
+    }
+
+    // any single line can be loaded with the co-ord it starts at
+    uint32_t line_index = 700;
+    sxbp_line_t line = { 0, 0, };
+    sxbp_co_ord_t start = { 0, 0, };
+    serialise_result = sxbp_load_spiral_line(buffer, line_index, &line, &start);
+    size_t co_ord_index = sxbp_sum_lines(input, 0, line_index);
+    if(
+        (serialise_result.status != SXBP_OPERATION_OK) ||
+        (line.direction != input.lines[line_index].direction) ||
+        (line.length != input.lines[line_index].length) ||
+        (start.x != input.co_ord_cache.co_ords.items[co_ord_index].x) ||
+        (start.y != input.co_ord_cache.co_ords.items[co_ord_index].y)
+    ) {
+        result = false;
+    }
+
+    /*
+     * running out of memory at any point should be reported as such, not as a
+     * corrupt file, and everything allocated up to then should be freed
+     */
+    free(output.lines);
+    free(output.co_ord_cache.co_ords.items);
+    serialise_result.status = SXBP_MALLOC_REFUSED;
+    for(
+        size_t limit = 1;
+        (serialise_result.status == SXBP_MALLOC_REFUSED) && (limit < 64);
+        limit++
+    ) {
+        test_allocator_t counts = { 0, 0, 0, limit, };
+        sxbp_allocator_t allocator = {
+            test_allocate, test_reallocate, test_deallocate, (void*)&counts,
+        };
+        sxbp_set_thread_allocator(&allocator);
+        output = sxbp_blank_spiral();
+        serialise_result = sxbp_load_spiral_in_parallel(buffer, 4, &output);
+        sxbp_free(output.lines);
+        sxbp_free(output.co_ord_cache.co_ords.items);
+        sxbp_set_thread_allocator(NULL);
+        if(
+            (
+                (serialise_result.status != SXBP_OPERATION_OK) &&
+                (serialise_result.status != SXBP_MALLOC_REFUSED)
+            ) || (counts.allocations != counts.frees)
+        ) {
+            result = false;
+        }
+    }
+    if(serialise_result.status != SXBP_OPERATION_OK) {
+        result = false;
+    }
+
+    // corrupting a line should be caught by the checksum of its chunk
+    buffer.bytes[SXBP_EXTENDED_FILE_HEADER_SIZE + 3] ^= 0x01;
+    output = sxbp_blank_spiral();
+    serialise_result = sxbp_load_spiral_in_parallel(buffer, 4, &output);
+    if(
+        (serialise_result.status != SXBP_OPERATION_FAIL) ||
+        (serialise_result.diagnostic != SXBP_DESERIALISE_BAD_CHECKSUM) ||
+        (output.lines != NULL)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(input.lines);
+    free(input.co_ord_cache.co_ords.items);
+    free(output.lines);
+    free(output.co_ord_cache.co_ords.items);
+    free(buffer.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_load_spiral_rejects_out_of_range_chunk(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral of a few chunks, the second of which starts going right
+    uint8_t data[32];
+    for(size_t i = 0; i < 32; i++) {
+        data[i] = (uint8_t)(i * 13);
+    }
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 32, };
+    sxbp_spiral_t input = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &input);
+    for(size_t i = 0; i < input.size; i++) {
+        input.lines[i].length = (i % 3) + 1;
+    }
+    input.lines[64].direction = SXBP_RIGHT;
+    sxbp_dump_options_t options = { .chunk_size = 64, };
+    sxbp_buffer_t buffer = { .size = 0, .bytes = NULL, };
+    sxbp_dump_spiral_with_options(input, options, &buffer);
+    /*
+     * move the start of the second chunk as far right as it can go, so that
+     * its lines would go past the largest co-ord, and fix up the checksum of
+     * the chunk index (which is the last section of the file) to match
+     */
+    size_t chunk_count = 5;
+    size_t payload_size = 8 + (28 * chunk_count) + 4;
+    size_t payload_index = buffer.size - payload_size;
+    uint8_t* start_x = buffer.bytes + payload_index + 8 + 28 + 8;
+    start_x[0] = 0x7f;
+    start_x[1] = start_x[2] = start_x[3] = 0xff;
+    uint32_t crc = sxbp_crc32(
+        0, buffer.bytes + payload_index, payload_size - 4
+    );
+    for(size_t i = 0; i < 4; i++) {
+        buffer.bytes[buffer.size - 4 + i] = (uint8_t)(crc >> (24 - (8 * i)));
+    }
+
+    // the chunk no longer starts where the one before it ends
+    sxbp_spiral_t output = sxbp_blank_spiral();
+    sxbp_serialise_result_t serialise_result = sxbp_load_spiral_in_parallel(
+        buffer, 4, &output
+    );
+    if(
+        (serialise_result.status != SXBP_OPERATION_FAIL) ||
+        (serialise_result.diagnostic != SXBP_DESERIALISE_BAD_CHUNK_INDEX) ||
+        (output.lines != NULL)
+    ) {
+        result = false;
+    }
+    // and the lines after its first can only be reached in wide mode
+    sxbp_line_t line = { 0, 0, };
+    sxbp_co_ord_t start = { 0, 0, };
+    serialise_result = sxbp_load_spiral_line(buffer, 127, &line, &start);
+    if(SXBP_WIDE_MODE) {
+        if(serialise_result.status != SXBP_OPERATION_OK) {
+            result = false;
+        }
+    } else if(
+        (serialise_result.status != SXBP_OPERATION_FAIL) ||
+        (serialise_result.diagnostic != SXBP_DESERIALISE_BAD_CHUNK_INDEX)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(input.lines);
+    free(output.lines);
+    free(output.co_ord_cache.co_ords.items);
+    free(buffer.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_verify_spiral(void) {
+    // success / failure variable
+    bool result = true;
+    // build and solve a spiral, which should then pass verification
+    uint8_t data[4] = { 0x5a, 0x31, 0xc7, 0x0f, };
+    sxbp_buffer_t buffer = { .bytes = data, .size = 4, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(buffer, &spiral);
+    sxbp_plot_spiral(&spiral, 1, spiral.size, NULL, NULL);
+    sxbp_verify_result_t verify_result = sxbp_verify_spiral(spiral, 2);
+    if(verify_result.status != SXBP_OPERATION_OK) {
+        result = false;
+    }
+    // a spiral which closes in on itself should collide
+    sxbp_spiral_t square = { .size = 4, .solved_count = 4, };
+    square.lines = calloc(sizeof(sxbp_line_t), 4);
+    sxbp_direction_t directions[4] = {
+        SXBP_UP, SXBP_RIGHT, SXBP_DOWN, SXBP_LEFT,
+    };
+    for(uint8_t i = 0; i < 4; i++) {
+        square.lines[i].direction = directions[i];
+        square.lines[i].length = 1;
+    }
+    verify_result = sxbp_verify_spiral(square, 2);
+    if(
+        (verify_result.status != SXBP_OPERATION_FAIL) ||
+        (verify_result.diagnostic != SXBP_VERIFY_COLLIDES)
+    ) {
+        result = false;
+    }
+    free(square.lines);
+    // a line going straight on instead of turning should be caught
+    spiral.lines[10].direction = spiral.lines[9].direction;
+    verify_result = sxbp_verify_spiral(spiral, 1);
+    if(
+        (verify_result.status != SXBP_OPERATION_FAIL) ||
+        (verify_result.diagnostic != SXBP_VERIFY_BAD_DIRECTION) ||
+        (verify_result.line != 10)
+    ) {
+        result = false;
+    }
+    // as should an unsolved line within the solved count
+    free(spiral.lines);
+    free(spiral.co_ord_cache.co_ords.items);
+    spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(buffer, &spiral);
+    sxbp_plot_spiral(&spiral, 1, spiral.size, NULL, NULL);
+    spiral.lines[5].length = 0;
+    verify_result = sxbp_verify_spiral(spiral, 1);
+    if(
+        (verify_result.status != SXBP_OPERATION_FAIL) ||
+        (verify_result.diagnostic != SXBP_VERIFY_BAD_LENGTH) ||
+        (verify_result.line != 5)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(spiral.lines);
+    free(spiral.co_ord_cache.co_ords.items);
+
+    return result;
+}
+
+static bool test_sxbp_decode_spiral(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral from every possible byte, it should decode to the same
+    uint8_t data[256];
+    for(size_t i = 0; i < 256; i++) {
+        data[i] = (uint8_t)i;
+    }
+    sxbp_buffer_t input = { .bytes = data, .size = 256, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(input, &spiral);
+    sxbp_buffer_t output = { .bytes = NULL, .size = 0, };
+    if(
+        (sxbp_decode_spiral(spiral, &output) != SXBP_OPERATION_OK) ||
+        (output.size != input.size) ||
+        (memcmp(output.bytes, input.bytes, input.size) != 0)
+    ) {
+        result = false;
+    }
+    free(output.bytes);
+    output.bytes = NULL;
+    // a line which doesn't turn can't have come from any data
+    spiral.lines[100].direction = spiral.lines[99].direction;
+    if(
+        (sxbp_decode_spiral(spiral, &output) != SXBP_OPERATION_FAIL) ||
+        (output.bytes != NULL)
+    ) {
+        result = false;
+    }
+
+    // free memory
+    free(spiral.lines);
+    free(output.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_render_spiral_raw(void) {
+    // success / failure variable
+    bool result = true;
+    // build a tiny spiral of two lines, up then right
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    spiral.size = 2;
+    spiral.lines = calloc(sizeof(sxbp_line_t), 2);
+    spiral.lines[0].direction = SXBP_UP;
+    spiral.lines[0].length = 1;
+    spiral.lines[1].direction = SXBP_RIGHT;
+    spiral.lines[1].length = 1;
+    // the rows we expect, top first (with a gap after the start point)
+    uint8_t expected[5] = { 0x00, 0x70, 0x00, 0x40, 0x00, };
+
+    sxbp_bitmap_t image = { 0, 0, 0, NULL, };
+    if(sxbp_render_spiral_raw(spiral, &image) != SXBP_OPERATION_OK) {
+        result = false;
+    } else if(
+        (image.width != 5) || (image.height != 5) || (image.stride != 1) ||
+        (memcmp(image.pixels, expected, 5) != 0) ||
+        !sxbp_get_bitmap_pixel(image, 3, 1) ||
+        sxbp_get_bitmap_pixel(image, 1, 2)
+    ) {
+        result = false;
+    } else {
+        // the PBM image should contain exactly the same rows
+        sxbp_buffer_t buffer = { .bytes = NULL, .size = 0, };
+        if(
+            (sxbp_render_backend_pbm(image, &buffer) != SXBP_OPERATION_OK) ||
+            (buffer.size != 12) ||
+            (memcmp(buffer.bytes, "P4\n5\n5\n", 7) != 0) ||
+            (memcmp(buffer.bytes + 7, expected, 5) != 0)
+        ) {
+            result = false;
+        }
+        free(buffer.bytes);
+    }
+
+    // free memory
+    free(spiral.lines);
+    free(spiral.co_ord_cache.co_ords.items);
+    free(image.pixels);
+
+    return result;
+}
+
+static bool test_sxbp_render_spiral_to_pbm_stream(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral with lines of various lengths
+    uint8_t data[16];
+    for(size_t i = 0; i < 16; i++) {
+        data[i] = (uint8_t)(i * 37);
+    }
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 16, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &spiral);
+    for(size_t i = 0; i < spiral.size; i++) {
+        spiral.lines[i].length = (i % 4) + 1;
+    }
+    // render it in bands of a few rows, and all at once
+    sxbp_render_options_t options = { .scale = 0, .thickness = 0, };
+    test_stream_t stream = { { NULL, 0, }, 0, };
+    sxbp_buffer_t expected = { .bytes = NULL, .size = 0, };
+    if(
+        (sxbp_render_spiral_to_pbm_stream(
+            spiral, options, 3, test_write_callback, (void*)&stream
+        ) != SXBP_OPERATION_OK) ||
+        (sxbp_render_spiral_image(
+            spiral, &expected, sxbp_render_backend_pbm
+        ) != SXBP_OPERATION_OK)
+    ) {
+        result = false;
+    } else if(
+        (stream.buffer.size != expected.size) ||
+        (memcmp(stream.buffer.bytes, expected.bytes, expected.size) != 0)
+    ) {
+        // both ways should give exactly the same image
+        result = false;
+    }
+
+    // free memory
+    free(spiral.lines);
+    free(stream.buffer.bytes);
+    free(expected.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_render_spiral_raw_with_options(void) {
+    // success / failure variable
+    bool result = true;
+    // build spiral of 2 lines: up 1, right 1
+    sxbp_line_t lines[2] = {
+        { .direction = SXBP_UP, .length = 1, },
+        { .direction = SXBP_RIGHT, .length = 1, },
+    };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    spiral.size = 2;
+    spiral.lines = lines;
+    // 4 pixels between co-ords, lines and border 2 pixels wide
+    sxbp_render_options_t options = { .scale = 4, .thickness = 2, };
+    sxbp_bitmap_t image = { .width = 0, .height = 0, .pixels = NULL, };
+    uint8_t expected_rows[10][2] = {
+        { 0x00, 0x00, }, { 0x00, 0x00, },
+        { 0x3f, 0x00, }, { 0x3f, 0x00, },
+        { 0x00, 0x00, }, { 0x00, 0x00, },
+        { 0x30, 0x00, }, { 0x30, 0x00, },
+        { 0x00, 0x00, }, { 0x00, 0x00, },
+    };
+    if(
+        sxbp_render_spiral_raw_with_options(
+            spiral, options, &image
+        ) != SXBP_OPERATION_OK
+    ) {
+        result = false;
+    } else if(
+        (image.width != 10) || (image.height != 10) || (image.stride != 2)
+    ) {
+        result = false;
+    } else if(memcmp(image.pixels, expected_rows, sizeof(expected_rows)) != 0) {
+        result = false;
+    }
+    free(image.pixels);
+
+    return result;
+}
+
+static bool test_sxbp_render_spiral_raw_in_parallel(void) {
+    // success / failure variable
+    bool result = true;
+    // build a spiral with lines of various lengths
+    uint8_t data[16];
+    for(size_t i = 0; i < 16; i++) {
+        data[i] = (uint8_t)(i * 53);
+    }
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 16, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &spiral);
+    for(size_t i = 0; i < spiral.size; i++) {
+        spiral.lines[i].length = (i % 5) + 1;
+    }
+    // render it on several threads and on one
+    sxbp_render_options_t options = { .scale = 3, .thickness = 2, };
+    sxbp_bitmap_t image = { .width = 0, .height = 0, .pixels = NULL, };
+    sxbp_bitmap_t expected = { .width = 0, .height = 0, .pixels = NULL, };
+    if(
+        (sxbp_render_spiral_raw_in_parallel(
+            spiral, options, 4, &image
+        ) != SXBP_OPERATION_OK) ||
+        (sxbp_render_spiral_raw_with_options(
+            spiral, options, &expected
+        ) != SXBP_OPERATION_OK)
+    ) {
+        result = false;
+    } else if(
+        (image.width != expected.width) || (image.height != expected.height) ||
+        (image.stride != expected.stride) ||
+        (memcmp(
+            image.pixels, expected.pixels, expected.stride * expected.height
+        ) != 0)
+    ) {
+        // both ways should give exactly the same image
+        result = false;
+    }
+    free(image.pixels);
+    free(expected.pixels);
+    free(spiral.lines);
+
+    return result;
+}
+
+// disable GCC warning about unused parameters, as this callback only counts
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+// progress callback for test_sxbp_plot_spiral_live(), counts dirty updates
+static void test_count_live_updates(
+    sxbp_spiral_t* spiral, const sxbp_live_render_t* live,
+    sxbp_line_count_t latest_line, sxbp_line_count_t target_line,
+    void* user_data
+) {
+    if((live->dirty.width > 0) && (live->dirty.height > 0)) {
+        (*(size_t*)user_data)++;
+    }
+}
+// re-enable all warnings
+#pragma GCC diagnostic pop
+
+/*
+ * returns whether the spiral on the canvas of the live render is the same as
+ * the given bitmap of it, with the rest of the canvas white
+ */
+static bool test_live_render_matches(
+    const sxbp_live_render_t* live, sxbp_bitmap_t expected
+) {
+    if(
+        (live->content.width != expected.width) ||
+        (live->content.height != expected.height)
+    ) {
+        return false;
+    }
+    for(uint32_t y = 0; y < live->image.height; y++) {
+        for(uint32_t x = 0; x < live->image.width; x++) {
+            bool pixel = false;
+            if(
+                (x >= live->content.x) && (y >= live->content.y) &&
+                (x - live->content.x < expected.width) &&
+                (y - live->content.y < expected.height)
+            ) {
+                pixel = sxbp_get_bitmap_pixel(
+                    expected, x - live->content.x, y - live->content.y
+                );
+            }
+            if(sxbp_get_bitmap_pixel(live->image, x, y) != pixel) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool test_sxbp_plot_spiral_live(void) {
+    // success / failure variable
+    bool result = true;
+    // plot a spiral, keeping a live render of it
+    uint8_t data[4] = { 0x6d, 0x33, 0xc2, 0x0f, };
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 4, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &spiral);
+    sxbp_render_options_t options = { .scale = 3, .thickness = 2, };
+    sxbp_live_render_t live = sxbp_blank_live_render(options);
+    size_t updates = 0;
+    sxbp_bitmap_t expected = { .width = 0, .height = 0, .pixels = NULL, };
+    if(
+        (sxbp_plot_spiral_live(
+            &spiral, 1, spiral.size, &live, test_count_live_updates, &updates
+        ) != SXBP_OPERATION_OK) ||
+        (sxbp_render_spiral_raw_with_options(
+            spiral, options, &expected
+        ) != SXBP_OPERATION_OK)
+    ) {
+        result = false;
+    } else if(
+        (updates != spiral.size) ||
+        (live.content.width != expected.width) ||
+        (live.content.height != expected.height)
+    ) {
+        // every line should have changed the image
+        result = false;
+    } else if(!test_live_render_matches(&live, expected)) {
+        // the spiral on the canvas should be the same as when rendered alone
+        result = false;
+    }
+    // updating it again with nothing changed should leave nothing dirty
+    if(
+        (sxbp_update_live_render(&spiral, &live) != SXBP_OPERATION_OK) ||
+        (live.dirty.width != 0) || live.resized
+    ) {
+        result = false;
+    }
+    sxbp_free_live_render(&live);
+    free(expected.pixels);
+    free(spiral.lines);
+    free(spiral.co_ord_cache.co_ords.items);
+
+    return result;
+}
+
+/*
+ * private type for the frame callback used by
+ * test_sxbp_plot_spiral_animation(), which checks each frame against a full
+ * render of the lines in it
+ */
+typedef struct test_animation_t {
+    const sxbp_spiral_t* spiral;
+    sxbp_render_options_t options;
+    uint32_t frame_count;
+    bool frames_match;
+} test_animation_t;
+
+// frame callback for test_sxbp_plot_spiral_animation()
+static sxbp_status_t test_check_animation_frame(
+    const sxbp_animation_frame_t* frame, void* user_data
+) {
+    test_animation_t* test = (test_animation_t*)user_data;
+    sxbp_spiral_t drawn = *test->spiral;
+    drawn.size = frame->line_count;
+    sxbp_bitmap_t expected = { .width = 0, .height = 0, .pixels = NULL, };
+    sxbp_status_t result = sxbp_render_spiral_raw_with_options(
+        drawn, test->options, &expected
+    );
+    if(
+        (result != SXBP_OPERATION_OK) ||
+        (frame->number != test->frame_count) ||
+        (frame->image.width != expected.width) ||
+        (frame->image.height != expected.height) ||
+        (frame->image.stride != expected.stride) ||
+        (
+            memcmp(
+                frame->image.pixels, expected.pixels,
+                expected.stride * expected.height
+            ) != 0
+        )
+    ) {
+        test->frames_match = false;
+    }
+    test->frame_count++;
+    free(expected.pixels);
+    return result;
+}
+
+static bool test_sxbp_plot_spiral_animation(void) {
+    // success / failure variable
+    bool result = true;
+    // plot a spiral, making a frame every 3 lines
+    uint8_t data[4] = { 0x6d, 0x33, 0xc2, 0x0f, };
+    sxbp_buffer_t data_buffer = { .bytes = data, .size = 4, };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    sxbp_init_spiral(data_buffer, &spiral);
+    sxbp_animation_options_t options = {
+        .render = { .scale = 3, .thickness = 2, }, .lines_per_frame = 3,
+    };
+    test_animation_t test = { &spiral, options.render, 0, true, };
+    if(
+        sxbp_plot_spiral_animation(
+            &spiral, 1, spiral.size, options, test_check_animation_frame,
+            &test
+        ) != SXBP_OPERATION_OK
+    ) {
+        result = false;
+    } else if(
+        !test.frames_match || (test.frame_count != (spiral.size + 2) / 3)
+    ) {
+        // every frame should be the same as when the spiral is rendered
+        result = false;
+    }
+    free(spiral.lines);
+    free(spiral.co_ord_cache.co_ords.items);
+
+    return result;
+}
+
+static bool test_sxbp_update_live_render_changed_lines(void) {
+    // success / failure variable
+    bool result = true;
+    // build spiral of 8 lines winding outwards
+    sxbp_line_t lines[8] = {
+        { .direction = SXBP_UP, .length = 1, },
+        { .direction = SXBP_RIGHT, .length = 1, },
+        { .direction = SXBP_DOWN, .length = 2, },
+        { .direction = SXBP_LEFT, .length = 2, },
+        { .direction = SXBP_UP, .length = 3, },
+        { .direction = SXBP_RIGHT, .length = 3, },
+        { .direction = SXBP_DOWN, .length = 4, },
+        { .direction = SXBP_LEFT, .length = 4, },
+    };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    spiral.size = 8;
+    spiral.solved_count = 8;
+    spiral.lines = lines;
+    sxbp_render_options_t options = { .scale = 2, .thickness = 1, };
+    sxbp_live_render_t live = sxbp_blank_live_render(options);
+    sxbp_bitmap_t expected = { .width = 0, .height = 0, .pixels = NULL, };
+    if(sxbp_update_live_render(&spiral, &live) != SXBP_OPERATION_OK) {
+        result = false;
+    }
+    // go back to line 6 and make line 5 shorter, as a solve does
+    lines[5].length = 2;
+    spiral.solved_count = 6;
+    // the rest should be drawn as if they were all the lines there are
+    sxbp_spiral_t shortened = sxbp_blank_spiral();
+    shortened.size = 6;
+    shortened.lines = lines;
+    if(
+        !result ||
+        (sxbp_update_live_render(&spiral, &live) != SXBP_OPERATION_OK) ||
+        (sxbp_render_spiral_raw_with_options(
+            shortened, options, &expected
+        ) != SXBP_OPERATION_OK)
+    ) {
+        result = false;
+    } else if(
+        live.resized || (live.dirty.width == 0) ||
+        !test_live_render_matches(&live, expected)
+    ) {
+        // only the changed lines should have been redrawn
+        result = false;
+    }
+    sxbp_free_live_render(&live);
+    free(expected.pixels);
+
+    return result;
+}
+
+static bool test_sxbp_render_spiral_thumbnail(void) {
+    // success / failure variable
+    bool result = true;
+    // build spiral of 2 lines: up 1, right 1 (5x5 pixels at full size)
+    sxbp_line_t lines[2] = {
+        { .direction = SXBP_UP, .length = 1, },
+        { .direction = SXBP_RIGHT, .length = 1, },
+    };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    spiral.size = 2;
+    spiral.lines = lines;
+    sxbp_render_options_t options = { .scale = 0, .thickness = 0, };
+    sxbp_greyscale_image_t image = { .width = 0, .height = 0, .pixels = NULL, };
+    // each pixel covers 2x2 full size pixels, shaded by how many are black
+    uint8_t expected[9] = {
+        191, 127, 255,
+        191, 255, 255,
+        255, 255, 255,
+    };
+    if(
+        sxbp_render_spiral_thumbnail(
+            spiral, options, 3, 3, &image
+        ) != SXBP_OPERATION_OK
+    ) {
+        result = false;
+    } else if(
+        (image.width != 3) || (image.height != 3) ||
+        (memcmp(image.pixels, expected, sizeof(expected)) != 0)
+    ) {
+        result = false;
+    }
+    free(image.pixels);
+
+    return result;
+}
+
+static bool test_sxbp_render_spiral_thumbnail_thick_lines(void) {
+    // success / failure variable
+    bool result = true;
+    // build spiral of 4 lines: up 1, right 2, down 2, left 1
+    sxbp_line_t lines[4] = {
+        { .direction = SXBP_UP, .length = 1, },
+        { .direction = SXBP_RIGHT, .length = 2, },
+        { .direction = SXBP_DOWN, .length = 2, },
+        { .direction = SXBP_LEFT, .length = 1, },
+    };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    spiral.size = 4;
+    spiral.lines = lines;
+    // lines thicker than they are spaced apart overlap their neighbours
+    sxbp_render_options_t options = { .scale = 1, .thickness = 3, };
+    sxbp_bitmap_t full_size = { .width = 0, .height = 0, .pixels = NULL, };
+    sxbp_greyscale_image_t image = { .width = 0, .height = 0, .pixels = NULL, };
+    if(
+        (sxbp_render_spiral_raw_with_options(spiral, options, &full_size) !=
+        SXBP_OPERATION_OK) ||
+        (sxbp_render_spiral_thumbnail(spiral, options, 3, 3, &image) !=
+        SXBP_OPERATION_OK)
+    ) {
+        result = false;
+    } else {
+        uint32_t factor = (full_size.width + 2) / 3;
+        if((full_size.height + 2) / 3 > factor) {
+            factor = (full_size.height + 2) / 3;
+        }
+        uint32_t area = factor * factor;
+        // each pixel should be shaded by how many of its pixels are black
+        for(uint32_t y = 0; y < image.height; y++) {
+            for(uint32_t x = 0; x < image.width; x++) {
+                uint32_t black = 0;
+                for(uint32_t v = y * factor; v < (y + 1) * factor; v++) {
+                    for(uint32_t u = x * factor; u < (x + 1) * factor; u++) {
+                        if(
+                            (u < full_size.width) && (v < full_size.height) &&
+                            sxbp_get_bitmap_pixel(full_size, u, v)
+                        ) {
+                            black++;
+                        }
+                    }
+                }
+                uint8_t expected = (uint8_t)(
+                    255 - ((black * 255 + area / 2) / area)
+                );
+                if(image.pixels[y * image.width + x] != expected) {
+                    result = false;
+                }
+            }
+        }
+    }
+    free(full_size.pixels);
+    free(image.pixels);
+
+    return result;
+}
+
+// disable GCC warning about the unused parameters of this test callback
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+// test tile sink which just counts the tiles it is given
+static sxbp_status_t test_count_tiles(
+    uint32_t level, uint32_t column, uint32_t row, sxbp_buffer_t tile,
+    void* user_data
+) {
+    (*(size_t*)user_data)++;
+    return SXBP_OPERATION_OK;
+}
+// re-enable all warnings
+#pragma GCC diagnostic pop
+
+static bool test_sxbp_render_tile(void) {
+    // success / failure variable
+    bool result = true;
+    // build spiral of 2 lines: up 1, right 1 (5x5 pixels at full size)
+    sxbp_line_t lines[2] = {
+        { .direction = SXBP_UP, .length = 1, },
+        { .direction = SXBP_RIGHT, .length = 1, },
+    };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    spiral.size = 2;
+    spiral.lines = lines;
+    sxbp_render_options_t options = { .scale = 0, .thickness = 0, };
+    sxbp_tile_index_t index = { .bands = NULL, };
+    // top-left tile at full size and the only tile at half size
+    sxbp_buffer_t full_size = { .bytes = NULL, .size = 0, };
+    sxbp_buffer_t half_size = { .bytes = NULL, .size = 0, };
+    uint8_t expected_full_size[] = "P4\n4\n4\n\x00\x70\x00\x40";
+    uint8_t expected_half_size[] = "P4\n3\n3\n\xc0\x80\x00";
+    size_t tile_count = 0;
+    uint32_t columns = 0;
+    uint32_t rows = 0;
+    if(
+        sxbp_build_tile_index(spiral, options, 4, &index) != SXBP_OPERATION_OK
+    ) {
+        result = false;
+    } else {
+        sxbp_get_tile_grid(&index, 0, &columns, &rows);
+        if(
+            (index.levels != 2) || (columns != 2) || (rows != 2) ||
+            (sxbp_render_tile(
+                &index, 0, 0, 0, &full_size, sxbp_render_backend_pbm
+            ) != SXBP_OPERATION_OK) ||
+            (sxbp_render_tile(
+                &index, 1, 0, 0, &half_size, sxbp_render_backend_pbm
+            ) != SXBP_OPERATION_OK) ||
+            (sxbp_render_tile_pyramid(
+                &index, sxbp_render_backend_pbm, test_count_tiles,
+                (void*)&tile_count
+            ) != SXBP_OPERATION_OK)
+        ) {
+            result = false;
+        } else if(
+            (full_size.size != sizeof(expected_full_size) - 1) ||
+            (memcmp(
+                full_size.bytes, expected_full_size, full_size.size
+            ) != 0) ||
+            (half_size.size != sizeof(expected_half_size) - 1) ||
+            (memcmp(
+                half_size.bytes, expected_half_size, half_size.size
+            ) != 0) ||
+            (tile_count != 5)
+        ) {
+            result = false;
+        }
+    }
+    free(full_size.bytes);
+    free(half_size.bytes);
+    sxbp_free_tile_index(&index);
+
+    return result;
+}
+
+static bool test_sxbp_render_spiral_to_svg(void) {
+    // success / failure variable
+    bool result = true;
+    // build spiral of 2 lines: up 1, right 1 (5x5 pixels at full size)
+    sxbp_line_t lines[2] = {
+        { .direction = SXBP_UP, .length = 1, },
+        { .direction = SXBP_RIGHT, .length = 1, },
+    };
+    sxbp_spiral_t spiral = sxbp_blank_spiral();
+    spiral.size = 2;
+    spiral.lines = lines;
+    sxbp_render_options_t options = { .scale = 0, .thickness = 0, };
+    sxbp_buffer_t buffer = { .bytes = NULL, .size = 0, };
+    const char* expected = (
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" "
+        "width=\"5\" height=\"5\" viewBox=\"0 0 5 5\">\n"
+        "<rect width=\"5\" height=\"5\" fill=\"white\"/>\n"
+        "<path fill=\"none\" stroke=\"black\" stroke-width=\"1\" "
+        "stroke-linecap=\"square\" d=\"M1.5 3.5v-2h2\"/>\n"
+        "</svg>\n"
+    );
+    if(
+        (sxbp_render_spiral_to_svg(
+            spiral, options, &buffer
+        ) != SXBP_OPERATION_OK) ||
+        (buffer.size != strlen(expected)) ||
+        (memcmp(buffer.bytes, expected, buffer.size) != 0)
+    ) {
+        result = false;
+    }
+    free(buffer.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_render_backend_png(void) {
+    // success / failure variable
+    bool result = true;
+    // a 10x2 bitmap with a few pixels set
+    uint8_t pixels[4] = { 0x80, 0x40, 0x01, 0x00, };
+    sxbp_bitmap_t bitmap = {
+        .width = 10, .height = 2, .stride = 2, .pixels = pixels,
+    };
+    // PNG signature, then the IHDR chunk: 10x2, 1-bit greyscale
+    uint8_t expected[] = {
+        0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n',
+        0x00, 0x00, 0x00, 0x0d, 'I', 'H', 'D', 'R',
+        0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x02, 0x01, 0x00,
+    };
+    // this works with or without libpng, but is only compressed with it
+    sxbp_png_options_t options = {
+        .compression_level = 9, .filter = SXBP_PNG_FILTER_ALL,
+    };
+    sxbp_buffer_t buffer = { .bytes = NULL, .size = 0, };
+    if(
+        (sxbp_render_backend_png_with_options(
+            bitmap, options, &buffer
+        ) != SXBP_OPERATION_OK) ||
+        (buffer.size < sizeof(expected)) ||
+        (memcmp(buffer.bytes, expected, sizeof(expected)) != 0) ||
+        // the image should end with an IEND chunk
+        (memcmp(buffer.bytes + buffer.size - 8, "IEND", 4) != 0)
+    ) {
+        result = false;
+    }
+    free(buffer.bytes);
+
+    return result;
+}
+
+static bool test_sxbp_render_backend_png_into(void) {
+    // success / failure variable
+    bool result = true;
+    // a bitmap of noise, which won't compress much
+    sxbp_bitmap_t bitmap = {
+        .width = 203, .height = 57, .stride = 26, .pixels = NULL,
+    };
+    bitmap.pixels = calloc(bitmap.stride * bitmap.height, sizeof(uint8_t));
+    if(bitmap.pixels == NULL) {
+        return false;
+    }
+    uint32_t state = 1;
+    for(size_t i = 0; i < bitmap.stride * bitmap.height; i++) {
+        state = (state * 1103515245) + 12345;
+        bitmap.pixels[i] = (uint8_t)(state >> 16);
+    }
+    // the PBM image size is exact, and should be written just as usual
+    sxbp_buffer_t expected = { .bytes = NULL, .size = 0, };
+    sxbp_render_backend_pbm(bitmap, &expected);
+    size_t size = sxbp_get_pbm_size(bitmap.width, bitmap.height);
+    uint8_t* bytes = malloc(size);
+    sxbp_buffer_t buffer = { .bytes = bytes, .size = size - 1, };
+    if(
+        (size != expected.size) ||
+        (sxbp_render_backend_pbm_into(bitmap, &buffer) !=
+         SXBP_OPERATION_FAIL)
+    ) {
+        result = false;
+    }
+    buffer.size = size;
+    if(
+        (sxbp_render_backend_pbm_into(bitmap, &buffer) != SXBP_OPERATION_OK) ||
+        (buffer.size != expected.size) ||
+        (memcmp(buffer.bytes, expected.bytes, expected.size) != 0)
+    ) {
+        result = false;
+    }
+    free(expected.bytes);
+    free(bytes);
+    // the PNG image should always fit in its maximum size, whatever the options
+    size = sxbp_get_png_max_size(bitmap.width, bitmap.height);
+    bytes = malloc(size);
+    for(uint8_t level = 1; level <= SXBP_PNG_COMPRESSION_NONE; level += 9) {
+        sxbp_png_options_t options = {
+            .compression_level = level, .filter = SXBP_PNG_FILTER_ALL,
+        };
+        expected.bytes = NULL;
+        sxbp_render_backend_png_with_options(bitmap, options, &expected);
+        buffer.bytes = bytes;
+        buffer.size = size;
+        if(
+            (sxbp_render_backend_png_into(bitmap, options, &buffer) !=
+             SXBP_OPERATION_OK) ||
+            (buffer.bytes != bytes) || (buffer.size != expected.size) ||
+            (memcmp(buffer.bytes, expected.bytes, expected.size) != 0)
+        ) {
+            result = false;
+        }
+        // but if it doesn't fit, it should fail and leave the buffer empty
+        buffer.size = expected.size - 1;
+        if(
+            (sxbp_render_backend_png_into(bitmap, options, &buffer) !=
+             SXBP_OPERATION_FAIL) ||
+            (buffer.bytes != bytes) || (buffer.size != 0)
+        ) {
+            result = false;
+        }
+        free(expected.bytes);
+    }
+    free(bytes);
+    free(bitmap.pixels);
+
+    return result;
+}
+
+static bool test_sxbp_render_backend_png_in_parallel(void) {
+    // success / failure variable
+    bool result = true;
+    // a bitmap tall enough to be split into several strips, striped diagonally
+    sxbp_bitmap_t bitmap = {
+        .width = 64, .height = 40000, .stride = 8, .pixels = NULL,
+    };
+    bitmap.pixels = calloc(bitmap.stride * bitmap.height, sizeof(uint8_t));
+    if(bitmap.pixels == NULL) {
+        return false;
+    }
+    for(uint32_t y = 0; y < bitmap.height; y++) {
+        bitmap.pixels[(y * bitmap.stride) + ((y / 8) % 8)] = 0x80 >> (y % 8);
+    }
+    // PNG signature, then the IHDR chunk: 64x40000, 1-bit greyscale
+    uint8_t expected[] = {
+        0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n',
+        0x00, 0x00, 0x00, 0x0d, 'I', 'H', 'D', 'R',
+        0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x9c, 0x40, 0x01, 0x00,
+    };
+    sxbp_png_options_t options = {
+        .compression_level = 0, .filter = SXBP_PNG_FILTER_DEFAULT,
+    };
+    // the image should be the same shape however many threads are used
+    for(size_t thread_count = 0; thread_count <= 4; thread_count += 2) {
+        sxbp_buffer_t buffer = { .bytes = NULL, .size = 0, };
+        if(
+            (sxbp_render_backend_png_in_parallel(
+                bitmap, options, thread_count, &buffer
+            ) != SXBP_OPERATION_OK) ||
+            (buffer.size < sizeof(expected)) ||
+            (memcmp(buffer.bytes, expected, sizeof(expected)) != 0) ||
+            // the image should end with an IEND chunk
+            (memcmp(buffer.bytes + buffer.size - 8, "IEND", 4) != 0)
+        ) {
+            result = false;
+        }
+        free(buffer.bytes);
+    }
+    free(bitmap.pixels);
+
+    return result;
+}
+
+// this function takes a bool containing the test suite status,
+// a function pointer to a test case function, and a string containing the
+// test case's name. it will run the test case function and return the success
+// or failure status, which should be stored in the test suite status bool.
+static bool run_test_case(
+    bool test_suite_state, bool(* test_case_func)(), char* test_case_name
+) {
+    printf("%s: ", test_case_name);
+    fflush(stdout);
+    bool test_result = (*test_case_func)();
+    printf("%s\n", (test_result ? "PASS" : "FAIL"));
+    return test_suite_state && test_result;
+}
+
+int main(void) {
+    // set up test suite status flag
+    bool result = true;
+    // call run_test_case() for each test case
+    result = run_test_case(
+        result, test_sxbp_set_thread_allocator,
+        "test_sxbp_set_thread_allocator"
+    );
+    result = run_test_case(
+        result, test_sxbp_change_direction, "test_sxbp_change_direction"
+    );
+    result = run_test_case(
+        result, test_sxbp_init_spiral, "test_sxbp_init_spiral"
+    );
+    result = run_test_case(
+        result, test_sxbp_init_spiral_in_parallel,
+        "test_sxbp_init_spiral_in_parallel"
+    );
+    result = run_test_case(
+        result, test_sxbp_init_spiral_from_stream,
+        "test_sxbp_init_spiral_from_stream"
+    );
+    result = run_test_case(
+        result, test_sxbp_spiral_append, "test_sxbp_spiral_append"
+    );
+    result = run_test_case(
+        result, test_sxbp_spiral_edit, "test_sxbp_spiral_edit"
+    );
+    result = run_test_case(
+        result, test_sxbp_spiral_points, "test_sxbp_spiral_points"
+    );
+    result = run_test_case(
+        result, test_sxbp_cache_spiral_points_blank,
+        "test_sxbp_cache_spiral_points_blank"
+    );
+    result = run_test_case(
+        result, test_sxbp_get_spiral_bounds, "test_sxbp_get_spiral_bounds"
+    );
+    result = run_test_case(
+        result, test_sxbp_plot_spiral, "test_sxbp_plot_spiral"
+    );
+    result = run_test_case(
+        result, test_sxbp_plot_spiral_partial, "test_sxbp_plot_spiral_partial"
+    );
+    result = run_test_case(
+        result, test_sxbp_plot_spiral_large_co_ords,
+        "test_sxbp_plot_spiral_large_co_ords"
     );
     result = run_test_case(
         result, test_sxbp_plot_spiral_progress_callback,
@@ -747,5 +2723,92 @@ int main(void) {
     result = run_test_case(
         result, test_sxbp_dump_spiral, "test_sxbp_dump_spiral"
     );
+    result = run_test_case(
+        result, test_sxbp_dump_and_load_spiral_with_co_ord_cache,
+        "test_sxbp_dump_and_load_spiral_with_co_ord_cache"
+    );
+    result = run_test_case(
+        result, test_sxbp_dump_and_load_spiral_stream,
+        "test_sxbp_dump_and_load_spiral_stream"
+    );
+    result = run_test_case(
+        result, test_sxbp_load_spiral_from_stream_rejects_bad_size,
+        "test_sxbp_load_spiral_from_stream_rejects_bad_size"
+    );
+    result = run_test_case(
+        result, test_sxbp_dump_spiral_into, "test_sxbp_dump_spiral_into"
+    );
+    result = run_test_case(
+        result, test_sxbp_load_spiral_wide_file,
+        "test_sxbp_load_spiral_wide_file"
+    );
+    result = run_test_case(
+        result, test_sxbp_size_overflow, "test_sxbp_size_overflow"
+    );
+    result = run_test_case(
+        result, test_sxbp_load_spiral_in_parallel,
+        "test_sxbp_load_spiral_in_parallel"
+    );
+    result = run_test_case(
+        result, test_sxbp_load_spiral_rejects_out_of_range_chunk,
+        "test_sxbp_load_spiral_rejects_out_of_range_chunk"
+    );
+    result = run_test_case(
+        result, test_sxbp_verify_spiral, "test_sxbp_verify_spiral"
+    );
+    result = run_test_case(
+        result, test_sxbp_decode_spiral, "test_sxbp_decode_spiral"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_spiral_raw, "test_sxbp_render_spiral_raw"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_spiral_to_pbm_stream,
+        "test_sxbp_render_spiral_to_pbm_stream"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_spiral_raw_with_options,
+        "test_sxbp_render_spiral_raw_with_options"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_spiral_raw_in_parallel,
+        "test_sxbp_render_spiral_raw_in_parallel"
+    );
+    result = run_test_case(
+        result, test_sxbp_plot_spiral_live, "test_sxbp_plot_spiral_live"
+    );
+    result = run_test_case(
+        result, test_sxbp_update_live_render_changed_lines,
+        "test_sxbp_update_live_render_changed_lines"
+    );
+    result = run_test_case(
+        result, test_sxbp_plot_spiral_animation,
+        "test_sxbp_plot_spiral_animation"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_spiral_thumbnail,
+        "test_sxbp_render_spiral_thumbnail"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_spiral_thumbnail_thick_lines,
+        "test_sxbp_render_spiral_thumbnail_thick_lines"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_tile, "test_sxbp_render_tile"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_spiral_to_svg, "test_sxbp_render_spiral_to_svg"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_backend_png, "test_sxbp_render_backend_png"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_backend_png_into,
+        "test_sxbp_render_backend_png_into"
+    );
+    result = run_test_case(
+        result, test_sxbp_render_backend_png_in_parallel,
+        "test_sxbp_render_backend_png_in_parallel"
+    );
     return result ? 0 : 1;
 }